@@ -0,0 +1,84 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/arena.h"
+
+#include "base/debug.h"
+
+#include <algorithm>
+
+namespace base {
+
+arena::arena(const size_t blockSize) : m_blockSize(blockSize)
+{
+  ASSERT(blockSize > 0);
+}
+
+arena::~arena()
+{
+  release();
+}
+
+void* arena::allocate(const size_t size, const size_t alignment)
+{
+  ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+  uintptr_t p = (uintptr_t(m_ptr) + alignment - 1) & ~uintptr_t(alignment - 1);
+  if (!m_ptr || p + size > uintptr_t(m_end)) {
+    new_block(size + alignment);
+    p = (uintptr_t(m_ptr) + alignment - 1) & ~uintptr_t(alignment - 1);
+  }
+
+  m_stats.used += (p + size) - uintptr_t(m_ptr);
+  m_ptr = (uint8_t*)(p + size);
+  ++m_stats.allocs;
+  return (void*)p;
+}
+
+void arena::reset()
+{
+  if (m_blocks.size() > 1) {
+    // Replace all blocks with just one block with the total size
+    const size_t size = m_stats.capacity;
+    release();
+    new_block(size);
+  }
+  else if (!m_blocks.empty()) {
+    m_ptr = m_blocks[0].data;
+  }
+  m_stats.used = 0;
+}
+
+void arena::release()
+{
+  for (block& b : m_blocks)
+    base_free(b.data);
+  m_blocks.clear();
+  m_ptr = m_end = nullptr;
+  m_stats.used = 0;
+  m_stats.capacity = 0;
+}
+
+void arena::new_block(const size_t minSize)
+{
+  block b;
+  b.size = std::max(m_blockSize, minSize);
+  b.data = (uint8_t*)base_malloc(b.size);
+  if (!b.data)
+    throw std::bad_alloc();
+
+  m_blocks.push_back(b);
+  m_ptr = b.data;
+  m_end = b.data + b.size;
+  m_stats.capacity += b.size;
+  ++m_stats.heap_allocs;
+}
+
+} // namespace base
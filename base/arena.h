@@ -0,0 +1,119 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_ARENA_H_INCLUDED
+#define BASE_ARENA_H_INCLUDED
+#pragma once
+
+#include "base/disable_copying.h"
+#include "base/ints.h"
+#include "base/memory.h"
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace base {
+
+// Bump pointer allocator: allocations are just a pointer increment
+// in the current memory block, there is no way to free one
+// allocation, and all the memory is released at once with reset()
+// (e.g. at the end of each frame). Destructors of objects allocated
+// in the arena are not called.
+//
+// Not thread-safe, use one arena per thread.
+class arena {
+public:
+  struct stats {
+    uint64_t allocs = 0;      // Number of allocate() calls
+    uint64_t heap_allocs = 0; // Number of blocks allocated from the heap
+    size_t used = 0;          // Bytes used since the last reset()
+    size_t capacity = 0;      // Bytes reserved in all blocks
+  };
+
+  static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+  explicit arena(const size_t blockSize = kDefaultBlockSize);
+  ~arena();
+
+  void* allocate(const size_t size, const size_t alignment = base_alignment);
+
+  // Allocates and constructs an object of type T.
+  template<typename T, typename... Args>
+  T* make(Args&&... args)
+  {
+    return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  // Releases all the allocations at once. The memory blocks are kept
+  // to be reused (only one block if several blocks were needed, with
+  // the total size of all them, so the next time we don't need
+  // several heap allocations).
+  void reset();
+
+  // Releases all the memory blocks.
+  void release();
+
+  const stats& get_stats() const { return m_stats; }
+
+private:
+  struct block {
+    uint8_t* data;
+    size_t size;
+  };
+
+  void new_block(const size_t minSize);
+
+  size_t m_blockSize;
+  std::vector<block> m_blocks;
+  uint8_t* m_ptr = nullptr; // Next free byte in the current block
+  uint8_t* m_end = nullptr; // End of the current block
+  stats m_stats;
+
+  DISABLE_COPYING(arena);
+};
+
+// Adapter to use an arena in STL containers (e.g. std::vector<int,
+// base::arena_allocator<int>>). Deallocations do nothing, the memory
+// is released with arena::reset().
+template<typename T>
+class arena_allocator {
+public:
+  typedef T value_type;
+
+  arena_allocator(arena& a) : m_arena(&a) {}
+  template<typename U>
+  arena_allocator(const arena_allocator<U>& other) : m_arena(other.get_arena())
+  {
+  }
+
+  T* allocate(const std::size_t n)
+  {
+    return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T*, std::size_t) {}
+
+  arena* get_arena() const { return m_arena; }
+
+  template<typename U>
+  bool operator==(const arena_allocator<U>& other) const
+  {
+    return m_arena == other.get_arena();
+  }
+  template<typename U>
+  bool operator!=(const arena_allocator<U>& other) const
+  {
+    return m_arena != other.get_arena();
+  }
+
+private:
+  arena* m_arena;
+};
+
+} // namespace base
+
+#endif
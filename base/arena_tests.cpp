@@ -0,0 +1,80 @@
+// LAF Base Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/arena.h"
+
+#include <vector>
+
+using namespace base;
+
+TEST(Arena, Allocate)
+{
+  arena a(1024);
+  void* p = a.allocate(10, 1);
+  void* q = a.allocate(16, 16);
+  void* r = a.allocate(4, 4);
+  EXPECT_NE(p, q);
+  EXPECT_EQ(0, size_t(q) % 16);
+  EXPECT_EQ(0, size_t(r) % 4);
+  EXPECT_EQ((uint8_t*)q + 16, (uint8_t*)r);
+  EXPECT_EQ(3, a.get_stats().allocs);
+  EXPECT_EQ(1, a.get_stats().heap_allocs);
+
+  // Bigger than a block
+  void* big = a.allocate(4096);
+  EXPECT_NE(nullptr, big);
+  EXPECT_EQ(2, a.get_stats().heap_allocs);
+}
+
+TEST(Arena, Reset)
+{
+  arena a(256);
+  for (int i = 0; i < 10; ++i)
+    a.allocate(100);
+  EXPECT_LT(1, a.get_stats().heap_allocs);
+  const size_t capacity = a.get_stats().capacity;
+
+  // After reset we have one block with the whole capacity
+  a.reset();
+  const auto heapAllocs = a.get_stats().heap_allocs;
+  EXPECT_EQ(0, a.get_stats().used);
+  EXPECT_EQ(capacity, a.get_stats().capacity);
+  for (int i = 0; i < 10; ++i)
+    a.allocate(100);
+  EXPECT_EQ(heapAllocs, a.get_stats().heap_allocs);
+}
+
+TEST(Arena, Make)
+{
+  struct point {
+    int x, y;
+    point(int x, int y) : x(x), y(y) {}
+  };
+  arena a;
+  point* pt = a.make<point>(2, 3);
+  EXPECT_EQ(2, pt->x);
+  EXPECT_EQ(3, pt->y);
+  EXPECT_EQ(0, size_t(pt) % alignof(point));
+}
+
+TEST(Arena, Allocator)
+{
+  arena a;
+  std::vector<int, arena_allocator<int>> v{ arena_allocator<int>(a) };
+  for (int i = 0; i < 1000; ++i)
+    v.push_back(i);
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_EQ(i, v[i]);
+  EXPECT_EQ(1, a.get_stats().heap_allocs);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,557 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/async_io.h"
+
+#include "base/debug.h"
+#include "base/log.h"
+#include "base/string.h"
+#include "base/thread_pool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#if LAF_WINDOWS
+  #include <io.h>
+  #include <windows.h>
+#else
+  #include <unistd.h>
+#endif
+
+#if LAF_LINUX && __has_include(<linux/io_uring.h>)
+  #include <linux/io_uring.h>
+  #include <sys/mman.h>
+  #include <sys/syscall.h>
+
+  // IORING_OP_READ/WRITE were added with IORING_FEAT_RW_CUR_POS (Linux 5.6)
+  #if defined(IORING_FEAT_RW_CUR_POS) && defined(__NR_io_uring_setup)
+    #define LAF_IO_URING 1
+  #endif
+#endif
+
+namespace base {
+
+namespace {
+
+// Max bytes transferred in one system call (bigger operations are
+// split in several calls).
+constexpr size_t kMaxChunk = size_t(1) << 30;
+
+struct operation {
+  enum class kind { read, write };
+
+  kind type;
+  int fd;
+  uint8_t* data;
+  size_t size;
+  uint64_t offset;
+  size_t done = 0; // Bytes already transferred
+  async_io::callback callback;
+};
+
+// Blocking transfer used in the thread pool backend. Returns the
+// number of transferred bytes or -errno.
+int64_t transfer(operation& op)
+{
+  while (op.done < op.size) {
+    const size_t n = std::min(op.size - op.done, kMaxChunk);
+    const uint64_t offset = op.offset + op.done;
+#if LAF_WINDOWS
+    HANDLE handle = (HANDLE)_get_osfhandle(op.fd);
+    if (handle == INVALID_HANDLE_VALUE)
+      return -EBADF;
+
+    // A synchronous handle with an OVERLAPPED structure reads/writes
+    // at the given offset.
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = DWORD(offset);
+    overlapped.OffsetHigh = DWORD(offset >> 32);
+    DWORD count = 0;
+    const BOOL ok = (op.type == operation::kind::read ?
+                       ReadFile(handle, op.data + op.done, DWORD(n), &count, &overlapped) :
+                       WriteFile(handle, op.data + op.done, DWORD(n), &count, &overlapped));
+    if (!ok) {
+      if (GetLastError() == ERROR_HANDLE_EOF)
+        break;
+      return -EIO;
+    }
+    const int64_t result = count;
+#else
+    const ssize_t result = (op.type == operation::kind::read ?
+                              pread(op.fd, op.data + op.done, n, off_t(offset)) :
+                              pwrite(op.fd, op.data + op.done, n, off_t(offset)));
+    if (result < 0) {
+      if (errno == EINTR)
+        continue;
+      return -errno;
+    }
+#endif
+    if (result == 0)
+      break;
+    op.done += size_t(result);
+  }
+  return int64_t(op.done);
+}
+
+void close_fd(const int fd)
+{
+#if LAF_WINDOWS
+  _close(fd);
+#else
+  close(fd);
+#endif
+}
+
+} // anonymous namespace
+
+class async_io::impl {
+public:
+  impl(const backend b, thread_pool* pool, const int queue_depth) : m_pool(pool)
+  {
+#if LAF_IO_URING
+    if (b == backend::io_uring)
+      init_ring(std::clamp(queue_depth, 1, 4096));
+#else
+    (void)b;
+    (void)queue_depth;
+#endif
+    if (!use_ring() && !m_pool) {
+      m_ownPool = std::make_unique<thread_pool>(4);
+      m_pool = m_ownPool.get();
+    }
+  }
+
+  ~impl()
+  {
+    wait_all();
+#if LAF_IO_URING
+    exit_ring();
+#endif
+  }
+
+  backend get_backend() const { return (use_ring() ? backend::io_uring : backend::thread_pool); }
+
+  void enqueue(operation* op)
+  {
+    const std::lock_guard lock(m_mutex);
+    m_queued.push_back(op);
+    ++m_pending;
+  }
+
+  void submit()
+  {
+#if LAF_IO_URING
+    if (use_ring()) {
+      const std::lock_guard lock(m_mutex);
+      submit_ring();
+      return;
+    }
+#endif
+
+    std::deque<operation*> ops;
+    {
+      const std::lock_guard lock(m_mutex);
+      std::swap(ops, m_queued);
+    }
+    for (operation* op : ops)
+      m_pool->execute([this, op] { finish(op, transfer(*op)); });
+  }
+
+  void wait_all()
+  {
+    submit();
+
+    std::unique_lock lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_pending == 0; });
+  }
+
+  int pending() const
+  {
+    const std::lock_guard lock(m_mutex);
+    return m_pending;
+  }
+
+private:
+  bool use_ring() const
+  {
+#if LAF_IO_URING
+    return m_ring >= 0;
+#else
+    return false;
+#endif
+  }
+
+  // Calls the callback of the operation and deletes it.
+  void finish(operation* op, const int64_t result)
+  {
+    try {
+      if (op->callback)
+        op->callback(result);
+    }
+    catch (const std::exception& e) {
+      LOG(ERROR, "IO: Exception from callback: %s\n", e.what());
+      ASSERT(false);
+    }
+    delete op;
+
+    const std::lock_guard lock(m_mutex);
+    if (--m_pending == 0)
+      m_cv.notify_all();
+  }
+
+#if LAF_IO_URING
+
+  static int io_uring_setup(unsigned entries, io_uring_params* params)
+  {
+    return int(syscall(__NR_io_uring_setup, entries, params));
+  }
+
+  static int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+  {
+    return int(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+  }
+
+  void init_ring(const int queue_depth)
+  {
+    io_uring_params params = {};
+    const int fd = io_uring_setup(unsigned(queue_depth), &params);
+    if (fd < 0)
+      return;
+    if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+      close(fd);
+      return;
+    }
+
+    m_sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP);
+    if (single_mmap)
+      m_sqSize = m_cqSize = std::max(m_sqSize, m_cqSize);
+
+    m_sqPtr = mmap(nullptr,
+                   m_sqSize,
+                   PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE,
+                   fd,
+                   IORING_OFF_SQ_RING);
+    if (m_sqPtr == MAP_FAILED) {
+      close(fd);
+      return;
+    }
+    if (single_mmap) {
+      m_cqPtr = m_sqPtr;
+    }
+    else {
+      m_cqPtr = mmap(nullptr,
+                     m_cqSize,
+                     PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE,
+                     fd,
+                     IORING_OFF_CQ_RING);
+      if (m_cqPtr == MAP_FAILED) {
+        munmap(m_sqPtr, m_sqSize);
+        close(fd);
+        return;
+      }
+    }
+    m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr,
+                      m_sqesSize,
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE,
+                      fd,
+                      IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      if (m_cqPtr != m_sqPtr)
+        munmap(m_cqPtr, m_cqSize);
+      munmap(m_sqPtr, m_sqSize);
+      close(fd);
+      return;
+    }
+
+    auto* sq = (uint8_t*)m_sqPtr;
+    auto* cq = (uint8_t*)m_cqPtr;
+    m_sqTail = (unsigned*)(sq + params.sq_off.tail);
+    m_sqMask = *(unsigned*)(sq + params.sq_off.ring_mask);
+    m_sqArray = (unsigned*)(sq + params.sq_off.array);
+    m_sqes = (io_uring_sqe*)sqes;
+    m_cqHead = (unsigned*)(cq + params.cq_off.head);
+    m_cqTail = (unsigned*)(cq + params.cq_off.tail);
+    m_cqMask = *(unsigned*)(cq + params.cq_off.ring_mask);
+    m_cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+    m_entries = params.sq_entries;
+    m_ring = fd;
+
+    m_thread = std::thread([this] { completion_thread(); });
+  }
+
+  void exit_ring()
+  {
+    if (m_ring < 0)
+      return;
+
+    // A no-op without operation stops the completion thread
+    {
+      const std::lock_guard lock(m_mutex);
+      push_sqe(nullptr);
+      enter_sqes(1);
+    }
+    m_thread.join();
+
+    munmap(m_sqes, m_sqesSize);
+    if (m_cqPtr != m_sqPtr)
+      munmap(m_cqPtr, m_cqSize);
+    munmap(m_sqPtr, m_sqSize);
+    close(m_ring);
+  }
+
+  // Adds a submission queue entry for the given operation (or a
+  // no-op if it's nullptr). m_mutex must be locked.
+  void push_sqe(operation* op)
+  {
+    const unsigned tail = *m_sqTail;
+    const unsigned index = tail & m_sqMask;
+    io_uring_sqe* sqe = &m_sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    if (op) {
+      sqe->opcode = (op->type == operation::kind::read ? IORING_OP_READ : IORING_OP_WRITE);
+      sqe->fd = op->fd;
+      sqe->off = op->offset + op->done;
+      sqe->addr = uint64_t(op->data + op->done);
+      sqe->len = unsigned(std::min(op->size - op->done, kMaxChunk));
+    }
+    else {
+      sqe->opcode = IORING_OP_NOP;
+    }
+    sqe->user_data = uint64_t(op);
+    m_sqArray[index] = index;
+    __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+  }
+
+  void enter_sqes(unsigned count)
+  {
+    while (count > 0) {
+      const int result = io_uring_enter(m_ring, count, 0, 0);
+      if (result < 0) {
+        if (errno == EINTR)
+          continue;
+        // The entries stay in the queue for the next io_uring_enter()
+        LOG(ERROR, "IO: io_uring_enter failed (%d)\n", errno);
+        break;
+      }
+      count -= unsigned(result);
+    }
+  }
+
+  // Submits the queued operations that fit in the ring, the others
+  // are submitted as previous operations are completed (m_mutex must
+  // be locked).
+  void submit_ring()
+  {
+    unsigned count = 0;
+    while (!m_queued.empty() && m_inflight < m_entries) {
+      push_sqe(m_queued.front());
+      m_queued.pop_front();
+      ++m_inflight;
+      ++count;
+    }
+    enter_sqes(count);
+  }
+
+  void completion_thread()
+  {
+    std::vector<std::pair<operation*, int>> completed;
+    bool running = true;
+    while (running) {
+      if (io_uring_enter(m_ring, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+        LOG(ERROR, "IO: io_uring_enter failed waiting events (%d)\n", errno);
+        break;
+      }
+
+      unsigned head = *m_cqHead;
+      const unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+      for (; head != tail; ++head) {
+        const io_uring_cqe* cqe = &m_cqes[head & m_cqMask];
+        completed.emplace_back((operation*)cqe->user_data, cqe->res);
+      }
+      __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+
+      for (auto [op, res] : completed) {
+        if (!op) {
+          running = false;
+          continue;
+        }
+
+        bool done = true;
+        if (res == -EINTR || res == -EAGAIN)
+          done = false;
+        else if (res > 0) {
+          op->done += size_t(res);
+          done = (op->done == op->size);
+        }
+        {
+          const std::lock_guard lock(m_mutex);
+          --m_inflight;
+          // Partial transfer, submit the rest of the operation
+          if (!done)
+            m_queued.push_front(op);
+        }
+        if (done)
+          finish(op, res < 0 ? res : int64_t(op->done));
+      }
+      completed.clear();
+
+      const std::lock_guard lock(m_mutex);
+      submit_ring();
+    }
+  }
+
+  int m_ring = -1;
+  unsigned m_entries = 0;
+  unsigned m_inflight = 0; // Operations submitted to the ring
+  std::thread m_thread;
+
+  void* m_sqPtr = nullptr;
+  void* m_cqPtr = nullptr;
+  size_t m_sqSize = 0;
+  size_t m_cqSize = 0;
+  size_t m_sqesSize = 0;
+  unsigned* m_sqTail = nullptr;
+  unsigned* m_sqArray = nullptr;
+  unsigned m_sqMask = 0;
+  io_uring_sqe* m_sqes = nullptr;
+  unsigned* m_cqHead = nullptr;
+  unsigned* m_cqTail = nullptr;
+  unsigned m_cqMask = 0;
+  io_uring_cqe* m_cqes = nullptr;
+
+#endif // LAF_IO_URING
+
+  thread_pool* m_pool;
+  std::unique_ptr<thread_pool> m_ownPool;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<operation*> m_queued; // Operations not yet submitted
+  int m_pending = 0;               // Operations queued or in progress
+};
+
+async_io::async_io(const backend b, thread_pool* pool, const int queue_depth)
+  : m_impl(std::make_unique<impl>(b, pool, queue_depth))
+{
+}
+
+async_io::~async_io()
+{
+}
+
+// static
+bool async_io::is_io_uring_supported()
+{
+  static const bool supported = []() {
+    async_io io(backend::io_uring);
+    return io.get_backend() == backend::io_uring;
+  }();
+  return supported;
+}
+
+async_io::backend async_io::get_backend() const
+{
+  return m_impl->get_backend();
+}
+
+void async_io::read(const int fd,
+                    void* data,
+                    const size_t size,
+                    const uint64_t offset,
+                    callback&& done)
+{
+  m_impl->enqueue(
+    new operation{ operation::kind::read, fd, (uint8_t*)data, size, offset, 0, std::move(done) });
+}
+
+void async_io::write(const int fd,
+                     const void* data,
+                     const size_t size,
+                     const uint64_t offset,
+                     callback&& done)
+{
+  m_impl->enqueue(
+    new operation{ operation::kind::write, fd, (uint8_t*)data, size, offset, 0, std::move(done) });
+}
+
+void async_io::read_file(const std::string& filename, file_callback&& done)
+{
+#if LAF_WINDOWS
+  const int fd = _wopen(from_utf8(filename).c_str(), _O_RDONLY | _O_BINARY);
+  struct _stat64 st;
+  const bool ok = (fd >= 0 && _fstat64(fd, &st) == 0);
+#else
+  const int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat st;
+  const bool ok = (fd >= 0 && fstat(fd, &st) == 0);
+#endif
+  if (!ok) {
+    const int error = errno;
+    if (fd >= 0)
+      close_fd(fd);
+    if (done)
+      done(filename, buffer(), error);
+    return;
+  }
+
+  struct file_read {
+    std::string filename;
+    buffer data;
+    file_callback done;
+  };
+  auto state = std::make_shared<file_read>();
+  state->filename = filename;
+  state->data.resize(size_t(st.st_size));
+  state->done = std::move(done);
+
+  read(fd, state->data.data(), state->data.size(), 0, [fd, state](int64_t result) {
+    close_fd(fd);
+    if (!state->done)
+      return;
+    if (result < 0) {
+      state->done(state->filename, buffer(), int(-result));
+    }
+    else {
+      state->data.resize(size_t(result));
+      state->done(state->filename, std::move(state->data), 0);
+    }
+  });
+}
+
+void async_io::submit()
+{
+  m_impl->submit();
+}
+
+void async_io::wait_all()
+{
+  m_impl->wait_all();
+}
+
+int async_io::pending() const
+{
+  return m_impl->pending();
+}
+
+} // namespace base
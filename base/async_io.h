@@ -0,0 +1,101 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_ASYNC_IO_H_INCLUDED
+#define BASE_ASYNC_IO_H_INCLUDED
+#pragma once
+
+#include "base/buffer.h"
+#include "base/disable_copying.h"
+#include "base/ints.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace base {
+
+class thread_pool;
+
+// Asynchronous file I/O: reads and writes are queued and submitted
+// in batches with submit(), and a callback is called when each one
+// is completed, so the caller can overlap I/O with other work (e.g.
+// loading hundreds of images and decoding them as they arrive).
+//
+// It uses io_uring on Linux when the kernel supports it, in other
+// case (or if the backend is thread_pool) the operations are
+// executed with blocking calls in a base::thread_pool.
+//
+// Callbacks are called from an internal thread (io_uring) or from
+// the workers of the thread pool, they should be short (e.g. enqueue
+// the decoding of the data in other thread_pool).
+//
+//   base::async_io io;
+//   for (const auto& fn : filenames) {
+//     io.read_file(fn, [](const std::string& fn, base::buffer&& data, int error) {
+//       ...
+//     });
+//   }
+//   io.submit();
+//   io.wait_all();
+//
+class async_io {
+public:
+  enum class backend {
+    io_uring,
+    thread_pool,
+  };
+
+  // Called with the number of bytes transferred (it's less than the
+  // requested size only when the end of file is reached), or a
+  // negative errno value if there was an error.
+  using callback = std::function<void(int64_t result)>;
+  using file_callback =
+    std::function<void(const std::string& filename, buffer&& data, int error)>;
+
+  // The thread pool is used only if io_uring is not available, if it
+  // is nullptr, an internal pool is created. "queue_depth" is the max
+  // number of operations submitted to the kernel at the same time.
+  async_io(backend b = backend::io_uring, thread_pool* pool = nullptr, int queue_depth = 64);
+
+  // Waits all the pending operations.
+  ~async_io();
+
+  static bool is_io_uring_supported();
+
+  backend get_backend() const;
+
+  // Queues a read/write of "size" bytes at the given "offset" of the
+  // file descriptor. The buffer and the file descriptor must be valid
+  // until the callback is called.
+  void read(int fd, void* data, size_t size, uint64_t offset, callback&& done);
+  void write(int fd, const void* data, size_t size, uint64_t offset, callback&& done);
+
+  // Opens and reads the whole file. The file is opened immediately
+  // (in the calling thread), if it cannot be opened the callback is
+  // called with the errno value.
+  void read_file(const std::string& filename, file_callback&& done);
+
+  // Submits all queued operations.
+  void submit();
+
+  // Submits the queued operations and waits all of them (and their
+  // callbacks) to finish.
+  void wait_all();
+
+  // Number of operations queued or in progress.
+  int pending() const;
+
+private:
+  class impl;
+  std::unique_ptr<impl> m_impl;
+
+  DISABLE_COPYING(async_io);
+};
+
+} // namespace base
+
+#endif
@@ -0,0 +1,142 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/async_io.h"
+#include "base/file_content.h"
+#include "base/file_handle.h"
+#include "base/fs.h"
+#include "base/thread_pool.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+#if LAF_WINDOWS
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+
+using namespace base;
+
+static const async_io::backend kBackends[] = { async_io::backend::io_uring,
+                                                async_io::backend::thread_pool };
+
+static void close_fd(int fd)
+{
+#if LAF_WINDOWS
+  _close(fd);
+#else
+  close(fd);
+#endif
+}
+
+TEST(AsyncIO, ReadWrite)
+{
+  const char* fn = "async.bin";
+  for (auto b : kBackends) {
+    async_io io(b, nullptr, 4);
+    if (b == async_io::backend::thread_pool) {
+      EXPECT_EQ(async_io::backend::thread_pool, io.get_backend());
+    }
+
+    // Write 16 blocks of 4kb (more than the queue depth)
+    constexpr int kBlocks = 16;
+    constexpr int kBlockSize = 4096;
+    std::vector<uint8_t> data(kBlocks * kBlockSize);
+    for (size_t i = 0; i < data.size(); ++i)
+      data[i] = uint8_t(i * 7 + i / 4096);
+
+    int fd = open_file_descriptor_with_exception(fn, "wb");
+    std::atomic<int> written(0);
+    for (int i = 0; i < kBlocks; ++i) {
+      io.write(fd, &data[i * kBlockSize], kBlockSize, i * kBlockSize, [&](int64_t result) {
+        EXPECT_EQ(kBlockSize, result);
+        ++written;
+      });
+    }
+    EXPECT_EQ(kBlocks, io.pending());
+    io.wait_all();
+    EXPECT_EQ(0, io.pending());
+    EXPECT_EQ(kBlocks, written);
+    close_fd(fd);
+    EXPECT_EQ(data, read_file_content(fn));
+
+    // Read blocks in reverse order, the last one is incomplete (end
+    // of file)
+    std::vector<uint8_t> data2(data.size() + 100);
+    fd = open_file_descriptor_with_exception(fn, "rb");
+    std::vector<int64_t> results(kBlocks);
+    for (int i = kBlocks - 1; i >= 0; --i) {
+      io.read(fd, &data2[i * kBlockSize], kBlockSize + (i == kBlocks - 1 ? 100 : 0),
+              i * kBlockSize, [&results, i](int64_t result) { results[i] = result; });
+    }
+    io.submit();
+    io.wait_all();
+    close_fd(fd);
+    for (int i = 0; i < kBlocks; ++i)
+      EXPECT_EQ(kBlockSize, results[i]);
+    data2.resize(data.size());
+    EXPECT_EQ(data, data2);
+
+    // Invalid file descriptor
+    int64_t error = 0;
+    io.read(-1, &data2[0], 1, 0, [&error](int64_t result) { error = result; });
+    io.wait_all();
+    EXPECT_EQ(-EBADF, error);
+  }
+  delete_file(fn);
+}
+
+TEST(AsyncIO, ReadFiles)
+{
+  make_directory("async");
+  std::vector<std::string> fns;
+  for (int i = 0; i < 50; ++i) {
+    std::string fn = join_path("async", std::to_string(i));
+    std::string content(i * 100, char('a' + i % 26));
+    write_file_content(fn, (const uint8_t*)content.data(), content.size());
+    fns.push_back(fn);
+  }
+
+  thread_pool pool(2);
+  for (auto b : kBackends) {
+    async_io io(b, &pool);
+    std::mutex mutex;
+    std::map<std::string, size_t> sizes;
+    for (const auto& fn : fns) {
+      io.read_file(fn, [&](const std::string& fn, buffer&& data, int error) {
+        EXPECT_EQ(0, error);
+        const std::lock_guard lock(mutex);
+        sizes[fn] = data.size();
+      });
+    }
+    int error = 0;
+    io.read_file(join_path("async", "non-existent"),
+                 [&error](const std::string&, buffer&& data, int err) {
+                   EXPECT_TRUE(data.empty());
+                   error = err;
+                 });
+    EXPECT_EQ(ENOENT, error);
+    io.wait_all();
+
+    ASSERT_EQ(fns.size(), sizes.size());
+    for (int i = 0; i < int(fns.size()); ++i)
+      EXPECT_EQ(i * 100, sizes[fns[i]]);
+  }
+
+  for (const auto& fn : fns)
+    delete_file(fn);
+  remove_directory("async");
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2022 Igara Studio S.A.
+// Copyright (c) 2022-2025 Igara Studio S.A.
 // Copyright (c) 2015-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -10,126 +10,249 @@
 #endif
 
 #include "base/base64.h"
+#include "base/cpu_features.h"
 #include "base/debug.h"
 #include "base/ints.h"
 
-#include <cmath>
+#include <cstring>
 
-namespace base {
+#if LAF_CPU_X86
+  #include <immintrin.h>
+#endif
 
-// clang-format off
+namespace base {
 
-static const char base64Table[] = "ABCDEFGHIJKLMNOP"
-                                  "QRSTUVWXYZabcdef"
-                                  "ghijklmnopqrstuv"
-                                  "wxyz0123456789+/";
+namespace {
 
-static const int invBase64Table[] = {
- // From 32 to 47                 '+'         '/'
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,62, 0, 0, 0,63,
- // From 48 to 63     '9'
- 52,53,54,55,56,57,58,59,60,61, 0, 0, 0, 0, 0, 0,
- // From 64 to 79
-  0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14,
- // From 80 to 95
- 15,16,17,18,19,20,21,22,23,24,25, 0, 0, 0, 0, 0,
- // From 96 to 111                            'o'
-  0,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,
- // From 112 to 122            'z'
- 41,42,43,44,45,46,47,48,49,50,51 };
+const char base64Table[] = "ABCDEFGHIJKLMNOP"
+                           "QRSTUVWXYZabcdef"
+                           "ghijklmnopqrstuv"
+                           "wxyz0123456789+/";
 
-// clang-format on
+// Value of each base64 char, or -1 for invalid chars (they are
+// decoded as 0 to keep compatibility with old versions).
+struct InvTable {
+  int8_t values[256];
+  InvTable()
+  {
+    std::memset(values, -1, sizeof(values));
+    for (int i = 0; i < 64; ++i)
+      values[uint8_t(base64Table[i])] = i;
+  }
+};
+const InvTable invTable;
 
-static inline char base64Char(int index)
+inline uint32_t base64Inv(const char chr)
 {
-  ASSERT(index >= 0 && index < 64);
-  return base64Table[index];
+  const int8_t v = invTable.values[uint8_t(chr)];
+  return (v >= 0 ? uint32_t(v) : 0);
 }
 
-static inline int base64Inv(int asciiChar)
+// Encodes complete groups of 3 bytes (n must be multiple of 3).
+void encode_scalar(const uint8_t* input, size_t n, char* output)
 {
-  asciiChar -= 32;
-  if (asciiChar >= 0 && asciiChar < sizeof(invBase64Table))
-    return invBase64Table[asciiChar];
-  return 0;
+  for (; n >= 3; n -= 3, input += 3, output += 4) {
+    const uint32_t v = (uint32_t(input[0]) << 16) | (uint32_t(input[1]) << 8) | input[2];
+    output[0] = base64Table[(v >> 18) & 63];
+    output[1] = base64Table[(v >> 12) & 63];
+    output[2] = base64Table[(v >> 6) & 63];
+    output[3] = base64Table[v & 63];
+  }
 }
 
-void encode_base64(const char* input, size_t n, std::string& output)
+// Encodes the last 1 or 2 bytes with padding.
+void encode_tail(const uint8_t* input, const size_t n, char* output)
 {
-  const size_t size = 4 * int(std::ceil(n / 3.0)); // Estimate encoded string size
-  output.resize(size);
+  ASSERT(n == 1 || n == 2);
+  const uint32_t v = (uint32_t(input[0]) << 16) | (n == 2 ? uint32_t(input[1]) << 8 : 0);
+  output[0] = base64Table[(v >> 18) & 63];
+  output[1] = base64Table[(v >> 12) & 63];
+  output[2] = (n == 2 ? base64Table[(v >> 6) & 63] : '=');
+  output[3] = '=';
+}
 
-  auto outIt = output.begin();
-  auto outEnd = output.end();
-  uint8_t next = 0;
-  size_t i = 0;
-  size_t j = 0;
-  for (; i < n; ++i, ++input) {
-    auto inputValue = *input;
-    switch (j) {
-      case 0:
-        *outIt = base64Char((inputValue & 0b11111100) >> 2);
-        ++outIt;
-        next |= (inputValue & 0b00000011) << 4;
-        ++j;
-        break;
-      case 1:
-        *outIt = base64Char(((inputValue & 0b11110000) >> 4) | next);
-        ++outIt;
-        next = (inputValue & 0b00001111) << 2;
-        ++j;
-        break;
-      case 2:
-        *outIt = base64Char(((inputValue & 0b11000000) >> 6) | next);
-        ++outIt;
-        *outIt = base64Char(inputValue & 0b00111111);
-        ++outIt;
-        next = 0;
-        j = 0;
-        break;
+// Decodes complete groups of 4 chars, stops at the first padding
+// char. Returns the number of decoded bytes and sets "end" to true if
+// the padding was found.
+size_t decode_scalar(const char* input, size_t n, uint8_t* output, bool& end)
+{
+  uint8_t* out = output;
+  for (; n >= 4; n -= 4, input += 4) {
+    const uint32_t v = (base64Inv(input[0]) << 18) | (base64Inv(input[1]) << 12) |
+                       (base64Inv(input[2]) << 6) | base64Inv(input[3]);
+    *(out++) = uint8_t(v >> 16);
+    if (input[2] == '=') {
+      end = true;
+      break;
     }
-  }
-
-  if (outIt != outEnd) {
-    if (next) {
-      *outIt = base64Char(next);
-      ++outIt;
+    *(out++) = uint8_t(v >> 8);
+    if (input[3] == '=') {
+      end = true;
+      break;
     }
-    for (; outIt != outEnd; ++outIt)
-      *outIt = '='; // Padding
+    *(out++) = uint8_t(v);
   }
+  return out - output;
 }
 
-void decode_base64(const char* input, size_t n, buffer& output)
+#if LAF_CPU_X86
+
+// Encodes 12 bytes in 16 chars for each iteration (W. Muła's
+// algorithm). Reads 16 bytes, so the last 4 bytes must be readable.
+// Returns the number of encoded bytes (a multiple of 12).
+LAF_TARGET("ssse3")
+size_t encode_ssse3(const uint8_t* input, const size_t n, char* output)
 {
-  size_t size = 3 * int(std::ceil(n / 4.0)); // Estimate decoded buffer size
-  output.resize(size);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 12, output += 16) {
+    __m128i in = _mm_loadu_si128((const __m128i*)(input + i));
+
+    // Put the 3 bytes of each group in 4 bytes (b1 b0 b2 b1), and
+    // move each 6-bit value to its own byte.
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t1, t3);
 
-  auto outIt = output.begin();
+    // Convert indices (0-63) to chars adding an offset that depends
+    // on the range of the index.
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    range = _mm_or_si128(range, _mm_and_si128(less, _mm_set1_epi8(13)));
+    const __m128i offsets = _mm_setr_epi8('a' - 26,
+                                          '0' - 52,
+                                          '0' - 52,
+                                          '0' - 52,
+                                          '0' - 52,
+                                          '0' - 52,
+                                          '0' - 52,
+                                          '0' - 52,
+                                          '0' - 52,
+                                          '0' - 52,
+                                          '0' - 52,
+                                          '+' - 62,
+                                          '/' - 63,
+                                          'A',
+                                          0,
+                                          0);
+    const __m128i chars = _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+    _mm_storeu_si128((__m128i*)output, chars);
+  }
+  return i;
+}
+
+// Decodes 16 chars in 12 bytes for each iteration. Writes 16 bytes,
+// so the output must have 4 extra bytes. Stops when it finds a
+// padding or an invalid char (the scalar version handles those
+// cases). Returns the number of decoded chars (a multiple of 16).
+LAF_TARGET("ssse3")
+size_t decode_ssse3(const char* input, const size_t n, uint8_t* output)
+{
   size_t i = 0;
-  for (; i + 3 < n; i += 4, input += 4) {
-    *outIt = (((base64Inv(input[0])) << 2) | ((base64Inv(input[1]) & 0b110000) >> 4));
-    ++outIt;
+  for (; i + 16 <= n; i += 16, output += 12) {
+    const __m128i in = _mm_loadu_si128((const __m128i*)(input + i));
 
-    if (input[2] == '=') {
-      size -= 2;
+    // Chars >= 0x80 are negative, so they are outside all ranges
+    auto in_range = [in](const char a, const char b) {
+      return _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8(a - 1)),
+                           _mm_cmpgt_epi8(_mm_set1_epi8(b + 1), in));
+    };
+    const __m128i upper = in_range('A', 'Z');
+    const __m128i lower = in_range('a', 'z');
+    const __m128i digit = in_range('0', '9');
+    const __m128i plus = _mm_cmpeq_epi8(in, _mm_set1_epi8('+'));
+    const __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+
+    const __m128i valid =
+      _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(_mm_or_si128(digit, plus), slash));
+    if (_mm_movemask_epi8(valid) != 0xffff)
       break;
-    }
 
-    *outIt = (((base64Inv(input[1]) & 0b001111) << 4) | ((base64Inv(input[2]) & 0b111100) >> 2));
-    ++outIt;
+    // Ranges are disjoint, so we can "or" the offsets
+    const __m128i offset = _mm_or_si128(
+      _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                   _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+      _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                   _mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(62 - '+')),
+                                _mm_and_si128(slash, _mm_set1_epi8(63 - '/')))));
+    const __m128i values = _mm_add_epi8(in, offset);
 
-    if (input[3] == '=') {
-      --size;
-      break;
-    }
+    // Join the four 6-bit values of each group in 24 bits
+    const __m128i ab_cd = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i abcd = _mm_madd_epi16(ab_cd, _mm_set1_epi32(0x00011000));
+    const __m128i out =
+      _mm_shuffle_epi8(abcd, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    _mm_storeu_si128((__m128i*)output, out);
+  }
+  return i;
+}
 
-    *outIt = (((base64Inv(input[2]) & 0b000011) << 6) | ((base64Inv(input[3]))));
-    ++outIt;
+#endif // LAF_CPU_X86
+
+// Encodes complete groups of 3 bytes (n must be multiple of 3).
+void encode_blocks(const uint8_t* input, size_t n, char* output)
+{
+  ASSERT(n % 3 == 0);
+#if LAF_CPU_X86
+  static const bool ssse3 = get_cpu_features().ssse3;
+  if (ssse3) {
+    const size_t m = encode_ssse3(input, n, output);
+    input += m;
+    output += 4 * (m / 3);
+    n -= m;
+  }
+#endif
+  encode_scalar(input, n, output);
+}
+
+// Decodes complete groups of 4 chars (n must be multiple of 4). The
+// output must have space for 3*n/4 bytes.
+size_t decode_blocks(const char* input, size_t n, uint8_t* output, bool& end)
+{
+  ASSERT(n % 4 == 0);
+  size_t written = 0;
+#if LAF_CPU_X86
+  static const bool ssse3 = get_cpu_features().ssse3;
+  // We need 4 extra bytes in the output (decode_ssse3() writes 16
+  // bytes for 12 decoded bytes), so the last 16 chars are decoded
+  // with the scalar version.
+  if (ssse3 && n >= 32) {
+    const size_t m = decode_ssse3(input, n - 16, output);
+    input += m;
+    n -= m;
+    written = 3 * (m / 4);
+    output += written;
   }
+#endif
+  return written + decode_scalar(input, n, output, end);
+}
+
+} // anonymous namespace
 
-  if (output.size() > size)
-    output.resize(size);
+void encode_base64(const char* input, size_t n, std::string& output)
+{
+  output.resize(4 * ((n + 2) / 3));
+  if (n == 0)
+    return;
+
+  const size_t m = n - n % 3;
+  encode_blocks((const uint8_t*)input, m, &output[0]);
+  if (m < n)
+    encode_tail((const uint8_t*)input + m, n - m, &output[4 * (m / 3)]);
+}
+
+void decode_base64(const char* input, size_t n, buffer& output)
+{
+  // Incomplete groups at the end are ignored
+  n -= n % 4;
+  output.resize(3 * (n / 4));
+  if (n == 0)
+    return;
+
+  bool end = false;
+  output.resize(decode_blocks(input, n, output.data(), end));
 }
 
 void decode_base64(const char* input, size_t n, std::string& output)
@@ -139,4 +262,98 @@ void decode_base64(const char* input, size_t n, std::string& output)
   output = std::string((const char*)tmp.data(), tmp.size());
 }
 
+void base64_encoder::reset()
+{
+  m_pendingSize = 0;
+}
+
+void base64_encoder::update(const char* input, size_t n, std::string& output)
+{
+  auto in = (const uint8_t*)input;
+
+  // Complete the pending group
+  if (m_pendingSize > 0) {
+    while (m_pendingSize < 3 && n > 0) {
+      m_pending[m_pendingSize++] = *(in++);
+      --n;
+    }
+    if (m_pendingSize < 3)
+      return;
+
+    const size_t pos = output.size();
+    output.resize(pos + 4);
+    encode_scalar(m_pending, 3, &output[pos]);
+    m_pendingSize = 0;
+  }
+
+  const size_t m = n - n % 3;
+  if (m > 0) {
+    const size_t pos = output.size();
+    output.resize(pos + 4 * (m / 3));
+    encode_blocks(in, m, &output[pos]);
+  }
+
+  for (size_t i = m; i < n; ++i)
+    m_pending[m_pendingSize++] = in[i];
+}
+
+void base64_encoder::finish(std::string& output)
+{
+  if (m_pendingSize > 0) {
+    const size_t pos = output.size();
+    output.resize(pos + 4);
+    encode_tail(m_pending, m_pendingSize, &output[pos]);
+  }
+  reset();
+}
+
+void base64_decoder::reset()
+{
+  m_pendingSize = 0;
+  m_end = false;
+}
+
+void base64_decoder::update(const char* input, size_t n, buffer& output)
+{
+  if (m_end)
+    return;
+
+  // Complete the pending group
+  if (m_pendingSize > 0) {
+    while (m_pendingSize < 4 && n > 0) {
+      m_pending[m_pendingSize++] = *(input++);
+      --n;
+    }
+    if (m_pendingSize < 4)
+      return;
+
+    const size_t pos = output.size();
+    output.resize(pos + 3);
+    output.resize(pos + decode_scalar(m_pending, 4, &output[pos], m_end));
+    m_pendingSize = 0;
+    if (m_end)
+      return;
+  }
+
+  const size_t m = n - n % 4;
+  if (m > 0) {
+    const size_t pos = output.size();
+    output.resize(pos + 3 * (m / 4));
+    output.resize(pos + decode_blocks(input, m, &output[pos], m_end));
+    if (m_end)
+      return;
+  }
+
+  for (size_t i = m; i < n; ++i)
+    m_pending[m_pendingSize++] = input[i];
+}
+
+bool base64_decoder::finish()
+{
+  // Incomplete groups are ignored
+  const bool complete = (m_pendingSize == 0);
+  reset();
+  return complete;
+}
+
 } // namespace base
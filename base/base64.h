@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2022 Igara Studio S.A.
+// Copyright (c) 2022-2025 Igara Studio S.A.
 // Copyright (c) 2015-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -15,8 +15,45 @@
 
 namespace base {
 
+// Uses SSSE3 instructions when they are available. Invalid chars are
+// decoded as zeros, decoding stops at the first padding char ('='),
+// and an incomplete group of chars at the end is ignored.
 void encode_base64(const char* input, size_t n, std::string& output);
 void decode_base64(const char* input, size_t n, buffer& output);
+void decode_base64(const char* input, size_t n, std::string& output);
+
+// Encodes data incrementally (e.g. chunks read from a file). Each
+// update() appends the encoded chars to the output, and finish()
+// appends the last group with padding.
+class base64_encoder {
+public:
+  base64_encoder() { reset(); }
+
+  void reset();
+  void update(const char* input, size_t n, std::string& output);
+  void finish(std::string& output);
+
+private:
+  uint8_t m_pending[3]; // Bytes of an incomplete group
+  size_t m_pendingSize;
+};
+
+// Decodes data incrementally. Each update() appends the decoded bytes
+// to the output. finish() returns false if there was an incomplete
+// group of chars at the end (it's ignored).
+class base64_decoder {
+public:
+  base64_decoder() { reset(); }
+
+  void reset();
+  void update(const char* input, size_t n, buffer& output);
+  bool finish();
+
+private:
+  char m_pending[4]; // Chars of an incomplete group
+  size_t m_pendingSize;
+  bool m_end; // True if we found the padding
+};
 
 inline void encode_base64(const buffer& input, std::string& output)
 {
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2022 Igara Studio S.A.
+// Copyright (c) 2022-2025 Igara Studio S.A.
 // Copyright (c) 2015-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -10,8 +10,38 @@
 #include "base/base64.h"
 #include "base/string.h"
 
+#include <random>
+
 using namespace base;
 
+// Reference implementation (one byte at a time)
+static std::string simple_encode(const buffer& input)
+{
+  static const char* table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string output;
+  for (size_t i = 0; i < input.size(); i += 3) {
+    uint32_t v = input[i] << 16;
+    if (i + 1 < input.size())
+      v |= input[i + 1] << 8;
+    if (i + 2 < input.size())
+      v |= input[i + 2];
+    output.push_back(table[(v >> 18) & 63]);
+    output.push_back(table[(v >> 12) & 63]);
+    output.push_back(i + 1 < input.size() ? table[(v >> 6) & 63] : '=');
+    output.push_back(i + 2 < input.size() ? table[v & 63] : '=');
+  }
+  return output;
+}
+
+static buffer random_buffer(std::mt19937& gen, size_t size)
+{
+  std::uniform_int_distribution<int> dist(0, 255);
+  buffer buf(size);
+  for (auto& b : buf)
+    b = uint8_t(dist(gen));
+  return buf;
+}
+
 TEST(Base64, Encode)
 {
   EXPECT_EQ("", encode_base64(buffer()));
@@ -21,6 +51,8 @@ TEST(Base64, Encode)
   EXPECT_EQ("YWJjZGU=", encode_base64("abcde"));
   EXPECT_EQ("YWJj", encode_base64("abc"));
   EXPECT_EQ("5pel5pys6Kqe", encode_base64("\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E")); // "日本語"
+  EXPECT_EQ("AA==", encode_base64(buffer{ 0 }));
+  EXPECT_EQ("AAA=", encode_base64(buffer{ 0, 0 }));
 }
 
 TEST(Base64, Decode)
@@ -32,6 +64,73 @@ TEST(Base64, Decode)
   EXPECT_EQ("abcde", decode_base64s("YWJjZGU="));
   EXPECT_EQ("abc", decode_base64s("YWJj"));
   EXPECT_EQ("\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E", decode_base64s("5pel5pys6Kqe")); // "日本語"
+  EXPECT_EQ(buffer{ 0 }, decode_base64("AA=="));
+  EXPECT_EQ(buffer({ 'a', 'b', 'c' }), decode_base64("YWJjZ")); // Incomplete group is ignored
+}
+
+// Previous versions of decode_base64() appended 3 zero bytes for an
+// incomplete group at the end, now it's ignored.
+TEST(Base64, IncompleteGroup)
+{
+  EXPECT_EQ(buffer(), decode_base64("A"));
+  EXPECT_EQ(buffer(), decode_base64("AB"));
+  EXPECT_EQ(buffer(), decode_base64("ABC"));
+  EXPECT_EQ("abc", decode_base64s("YWJjZG"));
+  EXPECT_EQ("abc", decode_base64s("YWJjZGU"));
+
+  base64_decoder decoder;
+  buffer decoded;
+  decoder.update("YWJjZG", 6, decoded);
+  EXPECT_FALSE(decoder.finish());
+  EXPECT_EQ(buffer({ 'a', 'b', 'c' }), decoded);
+}
+
+TEST(Base64, RandomData)
+{
+  std::mt19937 gen(1);
+  for (size_t size = 0; size < 200; ++size) {
+    const buffer buf = random_buffer(gen, size);
+    const std::string encoded = encode_base64(buf);
+    EXPECT_EQ(simple_encode(buf), encoded);
+    EXPECT_EQ(buf, decode_base64(encoded));
+  }
+}
+
+TEST(Base64, InvalidCharsInLongInput)
+{
+  // Invalid chars are decoded as zeros (also in the SIMD version)
+  std::string encoded(64, 'A');
+  encoded[20] = '*';
+  EXPECT_EQ(buffer(48, 0), decode_base64(encoded));
+
+  // Padding in the middle stops the decoding
+  encoded = std::string(64, 'B');
+  encoded[22] = encoded[23] = '=';
+  const buffer decoded = decode_base64(encoded);
+  EXPECT_EQ(16, decoded.size());
+}
+
+TEST(Base64, Streaming)
+{
+  std::mt19937 gen(2);
+  const buffer buf = random_buffer(gen, 1000);
+  const std::string expected = encode_base64(buf);
+
+  for (size_t step : { 1, 2, 3, 5, 64, 100, 1000 }) {
+    base64_encoder encoder;
+    std::string encoded;
+    for (size_t i = 0; i < buf.size(); i += step)
+      encoder.update((const char*)&buf[i], std::min(step, buf.size() - i), encoded);
+    encoder.finish(encoded);
+    EXPECT_EQ(expected, encoded);
+
+    base64_decoder decoder;
+    buffer decoded;
+    for (size_t i = 0; i < encoded.size(); i += step)
+      decoder.update(&encoded[i], std::min(step, encoded.size() - i), decoded);
+    EXPECT_TRUE(decoder.finish());
+    EXPECT_EQ(buf, decoded);
+  }
 }
 
 int main(int argc, char** argv)
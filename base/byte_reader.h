@@ -0,0 +1,183 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_BYTE_READER_H_INCLUDED
+#define BASE_BYTE_READER_H_INCLUDED
+#pragma once
+
+#include "base/buffer.h"
+#include "base/endian.h"
+#include "base/file_view.h"
+#include "base/ints.h"
+
+#include <cstring>
+
+namespace base {
+
+// Reads binary data from a contiguous block of memory (a buffer or
+// a file_view). All reads are bounds-checked: reading past the end
+// returns zeros and sets a sticky error flag (see ok()), so a
+// sequence of reads can be checked only once at the end, e.g.
+//
+//   byte_reader r(file_view("file.bin"));
+//   uint32_t magic = r.read32();
+//   uint16_t count = r.read16();
+//   if (!r.ok()) { ... truncated file ... }
+//
+// Multi-byte values use the byte order given in the constructor
+// (same wire format as base::serialization functions).
+class byte_reader {
+public:
+  byte_reader(const void* data, const size_t size, const endian e = endian::little)
+    : m_begin((const uint8_t*)data)
+    , m_pos((const uint8_t*)data)
+    , m_end((const uint8_t*)data + size)
+    , m_endian(e)
+  {
+  }
+
+  explicit byte_reader(const buffer& buf, const endian e = endian::little)
+    : byte_reader(buf.data(), buf.size(), e)
+  {
+  }
+
+  // The file_view must be alive while the reader is used.
+  explicit byte_reader(const file_view& view, const endian e = endian::little)
+    : byte_reader(view.data(), view.size(), e)
+  {
+  }
+
+  // False if some read failed (not enough data).
+  bool ok() const { return m_ok; }
+
+  size_t size() const { return m_end - m_begin; }
+  size_t position() const { return m_pos - m_begin; }
+  size_t remaining() const { return m_end - m_pos; }
+  bool eof() const { return m_pos == m_end; }
+
+  endian byte_order() const { return m_endian; }
+  void set_byte_order(const endian e) { m_endian = e; }
+
+  // Moves to the given position (from the beginning). Returns false
+  // if the position is out of bounds.
+  bool seek(const size_t pos)
+  {
+    if (pos > size())
+      return fail();
+    m_pos = m_begin + pos;
+    return true;
+  }
+
+  bool skip(const size_t n)
+  {
+    if (n > remaining())
+      return fail();
+    m_pos += n;
+    return true;
+  }
+
+  uint8_t read8() { return read_value<uint8_t>(); }
+  uint16_t read16() { return read_value<uint16_t>(); }
+  uint32_t read32() { return read_value<uint32_t>(); }
+  uint64_t read64() { return read_value<uint64_t>(); }
+
+  float read_float()
+  {
+    const uint32_t v = read32();
+    float f;
+    std::memcpy(&f, &v, sizeof(f));
+    return f;
+  }
+
+  double read_double()
+  {
+    const uint64_t v = read64();
+    double d;
+    std::memcpy(&d, &v, sizeof(d));
+    return d;
+  }
+
+  // Copies "n" bytes to "dst". Returns false (and doesn't read
+  // anything) if there are less than "n" bytes.
+  bool read(void* dst, const size_t n)
+  {
+    const uint8_t* src = read_span(n);
+    if (!src)
+      return false;
+    if (n > 0)
+      std::memcpy(dst, src, n);
+    return true;
+  }
+
+  // Returns a pointer to the next "n" bytes (without copying them)
+  // and skips them, or nullptr if there are less than "n" bytes.
+  const uint8_t* read_span(const size_t n)
+  {
+    if (n > remaining()) {
+      fail();
+      return nullptr;
+    }
+    const uint8_t* p = m_pos;
+    m_pos += n;
+    return p;
+  }
+
+  // Unsigned LEB128 (7 bits per byte, the high bit indicates that
+  // more bytes follow).
+  uint64_t read_varint()
+  {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (m_pos == m_end) {
+        fail();
+        return 0;
+      }
+      const uint8_t b = *(m_pos++);
+      v |= uint64_t(b & 0x7f) << shift;
+      if ((b & 0x80) == 0)
+        return v;
+    }
+    fail(); // More than 10 bytes
+    return 0;
+  }
+
+  // Signed varint (zigzag encoded)
+  int64_t read_varint_signed()
+  {
+    const uint64_t v = read_varint();
+    return int64_t(v >> 1) ^ -int64_t(v & 1);
+  }
+
+private:
+  template<typename T>
+  T read_value()
+  {
+    if (sizeof(T) > remaining()) {
+      fail();
+      m_pos = m_end;
+      return 0;
+    }
+    const T v = load<T>(m_pos, m_endian);
+    m_pos += sizeof(T);
+    return v;
+  }
+
+  bool fail()
+  {
+    m_ok = false;
+    return false;
+  }
+
+  const uint8_t* m_begin;
+  const uint8_t* m_pos;
+  const uint8_t* m_end;
+  endian m_endian;
+  bool m_ok = true;
+};
+
+} // namespace base
+
+#endif
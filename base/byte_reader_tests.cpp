@@ -0,0 +1,165 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/byte_reader.h"
+#include "base/byte_writer.h"
+#include "base/serialization.h"
+
+#include <sstream>
+
+using namespace base;
+
+TEST(ByteReader, ReadValues)
+{
+  const uint8_t data[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+  byte_reader le(data, sizeof(data));
+  EXPECT_EQ(0x01, le.read8());
+  EXPECT_EQ(0x0302, le.read16());
+  EXPECT_EQ(0x07060504, le.read32());
+  EXPECT_EQ(0x0f0e0d0c0b0a0908ULL, le.read64());
+  EXPECT_TRUE(le.eof());
+  EXPECT_TRUE(le.ok());
+
+  byte_reader be(data, sizeof(data), endian::big);
+  EXPECT_EQ(0x01, be.read8());
+  EXPECT_EQ(0x0203, be.read16());
+  EXPECT_EQ(0x04050607, be.read32());
+  EXPECT_EQ(0x08090a0b0c0d0e0fULL, be.read64());
+  EXPECT_TRUE(be.ok());
+}
+
+TEST(ByteReader, BoundsChecks)
+{
+  const uint8_t data[] = { 1, 2, 3 };
+  byte_reader r(data, sizeof(data));
+  EXPECT_EQ(0x0201, r.read16());
+  EXPECT_EQ(0, r.read16()); // Only one byte left
+  EXPECT_FALSE(r.ok());
+  EXPECT_TRUE(r.eof());
+
+  byte_reader r2(data, sizeof(data));
+  uint8_t buf[4];
+  EXPECT_FALSE(r2.read(buf, 4));
+  EXPECT_EQ(0, r2.position());
+  EXPECT_TRUE(r2.read(buf, 3));
+  EXPECT_EQ(3, buf[2]);
+  EXPECT_EQ(nullptr, r2.read_span(1));
+  EXPECT_FALSE(r2.seek(4));
+  EXPECT_TRUE(r2.seek(1));
+  EXPECT_EQ(data + 1, r2.read_span(2));
+  EXPECT_FALSE(r2.ok()); // Error flag is sticky
+}
+
+TEST(ByteReader, Varint)
+{
+  buffer buf;
+  byte_writer w(buf);
+  const uint64_t values[] = { 0, 1, 127, 128, 300, 16384, 0xffffffffULL, ~0ULL };
+  const int64_t svalues[] = { 0, -1, 1, -64, 64, INT64_MIN, INT64_MAX };
+  for (uint64_t v : values)
+    w.write_varint(v);
+  for (int64_t v : svalues)
+    w.write_varint_signed(v);
+
+  EXPECT_EQ(1, buf[1]);
+  EXPECT_EQ(0xAC, buf[5]); // 300 = 0xAC 0x02
+  EXPECT_EQ(0x02, buf[6]);
+
+  byte_reader r(buf);
+  for (uint64_t v : values)
+    EXPECT_EQ(v, r.read_varint());
+  for (int64_t v : svalues)
+    EXPECT_EQ(v, r.read_varint_signed());
+  EXPECT_TRUE(r.eof());
+  EXPECT_TRUE(r.ok());
+
+  // Truncated varint
+  const uint8_t bad[] = { 0x80, 0x80 };
+  byte_reader r2(bad, sizeof(bad));
+  EXPECT_EQ(0, r2.read_varint());
+  EXPECT_FALSE(r2.ok());
+}
+
+TEST(ByteWriter, SameFormatAsSerialization)
+{
+  for (endian e : { endian::little, endian::big }) {
+    buffer buf;
+    byte_writer w(buf, e);
+    w.write8(0x12);
+    w.write16(0x3456);
+    w.write32(0x789abcde);
+    w.write64(0x0123456789abcdefULL);
+    w.write_float(1.5f);
+    w.write_double(-2.25);
+
+    std::stringstream s;
+    serialization::write8(s, 0x12);
+    if (e == endian::little) {
+      using namespace serialization::little_endian;
+      write16(s, 0x3456);
+      write32(s, 0x789abcde);
+      write64(s, 0x0123456789abcdefULL);
+      write_float(s, 1.5f);
+      write_double(s, -2.25);
+    }
+    else {
+      using namespace serialization::big_endian;
+      write16(s, 0x3456);
+      write32(s, 0x789abcde);
+      write64(s, 0x0123456789abcdefULL);
+      write_float(s, 1.5f);
+      write_double(s, -2.25);
+    }
+    const std::string str = s.str();
+    EXPECT_EQ(buffer(str.begin(), str.end()), buf);
+
+    byte_reader r(buf, e);
+    EXPECT_EQ(0x12, r.read8());
+    EXPECT_EQ(0x3456, r.read16());
+    EXPECT_EQ(0x789abcde, r.read32());
+    EXPECT_EQ(0x0123456789abcdefULL, r.read64());
+    EXPECT_EQ(1.5f, r.read_float());
+    EXPECT_EQ(-2.25, r.read_double());
+
+    s.seekg(0);
+    EXPECT_EQ(0x12, serialization::read8(s));
+    if (e == endian::little) {
+      using namespace serialization::little_endian;
+      EXPECT_EQ(0x3456, read16(s));
+      EXPECT_EQ(0x789abcde, read32(s));
+      EXPECT_EQ(0x0123456789abcdefULL, read64(s));
+      EXPECT_EQ(1.5f, read_float(s));
+      EXPECT_EQ(-2.25, read_double(s));
+    }
+    else {
+      using namespace serialization::big_endian;
+      EXPECT_EQ(0x3456, read16(s));
+      EXPECT_EQ(0x789abcde, read32(s));
+      EXPECT_EQ(0x0123456789abcdefULL, read64(s));
+      EXPECT_EQ(1.5f, read_float(s));
+      EXPECT_EQ(-2.25, read_double(s));
+    }
+  }
+}
+
+TEST(ByteWriter, WriteAt)
+{
+  buffer buf;
+  byte_writer w(buf, endian::big);
+  w.write32(0);
+  w.write("abc", 3);
+  w.write32_at(0, uint32_t(w.position()));
+  EXPECT_EQ(buffer({ 0, 0, 0, 7, 'a', 'b', 'c' }), buf);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,120 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_BYTE_WRITER_H_INCLUDED
+#define BASE_BYTE_WRITER_H_INCLUDED
+#pragma once
+
+#include "base/buffer.h"
+#include "base/debug.h"
+#include "base/endian.h"
+#include "base/ints.h"
+
+#include <cstring>
+
+namespace base {
+
+// Appends binary data at the end of a buffer. Multi-byte values use
+// the byte order given in the constructor (same wire format as
+// base::serialization functions), e.g.
+//
+//   buffer buf;
+//   byte_writer w(buf);
+//   w.write32(magic);
+//   const size_t sizePos = w.position();
+//   w.write32(0);
+//   ...
+//   w.write32_at(sizePos, w.position() - sizePos);
+//   write_file_content(filename, buf);
+class byte_writer {
+public:
+  explicit byte_writer(buffer& buf, const endian e = endian::little) : m_buf(buf), m_endian(e) {}
+
+  size_t position() const { return m_buf.size(); }
+
+  endian byte_order() const { return m_endian; }
+  void set_byte_order(const endian e) { m_endian = e; }
+
+  // Reserves space for "n" more bytes (to avoid reallocations when
+  // the final size is known).
+  void reserve(const size_t n) { m_buf.reserve(m_buf.size() + n); }
+
+  void write8(const uint8_t v) { m_buf.push_back(v); }
+  void write16(const uint16_t v) { write_value(v); }
+  void write32(const uint32_t v) { write_value(v); }
+  void write64(const uint64_t v) { write_value(v); }
+
+  void write_float(const float f)
+  {
+    uint32_t v;
+    std::memcpy(&v, &f, sizeof(v));
+    write32(v);
+  }
+
+  void write_double(const double d)
+  {
+    uint64_t v;
+    std::memcpy(&v, &d, sizeof(v));
+    write64(v);
+  }
+
+  void write(const void* data, const size_t n)
+  {
+    if (n > 0) {
+      const size_t pos = m_buf.size();
+      m_buf.resize(pos + n);
+      std::memcpy(&m_buf[pos], data, n);
+    }
+  }
+
+  // Overwrites a value that was already written (e.g. a size that
+  // is known only after writing the data).
+  void write16_at(const size_t pos, const uint16_t v) { write_value_at(pos, v); }
+  void write32_at(const size_t pos, const uint32_t v) { write_value_at(pos, v); }
+  void write64_at(const size_t pos, const uint64_t v) { write_value_at(pos, v); }
+
+  // Unsigned LEB128 (see byte_reader::read_varint())
+  void write_varint(uint64_t v)
+  {
+    uint8_t tmp[10];
+    size_t n = 0;
+    while (v >= 0x80) {
+      tmp[n++] = uint8_t(v | 0x80);
+      v >>= 7;
+    }
+    tmp[n++] = uint8_t(v);
+    write(tmp, n);
+  }
+
+  // Signed varint (zigzag encoded)
+  void write_varint_signed(const int64_t v)
+  {
+    write_varint((uint64_t(v) << 1) ^ uint64_t(v >> 63));
+  }
+
+private:
+  template<typename T>
+  void write_value(const T v)
+  {
+    const size_t pos = m_buf.size();
+    m_buf.resize(pos + sizeof(T));
+    store<T>(&m_buf[pos], v, m_endian);
+  }
+
+  template<typename T>
+  void write_value_at(const size_t pos, const T v)
+  {
+    ASSERT(pos + sizeof(T) <= m_buf.size());
+    store<T>(&m_buf[pos], v, m_endian);
+  }
+
+  buffer& m_buf;
+  endian m_endian;
+};
+
+} // namespace base
+
+#endif
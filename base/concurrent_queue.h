@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2019-2022 Igara Studio S.A.
+// Copyright (c) 2019-2025 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,14 +9,35 @@
 #define BASE_CONCURRENT_QUEUE_H_INCLUDED
 #pragma once
 
+#include "base/mpmc_queue.h"
+
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <mutex>
 
 namespace base {
 
+// Thread-safe queue. The Capacity template parameter selects the
+// implementation:
+//
+// * Capacity == 0 (default): unbounded queue, a std::deque protected
+//   by a mutex. try_pop() can fail if the mutex is locked by other
+//   thread (so it never blocks the caller).
+//
+// * Capacity > 0: lock-free bounded ring buffer (see mpmc_queue).
+//   Capacity must be a power of two, push() waits while the queue is
+//   full, and prioritize() is not available.
+//
+template<typename T, size_t Capacity = 0>
+class concurrent_queue : public mpmc_queue<T, Capacity> {
+public:
+  concurrent_queue() {}
+};
+
 template<typename T>
-class concurrent_queue {
+class concurrent_queue<T, 0> {
 public:
   concurrent_queue() {}
   concurrent_queue(const concurrent_queue&) = delete;
@@ -53,6 +74,7 @@ public:
   {
     const std::lock_guard lock(m_mutex);
     m_queue.push_back(value);
+    m_cv.notify_one();
   }
 
   bool try_pop(T& value)
@@ -69,6 +91,22 @@ public:
     return true;
   }
 
+  // Waits until there is an element to pop or the timeout (in
+  // seconds) is reached. Returns false in case of timeout.
+  bool pop(T& value, const double timeout)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_cv.wait_for(lock, std::chrono::duration<double>(timeout), [this] {
+          return !m_queue.empty();
+        })) {
+      return false;
+    }
+
+    value = m_queue.front();
+    m_queue.pop_front();
+    return true;
+  }
+
   template<typename UnaryPredicate>
   void prioritize(UnaryPredicate p)
   {
@@ -85,6 +123,7 @@ public:
 private:
   std::deque<T> m_queue;
   mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
 };
 
 } // namespace base
@@ -0,0 +1,132 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/chrono.h"
+#include "base/concurrent_queue.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace base;
+
+template<typename Queue>
+void test_basic()
+{
+  Queue q;
+  EXPECT_TRUE(q.empty());
+  q.push(1);
+  q.push(2);
+  EXPECT_FALSE(q.empty());
+  EXPECT_EQ(2, q.size());
+
+  int v = 0;
+  EXPECT_TRUE(q.try_pop(v));
+  EXPECT_EQ(1, v);
+  EXPECT_TRUE(q.pop(v, 0.0));
+  EXPECT_EQ(2, v);
+  EXPECT_FALSE(q.try_pop(v));
+  EXPECT_FALSE(q.pop(v, 0.01));
+  EXPECT_TRUE(q.empty());
+}
+
+// Pushes "n" values from each producer thread and pops them from one
+// consumer thread. Returns the elapsed time in seconds.
+template<typename Queue>
+double test_producers(const int producers, const int n)
+{
+  Queue q;
+  std::vector<std::thread> threads;
+  Chrono chrono;
+  for (int i = 0; i < producers; ++i) {
+    threads.emplace_back([&q, n] {
+      for (int j = 1; j <= n; ++j)
+        q.push(j);
+    });
+  }
+
+  int64_t sum = 0;
+  for (int i = 0; i < producers * n;) {
+    int v;
+    if (q.pop(v, 1.0)) {
+      sum += v;
+      ++i;
+    }
+  }
+  const double t = chrono.elapsed();
+
+  for (auto& t : threads)
+    t.join();
+  EXPECT_EQ(int64_t(producers) * n * (n + 1) / 2, sum);
+  EXPECT_TRUE(q.empty());
+  return t;
+}
+
+TEST(ConcurrentQueue, Locked)
+{
+  test_basic<concurrent_queue<int>>();
+}
+
+TEST(ConcurrentQueue, LockFree)
+{
+  test_basic<concurrent_queue<int, 4>>();
+}
+
+TEST(ConcurrentQueue, LockFreeFull)
+{
+  concurrent_queue<std::string, 2> q;
+  EXPECT_TRUE(q.try_push("a"));
+  EXPECT_TRUE(q.try_push("b"));
+  EXPECT_FALSE(q.try_push("c"));
+
+  std::string v;
+  EXPECT_TRUE(q.try_pop(v));
+  EXPECT_EQ("a", v);
+  EXPECT_TRUE(q.try_push("c"));
+  EXPECT_TRUE(q.try_pop(v));
+  EXPECT_EQ("b", v);
+  EXPECT_TRUE(q.try_pop(v));
+  EXPECT_EQ("c", v);
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(ConcurrentQueue, PopWaits)
+{
+  concurrent_queue<int, 16> q;
+  std::thread t([&q] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    q.push(5);
+  });
+  int v = 0;
+  EXPECT_TRUE(q.pop(v, 10.0));
+  EXPECT_EQ(5, v);
+  t.join();
+}
+
+// Contention with 1 to 16 producers and one consumer. Disabled as
+// it's only a benchmark (run with --gtest_also_run_disabled_tests).
+TEST(ConcurrentQueue, DISABLED_Contention)
+{
+  const int n = 20000;
+  for (int producers = 1; producers <= 16; producers *= 2) {
+    const double t0 = test_producers<concurrent_queue<int>>(producers, n);
+    const double t1 = test_producers<concurrent_queue<int, 1024>>(producers, n);
+    std::printf("%2d producers: locked %.0f items/sec, lock-free %.0f items/sec\n",
+                producers,
+                producers * n / t0,
+                producers * n / t1);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
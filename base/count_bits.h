@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2023 Igara Studio S.A.
+// Copyright (c) 2023-2025 Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -9,8 +9,13 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 
+#ifdef _MSC_VER
+  #include <intrin.h>
+#endif
+
 namespace base {
 
 template<typename T>
@@ -24,6 +29,19 @@ constexpr inline size_t count_bits(const T v)
   return n;
 }
 
+// Returns the index of the least significant bit set (v cannot be
+// zero).
+inline int count_trailing_zeros(const uint32_t v)
+{
+#ifdef _MSC_VER
+  unsigned long i;
+  _BitScanForward(&i, v);
+  return int(i);
+#else
+  return __builtin_ctz(v);
+#endif
+}
+
 } // namespace base
 
 #endif
@@ -0,0 +1,88 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/cpu_features.h"
+
+#if LAF_CPU_X86
+  #ifdef _MSC_VER
+    #include <immintrin.h>
+    #include <intrin.h>
+  #else
+    #include <cpuid.h>
+  #endif
+#endif
+
+namespace base {
+
+namespace {
+
+#if LAF_CPU_X86
+
+void cpuid(const int leaf, unsigned int regs[4])
+{
+  #ifdef _MSC_VER
+  int info[4];
+  __cpuidex(info, leaf, 0);
+  for (int i = 0; i < 4; ++i)
+    regs[i] = unsigned(info[i]);
+  #else
+  __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+  #endif
+}
+
+// Returns true if the OS saves the AVX registers (XCR0 bits 1 and 2)
+bool os_supports_avx()
+{
+  #ifdef _MSC_VER
+  const unsigned long long xcr0 = _xgetbv(0);
+  #else
+  unsigned int eax, edx;
+  __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  const unsigned long long xcr0 = ((unsigned long long)edx << 32) | eax;
+  #endif
+  return (xcr0 & 6) == 6;
+}
+
+#endif
+
+cpu_features detect_cpu_features()
+{
+  cpu_features f;
+#if LAF_CPU_X86
+  unsigned int regs[4];
+  cpuid(0, regs);
+  const unsigned int maxLeaf = regs[0];
+  if (maxLeaf < 1)
+    return f;
+
+  cpuid(1, regs);
+  f.ssse3 = (regs[2] & (1 << 9)) != 0;
+  f.sse41 = (regs[2] & (1 << 19)) != 0;
+  const bool osxsave = (regs[2] & (1 << 27)) != 0;
+  const bool avx = (regs[2] & (1 << 28)) != 0;
+
+  if (maxLeaf >= 7) {
+    cpuid(7, regs);
+    f.avx2 = avx && osxsave && (regs[1] & (1 << 5)) != 0 && os_supports_avx();
+    f.sha = (regs[1] & (1 << 29)) != 0;
+  }
+#endif
+  return f;
+}
+
+} // anonymous namespace
+
+const cpu_features& get_cpu_features()
+{
+  static const cpu_features features = detect_cpu_features();
+  return features;
+}
+
+} // namespace base
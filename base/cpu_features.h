@@ -0,0 +1,38 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_CPU_FEATURES_H_INCLUDED
+#define BASE_CPU_FEATURES_H_INCLUDED
+#pragma once
+
+// LAF_CPU_X86 is defined on x86/x64 CPUs, where we can use SIMD
+// intrinsics (from <immintrin.h>) in functions marked with
+// LAF_TARGET("...") and call them only when get_cpu_features()
+// reports that the instructions are available.
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+  #define LAF_CPU_X86 1
+  #ifdef _MSC_VER
+    #define LAF_TARGET(features)
+  #else
+    #define LAF_TARGET(features) __attribute__((target(features)))
+  #endif
+#endif
+
+namespace base {
+
+struct cpu_features {
+  bool ssse3 = false;
+  bool sse41 = false;
+  bool avx2 = false;
+  bool sha = false; // SHA extensions (SHA-NI)
+};
+
+// Returns the features of the CPU (detected only once).
+const cpu_features& get_cpu_features();
+
+} // namespace base
+
+#endif
@@ -0,0 +1,127 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_ENDIAN_H_INCLUDED
+#define BASE_ENDIAN_H_INCLUDED
+#pragma once
+
+#include "base/config.h"
+#include "base/ints.h"
+
+#include <cstring>
+
+#ifdef _MSC_VER
+  #include <stdlib.h>
+#endif
+
+namespace base {
+
+enum class endian { little, big };
+
+inline uint16_t bswap16(const uint16_t v)
+{
+#ifdef _MSC_VER
+  return _byteswap_ushort(v);
+#else
+  return __builtin_bswap16(v);
+#endif
+}
+
+inline uint32_t bswap32(const uint32_t v)
+{
+#ifdef _MSC_VER
+  return _byteswap_ulong(v);
+#else
+  return __builtin_bswap32(v);
+#endif
+}
+
+inline uint64_t bswap64(const uint64_t v)
+{
+#ifdef _MSC_VER
+  return _byteswap_uint64(v);
+#else
+  return __builtin_bswap64(v);
+#endif
+}
+
+inline uint8_t bswap(const uint8_t v)
+{
+  return v;
+}
+inline uint16_t bswap(const uint16_t v)
+{
+  return bswap16(v);
+}
+inline uint32_t bswap(const uint32_t v)
+{
+  return bswap32(v);
+}
+inline uint64_t bswap(const uint64_t v)
+{
+  return bswap64(v);
+}
+
+// Loads/stores an unsigned integer (uint8_t to uint64_t) from/to
+// unaligned memory with the given byte order.
+template<typename T>
+inline T load_le(const void* p)
+{
+  T v;
+  std::memcpy(&v, p, sizeof(T));
+#ifdef LAF_BIG_ENDIAN
+  v = bswap(v);
+#endif
+  return v;
+}
+
+template<typename T>
+inline T load_be(const void* p)
+{
+  T v;
+  std::memcpy(&v, p, sizeof(T));
+#ifndef LAF_BIG_ENDIAN
+  v = bswap(v);
+#endif
+  return v;
+}
+
+template<typename T>
+inline void store_le(void* p, T v)
+{
+#ifdef LAF_BIG_ENDIAN
+  v = bswap(v);
+#endif
+  std::memcpy(p, &v, sizeof(T));
+}
+
+template<typename T>
+inline void store_be(void* p, T v)
+{
+#ifndef LAF_BIG_ENDIAN
+  v = bswap(v);
+#endif
+  std::memcpy(p, &v, sizeof(T));
+}
+
+template<typename T>
+inline T load(const void* p, const endian e)
+{
+  return (e == endian::little ? load_le<T>(p) : load_be<T>(p));
+}
+
+template<typename T>
+inline void store(void* p, const T v, const endian e)
+{
+  if (e == endian::little)
+    store_le<T>(p, v);
+  else
+    store_be<T>(p, v);
+}
+
+} // namespace base
+
+#endif
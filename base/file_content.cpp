@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2018-2022  Igara Studio S.A.
+// Copyright (C) 2018-2025  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -25,21 +25,41 @@ namespace base {
 
 const size_t kChunkSize = 1024 * 64; // 64k
 
+// Returns the number of bytes from the current position to the end
+// of the file, or 0 if the file is not seekable (e.g. a pipe).
+static size_t remaining_file_size(FILE* file)
+{
+  const long pos = std::ftell(file);
+  if (pos < 0 || std::fseek(file, 0, SEEK_END) != 0)
+    return 0;
+
+  const long end = std::ftell(file);
+  std::fseek(file, pos, SEEK_SET);
+  return (end > pos ? size_t(end - pos) : 0);
+}
+
 buffer read_file_content(FILE* file)
 {
   buffer buf;
   size_t pos = 0;
 
+  // Allocate the whole file at once when we know its size (+1 byte
+  // to detect the EOF without resizing the buffer), in other case
+  // the buffer grows geometrically.
+  size_t chunk = remaining_file_size(file) + 1;
+  if (chunk == 1)
+    chunk = kChunkSize;
+
   while (std::feof(file) == 0) {
-    buf.resize(buf.size() + kChunkSize);
-    const size_t read_bytes = std::fread(&buf[pos], 1, kChunkSize, file);
+    buf.resize(pos + chunk);
+    const size_t read_bytes = std::fread(&buf[pos], 1, chunk, file);
     pos += read_bytes;
-    if (read_bytes < kChunkSize) {
-      buf.resize(pos);
+    if (read_bytes < chunk)
       break;
-    }
+    chunk = std::max(kChunkSize, buf.size());
   }
 
+  buf.resize(pos);
   return buf;
 }
 
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2020-2024 Igara Studio S.A.
+// Copyright (c) 2020-2025 Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,13 +11,21 @@
 
 #include "base/file_handle.h"
 
+#include "base/fs.h"
+#include "base/process.h"
 #include "base/string.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <stdexcept>
+#include <vector>
 
 #if LAF_WINDOWS
   #include <io.h>
   #include <windows.h>
+#else
+  #include <unistd.h>
 #endif
 
 #include <fcntl.h>
@@ -38,6 +46,8 @@ static void fclose_if_valid(FILE* f)
     fclose(f);
 }
 
+static std::atomic<unsigned> temp_file_counter(0);
+
 static void throw_cannot_open_exception(const string& filename, const string& mode)
 {
   if (mode.find('w') != string::npos)
@@ -133,4 +143,210 @@ void close_file_and_sync(FILE* file)
   fclose(file);
 }
 
+// Syncs the data of the given file to disk (not its metadata, the
+// file is renamed and its directory synced after this).
+static bool sync_file_data(int fd)
+{
+#if LAF_WINDOWS
+  HANDLE handle = (HANDLE)_get_osfhandle(fd);
+  return (handle != INVALID_HANDLE_VALUE && FlushFileBuffers(handle));
+#elif LAF_LINUX
+  return (fdatasync(fd) == 0);
+#else
+  return (fsync(fd) == 0);
+#endif
+}
+
+// Starts writing the file data to disk without waiting, so the
+// writeback of several files is done in parallel before we wait
+// each one with sync_file_data().
+static void start_file_writeback(int fd)
+{
+#if LAF_LINUX
+  sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WRITE);
+#else
+  (void)fd;
+#endif
+}
+
+static bool sync_directory(const string& path)
+{
+#if LAF_WINDOWS
+  // Directories cannot be synced on Windows, the rename is written
+  // to disk with MOVEFILE_WRITE_THROUGH.
+  (void)path;
+  return true;
+#else
+  int fd = open(path.empty() ? "." : path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+  // Some file systems don't support syncing directories
+  bool ok = (fsync(fd) == 0 || errno == EINVAL);
+  close(fd);
+  return ok;
+#endif
+}
+
+static bool replace_file(const string& from, const string& to, const bool durable)
+{
+#if LAF_WINDOWS
+  return MoveFileExW(from_utf8(from).c_str(),
+                     from_utf8(to).c_str(),
+                     MOVEFILE_REPLACE_EXISTING | (durable ? MOVEFILE_WRITE_THROUGH : 0)) != 0;
+#else
+  (void)durable;
+  return (rename(from.c_str(), to.c_str()) == 0);
+#endif
+}
+
+atomic_file::atomic_file(const string& filename, const bool durable)
+  : m_filename(filename)
+  , m_durable(durable)
+{
+  const string prefix = filename + "." + std::to_string(get_current_process_id()) + "-";
+  int fd;
+  for (int tries = 0;; ++tries) {
+    m_tmpname = prefix + std::to_string(++temp_file_counter) + ".tmp";
+#if LAF_WINDOWS
+    fd = _wopen(from_utf8(m_tmpname).c_str(),
+                _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY,
+                _S_IREAD | _S_IWRITE);
+#else
+    fd = open(m_tmpname.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+#endif
+    if (fd >= 0)
+      break;
+    if (errno != EEXIST || tries == 100) {
+      m_tmpname.clear();
+      throw_cannot_open_exception(filename, "wb");
+    }
+  }
+
+#if !LAF_WINDOWS
+  // Keep the permissions of the file that we are replacing
+  struct stat st;
+  if (stat(filename.c_str(), &st) == 0)
+    fchmod(fd, st.st_mode & 07777);
+#endif
+
+#if LAF_WINDOWS
+  m_file = _fdopen(fd, "wb");
+#else
+  m_file = fdopen(fd, "wb");
+#endif
+  if (!m_file) {
+#if LAF_WINDOWS
+    _close(fd);
+#else
+    close(fd);
+#endif
+    discard();
+    throw_cannot_open_exception(filename, "wb");
+  }
+}
+
+atomic_file::~atomic_file()
+{
+  discard();
+}
+
+void atomic_file::commit()
+{
+  atomic_file* file = this;
+  commit_files(&file, 1);
+}
+
+void atomic_file::discard()
+{
+  if (m_file) {
+    fclose(m_file);
+    m_file = nullptr;
+  }
+  if (!m_tmpname.empty()) {
+#if LAF_WINDOWS
+    _wremove(from_utf8(m_tmpname).c_str());
+#else
+    remove(m_tmpname.c_str());
+#endif
+    m_tmpname.clear();
+  }
+}
+
+// static
+void atomic_file::commit_files(atomic_file* const* files, const size_t n)
+{
+  auto fail = [](atomic_file* file) {
+    file->discard();
+    throw std::runtime_error("Cannot save file " + file->m_filename);
+  };
+
+  // Flush all files first and start their writeback, then wait each
+  // one (the disk can write all of them at the same time).
+  for (size_t i = 0; i < n; ++i) {
+    atomic_file* file = files[i];
+    if (!file->m_file || fflush(file->m_file) != 0 || ferror(file->m_file))
+      fail(file);
+    if (file->m_durable)
+      start_file_writeback(fileno(file->m_file));
+  }
+  for (size_t i = 0; i < n; ++i) {
+    atomic_file* file = files[i];
+    if (file->m_durable && !sync_file_data(fileno(file->m_file)))
+      fail(file);
+  }
+
+  // Replace the files and sync each directory only once
+  std::vector<string> dirs;
+  for (size_t i = 0; i < n; ++i) {
+    atomic_file* file = files[i];
+    const int res = fclose(file->m_file);
+    file->m_file = nullptr;
+    if (res != 0 || !replace_file(file->m_tmpname, file->m_filename, file->m_durable))
+      fail(file);
+    file->m_tmpname.clear();
+    if (file->m_durable)
+      dirs.push_back(get_file_path(file->m_filename));
+  }
+
+  std::sort(dirs.begin(), dirs.end());
+  dirs.erase(std::unique(dirs.begin(), dirs.end()), dirs.end());
+  for (const string& dir : dirs) {
+    if (!sync_directory(dir))
+      throw std::runtime_error("Cannot sync directory " + dir);
+  }
+}
+
+atomic_file_batch::atomic_file_batch(const bool durable) : m_durable(durable)
+{
+}
+
+atomic_file_batch::~atomic_file_batch()
+{
+  discard();
+}
+
+FILE* atomic_file_batch::add(const string& filename)
+{
+  m_files.push_back(std::make_unique<atomic_file>(filename, m_durable));
+  return m_files.back()->handle();
+}
+
+void atomic_file_batch::commit()
+{
+  std::vector<atomic_file*> files(m_files.size());
+  for (size_t i = 0; i < m_files.size(); ++i)
+    files[i] = m_files[i].get();
+
+  // Destroying the files deletes the temporary files that were not
+  // renamed (e.g. if there was an error).
+  auto files_to_destroy = std::move(m_files);
+  m_files.clear();
+  atomic_file::commit_files(files.data(), files.size());
+}
+
+void atomic_file_batch::discard()
+{
+  m_files.clear();
+}
+
 } // namespace base
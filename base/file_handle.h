@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2020-2024 Igara Studio S.A.
+// Copyright (c) 2020-2025 Igara Studio S.A.
 // Copyright (c) 2001-2018 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,9 +9,12 @@
 #define BASE_FILE_HANDLE_H_INCLUDED
 #pragma once
 
+#include "base/disable_copying.h"
+
 #include <cstdio>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace base {
 
@@ -27,6 +30,75 @@ int open_file_descriptor_with_exception(const std::string& filename, const std::
 void sync_file_descriptor(int fd);
 void close_file_and_sync(FILE* file);
 
+// Replaces a file atomically: the content is written in a temporary
+// file in the same directory which is renamed to the final name in
+// commit(), so other processes (or the user after a crash) see the
+// old file or the new complete file, never a partially written one.
+// If commit() is not called, the temporary file is deleted.
+//
+// When "durable" is true, commit() syncs the file data before the
+// rename and the directory after it, so the new file survives a
+// power loss. Throws std::runtime_error if something fails.
+//
+//   base::atomic_file file(filename);
+//   fwrite(data, 1, size, file.handle());
+//   file.commit();
+//
+class atomic_file {
+public:
+  explicit atomic_file(const std::string& filename, bool durable = true);
+  ~atomic_file();
+
+  FILE* handle() const { return m_file; }
+  const std::string& filename() const { return m_filename; }
+  const std::string& temp_filename() const { return m_tmpname; }
+  bool durable() const { return m_durable; }
+
+  void commit();
+  void discard();
+
+private:
+  friend class atomic_file_batch;
+  static void commit_files(atomic_file* const* files, size_t n);
+
+  std::string m_filename;
+  std::string m_tmpname;
+  FILE* m_file = nullptr;
+  bool m_durable;
+
+  DISABLE_COPYING(atomic_file);
+};
+
+// Group commit of several atomic files (e.g. a document saved in
+// several small files): the writeback of all files is started
+// together, and each directory is synced only once after all
+// renames, instead of paying a full sync for each file. Each file is
+// replaced atomically, but not the group as a whole (a crash in the
+// middle of commit() can leave some files renamed and others not).
+class atomic_file_batch {
+public:
+  explicit atomic_file_batch(bool durable = true);
+  ~atomic_file_batch();
+
+  // Creates the temporary file to write the given file, the returned
+  // FILE* is valid until commit() or discard() are called.
+  FILE* add(const std::string& filename);
+
+  size_t size() const { return m_files.size(); }
+  bool empty() const { return m_files.empty(); }
+
+  // Replaces all the files. If an error is found, the remaining
+  // temporary files are deleted and an exception is thrown.
+  void commit();
+  void discard();
+
+private:
+  std::vector<std::unique_ptr<atomic_file>> m_files;
+  bool m_durable;
+
+  DISABLE_COPYING(atomic_file_batch);
+};
+
 } // namespace base
 
 #endif
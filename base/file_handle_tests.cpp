@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -6,6 +7,7 @@
 
 #include <gtest/gtest.h>
 
+#include "base/file_content.h"
 #include "base/file_handle.h"
 #include "base/fs.h"
 
@@ -60,6 +62,77 @@ TEST(FileHandle, Descriptors)
   ASSERT_NO_THROW({ delete_file(fn); });
 }
 
+static std::string read_text(const std::string& fn)
+{
+  buffer buf = read_file_content(fn);
+  return std::string(buf.begin(), buf.end());
+}
+
+TEST(FileHandle, AtomicFile)
+{
+  const char* fn = "atomic.txt";
+  write_file_content(fn, (const uint8_t*)"old", 3);
+
+  // The file isn't modified until commit()
+  {
+    atomic_file file(fn);
+    EXPECT_TRUE(is_file(file.temp_filename()));
+    fputs("new content", file.handle());
+    fflush(file.handle());
+    EXPECT_EQ("old", read_text(fn));
+
+    const std::string tmp = file.temp_filename();
+    file.commit();
+    EXPECT_FALSE(is_file(tmp));
+    EXPECT_EQ("new content", read_text(fn));
+  }
+
+  // Without commit() the temporary file is deleted
+  std::string tmp;
+  {
+    atomic_file file(fn, false);
+    tmp = file.temp_filename();
+    fputs("discarded", file.handle());
+  }
+  EXPECT_FALSE(is_file(tmp));
+  EXPECT_EQ("new content", read_text(fn));
+
+  delete_file(fn);
+
+  // Cannot create files in a non-existent directory
+  EXPECT_THROW({ atomic_file file(join_path("non-existent-dir", "file")); }, std::runtime_error);
+}
+
+TEST(FileHandle, AtomicFileBatch)
+{
+  make_directory("batch");
+
+  std::vector<std::string> fns;
+  for (int i = 0; i < 16; ++i)
+    fns.push_back(join_path("batch", "file" + std::to_string(i)));
+
+  atomic_file_batch batch;
+  for (const auto& fn : fns)
+    fputs(fn.c_str(), batch.add(fn));
+  EXPECT_EQ(16, batch.size());
+  EXPECT_EQ(16, list_files("batch").size()); // Only temporary files
+
+  batch.commit();
+  EXPECT_TRUE(batch.empty());
+  EXPECT_EQ(16, list_files("batch").size());
+  for (const auto& fn : fns) {
+    EXPECT_EQ(fn, read_text(fn));
+    delete_file(fn);
+  }
+
+  // Discarded batch
+  batch.add(fns[0]);
+  batch.discard();
+  EXPECT_TRUE(list_files("batch").empty());
+
+  remove_directory("batch");
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,199 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/file_view.h"
+
+#include "base/file_content.h"
+#include "base/file_handle.h"
+
+#if LAF_WINDOWS
+  #include "base/string.h"
+
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace base {
+
+file_view::file_view()
+{
+}
+
+file_view::file_view(const std::string& filename)
+{
+  open(filename);
+}
+
+file_view::file_view(file_view&& other)
+{
+  *this = std::move(other);
+}
+
+file_view& file_view::operator=(file_view&& other)
+{
+  if (this != &other) {
+    close();
+    m_open = other.m_open;
+    m_mapped = other.m_mapped;
+    m_size = other.m_size;
+    m_buffer = std::move(other.m_buffer);
+    m_data = (m_mapped ? other.m_data : (m_buffer.empty() ? nullptr : m_buffer.data()));
+
+    other.m_open = false;
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_mapped = nullptr;
+  }
+  return *this;
+}
+
+file_view::~file_view()
+{
+  close();
+}
+
+bool file_view::open(const std::string& filename)
+{
+  close();
+
+  if (map_file(filename)) {
+    m_open = true;
+    return true;
+  }
+
+  // Fallback to read the whole file
+  const FileHandle f(open_file(filename, "rb"));
+  if (!f)
+    return false;
+
+  m_buffer = read_file_content(f.get());
+  m_data = (m_buffer.empty() ? nullptr : m_buffer.data());
+  m_size = m_buffer.size();
+  m_open = true;
+  return true;
+}
+
+void file_view::close()
+{
+  unmap_file();
+  m_buffer.clear();
+  m_buffer.shrink_to_fit();
+  m_open = false;
+  m_data = nullptr;
+  m_size = 0;
+}
+
+#if LAF_WINDOWS
+
+bool file_view::map_file(const std::string& filename)
+{
+  HANDLE handle = CreateFileW(from_utf8(filename).c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                              nullptr);
+  if (handle == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(handle, &size) || uint64_t(size.QuadPart) > uint64_t(SIZE_MAX)) {
+    CloseHandle(handle);
+    return false;
+  }
+
+  // Empty files cannot be mapped
+  if (size.QuadPart == 0) {
+    CloseHandle(handle);
+    return true;
+  }
+
+  HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(handle);
+  if (!mapping)
+    return false;
+
+  // The view keeps a reference to the mapping object
+  void* ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (!ptr)
+    return false;
+
+  m_mapped = ptr;
+  m_data = (const uint8_t*)ptr;
+  m_size = size_t(size.QuadPart);
+  return true;
+}
+
+void file_view::unmap_file()
+{
+  if (m_mapped) {
+    UnmapViewOfFile(m_mapped);
+    m_mapped = nullptr;
+  }
+}
+
+#else
+
+bool file_view::map_file(const std::string& filename)
+{
+  const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+
+  // Only regular files can be mapped
+  struct stat sb;
+  if (fstat(fd, &sb) != 0 || !S_ISREG(sb.st_mode) || uint64_t(sb.st_size) > uint64_t(SIZE_MAX)) {
+    ::close(fd);
+    return false;
+  }
+
+  // Empty files cannot be mapped
+  if (sb.st_size == 0) {
+    ::close(fd);
+    return true;
+  }
+
+  const size_t size = size_t(sb.st_size);
+  void* ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // The mapping keeps a reference to the file
+  if (ptr == MAP_FAILED)
+    return false;
+
+  #ifdef MADV_SEQUENTIAL
+  // Files are usually read from the beginning to the end (decoding
+  // or hashing), so the kernel can read ahead more pages.
+  madvise(ptr, size, MADV_SEQUENTIAL);
+  #endif
+
+  m_mapped = ptr;
+  m_data = (const uint8_t*)ptr;
+  m_size = size;
+  return true;
+}
+
+void file_view::unmap_file()
+{
+  if (m_mapped) {
+    munmap(m_mapped, m_size);
+    m_mapped = nullptr;
+  }
+}
+
+#endif
+
+} // namespace base
@@ -0,0 +1,66 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_FILE_VIEW_H_INCLUDED
+#define BASE_FILE_VIEW_H_INCLUDED
+#pragma once
+
+#include "base/buffer.h"
+#include "base/disable_copying.h"
+#include "base/ints.h"
+
+#include <string>
+
+namespace base {
+
+// Read-only view of the whole content of a file. The file is mapped
+// in memory when possible (mmap() or MapViewOfFile()), so it's not
+// copied and only the accessed pages are read from disk. If the file
+// cannot be mapped (e.g. it's a pipe), the content is read in a
+// buffer.
+//
+// The data is valid until the file_view is closed/destroyed.
+class file_view {
+public:
+  file_view();
+  explicit file_view(const std::string& filename);
+  file_view(file_view&& other);
+  file_view& operator=(file_view&& other);
+  ~file_view();
+
+  // Returns false if the file cannot be opened.
+  bool open(const std::string& filename);
+  void close();
+
+  bool is_open() const { return m_open; }
+
+  // True if the file is mapped in memory, false if it was read in a
+  // buffer (or it's not open).
+  bool is_mapped() const { return m_mapped != nullptr; }
+
+  const uint8_t* data() const { return m_data; }
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  const uint8_t* begin() const { return m_data; }
+  const uint8_t* end() const { return m_data + m_size; }
+
+private:
+  bool map_file(const std::string& filename);
+  void unmap_file();
+
+  bool m_open = false;
+  const uint8_t* m_data = nullptr;
+  size_t m_size = 0;
+  void* m_mapped = nullptr; // Address returned by mmap()/MapViewOfFile()
+  buffer m_buffer;          // Used when the file cannot be mapped
+
+  DISABLE_COPYING(file_view);
+};
+
+} // namespace base
+
+#endif
@@ -0,0 +1,77 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/file_content.h"
+#include "base/file_view.h"
+#include "base/fs.h"
+#include "base/sha1.h"
+
+#include <utility>
+
+using namespace base;
+
+static const char* fn = "_test_view_.tmp";
+
+TEST(FileView, Content)
+{
+  for (size_t s : { 1, 500, 4096, 1024 * 64 * 3 + 4 }) {
+    buffer buf(s);
+    for (size_t i = 0; i < buf.size(); ++i)
+      buf[i] = i;
+    write_file_content(fn, buf);
+
+    file_view view(fn);
+    ASSERT_TRUE(view.is_open());
+#if !LAF_WINDOWS
+    EXPECT_TRUE(view.is_mapped());
+#endif
+    ASSERT_EQ(s, view.size());
+    EXPECT_EQ(buf, buffer(view.begin(), view.end()));
+  }
+}
+
+TEST(FileView, EmptyAndMissingFiles)
+{
+  write_file_content(fn, nullptr, 0);
+  file_view view(fn);
+  EXPECT_TRUE(view.is_open());
+  EXPECT_TRUE(view.empty());
+  EXPECT_EQ(0, view.size());
+
+  delete_file(fn);
+  EXPECT_FALSE(view.open(fn));
+  EXPECT_FALSE(view.is_open());
+}
+
+TEST(FileView, Move)
+{
+  write_file_content(fn, buffer(100, 7));
+  file_view a(fn);
+  file_view b(std::move(a));
+  EXPECT_FALSE(a.is_open());
+  ASSERT_TRUE(b.is_open());
+  EXPECT_EQ(100, b.size());
+  EXPECT_EQ(7, b.data()[99]);
+
+  a = std::move(b);
+  EXPECT_FALSE(b.is_open());
+  EXPECT_EQ(7, a.data()[0]);
+}
+
+TEST(FileView, Sha1)
+{
+  write_file_content(fn, buffer(1000, 'a'));
+  EXPECT_EQ(Sha1::calculateFromString(std::string(1000, 'a')), Sha1::calculateFromFile(fn));
+  delete_file(fn);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,223 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/fixed_pool.h"
+
+#include "base/debug.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+
+namespace base {
+
+namespace {
+
+constexpr size_t kClasses = fixed_pool::kMaxSize / fixed_pool::kGranularity;
+constexpr size_t kBlockSize = 64 * 1024;
+
+// Maximum number of free chunks of each size that a thread can keep.
+// When a thread frees more chunks than this (e.g. objects created in
+// one thread and destroyed in other), half of them are moved to the
+// global list so other threads can reuse them.
+constexpr size_t kMaxThreadFree = 2048;
+
+// Number of chunks that a thread takes from the global list at once.
+constexpr size_t kBatch = kMaxThreadFree / 2;
+
+struct chunk {
+  chunk* next;
+};
+
+// Free lists shared by all threads.
+struct global_lists {
+  std::mutex mutex;
+  chunk* free[kClasses] = {};
+};
+
+global_lists& get_global_lists()
+{
+  // Never destroyed as thread-local lists can be returned to the
+  // global list after static destructors. It's constructed in static
+  // storage (instead of using "new") so it isn't reported as a leak
+  // in LAF_MEMLEAK builds.
+  alignas(global_lists) static uint8_t storage[sizeof(global_lists)];
+  static global_lists* lists = new (storage) global_lists;
+  return *lists;
+}
+
+std::atomic<uint64_t> g_heap_allocs(0);
+
+// Allocates a new block and returns the list of its chunks of the
+// given size class. Blocks are never freed (chunks can be in use
+// until the very end of the program), so they are allocated with
+// std::malloc() instead of base_malloc() to avoid reporting them as
+// leaks in LAF_MEMLEAK builds.
+chunk* new_block(const size_t i, size_t& n)
+{
+  const size_t size = (i + 1) * fixed_pool::kGranularity;
+  uint8_t* block = (uint8_t*)std::malloc(kBlockSize);
+  if (!block)
+    throw std::bad_alloc();
+  ++g_heap_allocs;
+
+  chunk* first = nullptr;
+  n = kBlockSize / size;
+  for (size_t j = n; j > 0; --j) {
+    chunk* c = (chunk*)(block + (j - 1) * size);
+    c->next = first;
+    first = c;
+  }
+  return first;
+}
+
+// Set to true when the thread-local lists of the current thread are
+// destroyed (e.g. a static object that frees pooled objects in its
+// destructor). After that we use the global lists directly.
+thread_local bool t_destroyed = false;
+
+struct thread_lists {
+  chunk* free[kClasses] = {};
+  size_t count[kClasses] = {};
+  fixed_pool::stats stats;
+
+  ~thread_lists()
+  {
+    for (size_t i = 0; i < kClasses; ++i)
+      give_back(i, count[i]);
+    t_destroyed = true;
+  }
+
+  // Moves "n" chunks from our free list to the global list.
+  void give_back(const size_t i, size_t n)
+  {
+    if (n == 0)
+      return;
+
+    ASSERT(n <= count[i]);
+    chunk* first = free[i];
+    chunk* last = first;
+    for (size_t j = 1; j < n; ++j)
+      last = last->next;
+    free[i] = last->next;
+    count[i] -= n;
+
+    global_lists& g = get_global_lists();
+    const std::lock_guard lock(g.mutex);
+    last->next = g.free[i];
+    g.free[i] = first;
+  }
+
+  void refill(const size_t i)
+  {
+    ASSERT(!free[i]);
+
+    // Reuse chunks freed by other threads
+    {
+      global_lists& g = get_global_lists();
+      const std::lock_guard lock(g.mutex);
+      if (g.free[i]) {
+        size_t n = 1;
+        chunk* last = g.free[i];
+        for (; n < kBatch && last->next; ++n)
+          last = last->next;
+        free[i] = g.free[i];
+        g.free[i] = last->next;
+        last->next = nullptr;
+        count[i] = n;
+        return;
+      }
+    }
+
+    free[i] = new_block(i, count[i]);
+  }
+};
+
+thread_local thread_lists t_lists;
+
+size_t size_class(const size_t size)
+{
+  return (size > 0 ? (size - 1) / fixed_pool::kGranularity : 0);
+}
+
+} // anonymous namespace
+
+// static
+void* fixed_pool::allocate(const size_t size)
+{
+  if (size > kMaxSize)
+    return nullptr;
+
+  const size_t i = size_class(size);
+
+  // Allocation after the thread-local lists were destroyed
+  if (t_destroyed) {
+    global_lists& g = get_global_lists();
+    const std::lock_guard lock(g.mutex);
+    if (!g.free[i]) {
+      size_t n;
+      g.free[i] = new_block(i, n);
+    }
+    chunk* c = g.free[i];
+    g.free[i] = c->next;
+    return c;
+  }
+
+  thread_lists& lists = t_lists;
+  if (!lists.free[i])
+    lists.refill(i);
+
+  chunk* c = lists.free[i];
+  lists.free[i] = c->next;
+  --lists.count[i];
+  ++lists.stats.allocs;
+  return c;
+}
+
+// static
+void fixed_pool::deallocate(void* ptr, const size_t size)
+{
+  if (!ptr)
+    return;
+
+  ASSERT(size <= kMaxSize);
+  const size_t i = size_class(size);
+  chunk* c = (chunk*)ptr;
+
+  // Deallocation after the thread-local lists were destroyed
+  if (t_destroyed) {
+    global_lists& g = get_global_lists();
+    const std::lock_guard lock(g.mutex);
+    c->next = g.free[i];
+    g.free[i] = c;
+    return;
+  }
+
+  thread_lists& lists = t_lists;
+  c->next = lists.free[i];
+  lists.free[i] = c;
+  ++lists.count[i];
+  ++lists.stats.deallocs;
+
+  if (lists.count[i] > kMaxThreadFree)
+    lists.give_back(i, kMaxThreadFree / 2);
+}
+
+// static
+fixed_pool::stats fixed_pool::get_stats()
+{
+  stats s;
+  if (!t_destroyed)
+    s = t_lists.stats;
+  s.heap_allocs = g_heap_allocs;
+  return s;
+}
+
+} // namespace base
@@ -0,0 +1,124 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_FIXED_POOL_H_INCLUDED
+#define BASE_FIXED_POOL_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+
+#include <cstddef>
+#include <new>
+
+namespace base {
+
+// Pool of small fixed-size memory chunks (from 16 to 256 bytes, in
+// 16 bytes steps). Each thread has its own free list for each chunk
+// size, so allocate()/deallocate() don't need locks. Chunks are
+// carved from 64KB blocks allocated from the heap. Excess of free
+// chunks in one thread (and all free chunks of a thread that
+// finishes) are moved to a global free list to be reused by other
+// threads. Blocks are never returned to the heap.
+//
+// A chunk can be deallocated from a different thread than the one
+// that allocated it.
+class fixed_pool {
+public:
+  static constexpr size_t kGranularity = 16;
+  static constexpr size_t kMaxSize = 256;
+
+  struct stats {
+    uint64_t allocs = 0;      // Number of allocate() calls in this thread
+    uint64_t deallocs = 0;    // Number of deallocate() calls in this thread
+    uint64_t heap_allocs = 0; // Number of blocks allocated from the heap (all threads)
+  };
+
+  // Returns nullptr if size > kMaxSize.
+  static void* allocate(const size_t size);
+  static void deallocate(void* ptr, const size_t size);
+
+  // Statistics of the current thread (counters are per-thread to
+  // avoid contention between threads), and the global number of
+  // heap allocations.
+  static stats get_stats();
+};
+
+// Adapter to use the fixed_pool in STL containers. Allocations
+// bigger than fixed_pool::kMaxSize use the default operator new.
+// Useful for node-based containers (std::list, std::map, etc.).
+template<typename T>
+class pool_allocator {
+  static_assert(alignof(T) <= fixed_pool::kGranularity, "pool_allocator alignment not supported");
+
+public:
+  typedef T value_type;
+
+  pool_allocator() = default;
+  template<typename U>
+  pool_allocator(const pool_allocator<U>&)
+  {
+  }
+
+  T* allocate(const std::size_t n)
+  {
+    const size_t size = n * sizeof(T);
+    if (size <= fixed_pool::kMaxSize)
+      return static_cast<T*>(fixed_pool::allocate(size));
+    return static_cast<T*>(::operator new(size));
+  }
+
+  void deallocate(T* ptr, const std::size_t n)
+  {
+    const size_t size = n * sizeof(T);
+    if (size <= fixed_pool::kMaxSize)
+      fixed_pool::deallocate(ptr, size);
+    else
+      ::operator delete(ptr);
+  }
+
+  template<typename U>
+  bool operator==(const pool_allocator<U>&) const
+  {
+    return true;
+  }
+  template<typename U>
+  bool operator!=(const pool_allocator<U>&) const
+  {
+    return false;
+  }
+};
+
+// Base class to allocate objects of the derived class with the
+// fixed_pool using "new" and "delete" operators. It's useful only for
+// objects allocated one by one with "new", objects stored by value in
+// containers (e.g. os::Event in the event queues) don't use it.
+//
+// Example:
+//
+//   class work : public base::pooled_object<work> { ... };
+//
+template<typename T>
+class pooled_object {
+public:
+  static void* operator new(const std::size_t size)
+  {
+    if (size <= fixed_pool::kMaxSize)
+      return fixed_pool::allocate(size);
+    return ::operator new(size);
+  }
+
+  static void operator delete(void* ptr, const std::size_t size)
+  {
+    if (size <= fixed_pool::kMaxSize)
+      fixed_pool::deallocate(ptr, size);
+    else
+      ::operator delete(ptr);
+  }
+};
+
+} // namespace base
+
+#endif
@@ -0,0 +1,115 @@
+// LAF Base Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/fixed_pool.h"
+
+#include <cstring>
+#include <list>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace base;
+
+TEST(FixedPool, AllocateDeallocate)
+{
+  const auto stats0 = fixed_pool::get_stats();
+
+  std::set<void*> ptrs;
+  for (size_t size = 1; size <= fixed_pool::kMaxSize; ++size) {
+    void* p = fixed_pool::allocate(size);
+    EXPECT_EQ(0, size_t(p) % fixed_pool::kGranularity);
+    EXPECT_TRUE(ptrs.insert(p).second);
+    std::memset(p, 0, size);
+  }
+  EXPECT_EQ(nullptr, fixed_pool::allocate(fixed_pool::kMaxSize + 1));
+
+  size_t size = 1;
+  for (void* p : ptrs)
+    fixed_pool::deallocate(p, size++);
+
+  const auto stats1 = fixed_pool::get_stats();
+  EXPECT_EQ(fixed_pool::kMaxSize, stats1.allocs - stats0.allocs);
+  EXPECT_EQ(fixed_pool::kMaxSize, stats1.deallocs - stats0.deallocs);
+}
+
+TEST(FixedPool, ReuseChunks)
+{
+  void* p = fixed_pool::allocate(24);
+  fixed_pool::deallocate(p, 24);
+  void* q = fixed_pool::allocate(32);
+  EXPECT_EQ(p, q);
+  fixed_pool::deallocate(q, 32);
+}
+
+TEST(FixedPool, Containers)
+{
+  std::list<int, pool_allocator<int>> l;
+  std::map<int, int, std::less<int>, pool_allocator<std::pair<const int, int>>> m;
+  for (int i = 0; i < 10000; ++i) {
+    l.push_back(i);
+    m[i] = i;
+  }
+  int i = 0;
+  for (int v : l)
+    EXPECT_EQ(i++, v);
+  EXPECT_EQ(10000, m.size());
+}
+
+// Objects allocated in one thread and deallocated in other
+TEST(FixedPool, ProducerConsumer)
+{
+  struct obj : public pooled_object<obj> {
+    int value[8];
+  };
+
+  const auto heapAllocs = fixed_pool::get_stats().heap_allocs;
+  std::vector<obj*> objs;
+  for (int j = 0; j < 100; ++j) {
+    for (int i = 0; i < 1000; ++i)
+      objs.push_back(new obj);
+
+    std::thread([&objs] {
+      for (obj* o : objs)
+        delete o;
+    }).join();
+    objs.clear();
+  }
+
+  // Blocks freed by the thread must be reused
+  EXPECT_GT(5, fixed_pool::get_stats().heap_allocs - heapAllocs);
+}
+
+// Chunks deallocated after the thread-local lists of the thread are
+// destroyed (e.g. from the destructor of other thread_local object).
+TEST(FixedPool, DeallocateAtThreadExit)
+{
+  struct holder {
+    void* ptr = nullptr;
+    ~holder() { fixed_pool::deallocate(ptr, 64); }
+  };
+
+  for (int i = 0; i < 10; ++i) {
+    std::thread([] {
+      // Constructed before the fixed_pool thread-local lists, so it's
+      // destroyed after them.
+      static thread_local holder h;
+      holder& ref = h;
+      void* ptr = fixed_pool::allocate(64);
+      EXPECT_NE(nullptr, ptr);
+      ref.ptr = ptr;
+    }).join();
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -12,6 +12,8 @@
 #include "base/fs.h"
 #include "base/split_string.h"
 #include "base/string.h"
+#include "base/task.h"
+#include "base/thread_pool.h"
 #include "base/utf8_decode.h"
 
 #if LAF_WINDOWS
@@ -22,8 +24,12 @@
 
 #include <algorithm>
 #include <cctype>
+#include <condition_variable>
 #include <cstdlib>
+#include <deque>
 #include <iterator>
+#include <memory>
+#include <mutex>
 
 namespace base {
 
@@ -416,4 +422,128 @@ int compare_filenames(const std::string& a, const std::string& b)
   return 1;
 }
 
+namespace {
+
+// State shared by the threads that participate in a
+// scan_directory() call. Helper threads keep a shared_ptr to it, so
+// it's valid even if they start running after the scan is finished.
+struct scan_state {
+  std::string root;
+  scan_options options;
+  task_token* token;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::string> dirs; // Directories to scan (relative to root)
+  int active = 0;               // Directories being scanned right now
+  dir_entries entries;
+};
+
+// Scans one directory adding its items to "entries", and its
+// subdirectories to "subdirs".
+void scan_one_directory(const scan_state& state,
+                        const std::string& dir,
+                        dir_entries& entries,
+                        std::vector<std::string>& subdirs)
+{
+  const scan_options& options = state.options;
+  const bool match_all = (options.match.empty() || options.match == "*");
+  const std::string prefix = (dir.empty() ? std::string() : dir + path_separator);
+
+  read_directory(
+    (dir.empty() ? state.root : join_path(state.root, dir)),
+    [&](const char* name, bool is_dir, uint64_t size, std::time_t mtime, bool can_enter) {
+      if (state.token && state.token->canceled())
+        return false;
+
+      dir_entry entry;
+      entry.path = prefix + name;
+      entry.type = (is_dir ? ItemType::Directories : ItemType::Files);
+      entry.size = size;
+      entry.mtime = mtime;
+
+      if (can_enter && options.recursive && (!options.enter || options.enter(entry)))
+        subdirs.push_back(entry.path);
+
+      if ((options.filter == ItemType::All || options.filter == entry.type) &&
+          (match_all || match_file_name(name, options.match)) &&
+          (!options.accept || options.accept(entry))) {
+        entries.push_back(std::move(entry));
+      }
+      return true;
+    });
+}
+
+// Scans directories from the queue until all of them are scanned
+// (or the scan is canceled).
+void scan_worker(scan_state& state)
+{
+  dir_entries entries;
+  std::vector<std::string> subdirs;
+  std::unique_lock lock(state.mutex);
+  while (true) {
+    if (state.dirs.empty()) {
+      // The scan is finished when there are no more directories
+      // in the queue nor directories being scanned (which could
+      // add new subdirectories).
+      if (state.active == 0)
+        break;
+      state.cv.wait(lock);
+      continue;
+    }
+    if (state.token && state.token->canceled()) {
+      state.dirs.clear();
+      continue;
+    }
+
+    const std::string dir = std::move(state.dirs.front());
+    state.dirs.pop_front();
+    ++state.active;
+    lock.unlock();
+
+    scan_one_directory(state, dir, entries, subdirs);
+
+    lock.lock();
+    --state.active;
+    std::move(entries.begin(), entries.end(), std::back_inserter(state.entries));
+    std::move(subdirs.begin(), subdirs.end(), std::back_inserter(state.dirs));
+    entries.clear();
+    subdirs.clear();
+    state.cv.notify_all();
+  }
+}
+
+} // anonymous namespace
+
+dir_entries scan_directory(const std::string& path,
+                           const scan_options& options,
+                           thread_pool* pool,
+                           task_token* token)
+{
+  auto state = std::make_shared<scan_state>();
+  state->root = path;
+  state->options = options;
+  state->token = token;
+  state->dirs.push_back(std::string());
+
+  // The calling thread participates in the scan too, so it works
+  // even if all pool threads are busy (or this is called from one of
+  // them).
+  if (pool && options.recursive) {
+    for (size_t i = 0; i < pool->size(); ++i)
+      pool->execute([state] { scan_worker(*state); });
+  }
+  scan_worker(*state);
+
+  dir_entries entries;
+  {
+    const std::lock_guard lock(state->mutex);
+    entries = std::move(state->entries);
+  }
+  std::sort(entries.begin(), entries.end(), [](const dir_entry& a, const dir_entry& b) {
+    return a.path < b.path;
+  });
+  return entries;
+}
+
 } // namespace base
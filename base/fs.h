@@ -9,13 +9,19 @@
 #define BASE_FS_H_INCLUDED
 #pragma once
 
+#include <ctime>
+#include <functional>
 #include <string>
+#include <vector>
 
+#include "base/ints.h"
 #include "base/paths.h"
 
 namespace base {
 
 class Time;
+class task_token;
+class thread_pool;
 
 // Default path separator (on Windows it is '\' and on Unix-like
 // systems it is '/').
@@ -77,6 +83,50 @@ paths list_files(const std::string& path,
                  ItemType filter = ItemType::All,
                  const std::string& = "*");
 
+// Item found by scan_directory().
+struct dir_entry {
+  std::string path;                // Path relative to the scanned directory
+  ItemType type = ItemType::Files; // ItemType::Directories or ItemType::Files
+  uint64_t size = 0;               // Size in bytes (zero for directories)
+  std::time_t mtime = 0;           // Modification time (see safe_localtime())
+
+  bool is_directory() const { return type == ItemType::Directories; }
+};
+using dir_entries = std::vector<dir_entry>;
+
+struct scan_options {
+  // Kind of items to return (subdirectories are scanned anyway)
+  ItemType filter = ItemType::All;
+
+  // Pattern to match item names (like in list_files())
+  std::string match = "*";
+
+  // Scan subdirectories too
+  bool recursive = true;
+
+  // Optional function to discard items that passed the "filter" and
+  // "match" options.
+  std::function<bool(const dir_entry&)> accept;
+
+  // Optional function to avoid scanning some subdirectories.
+  std::function<bool(const dir_entry&)> enter;
+};
+
+// Lists the items of the given directory (and its subdirectories if
+// options.recursive is true) with their type, size, and modification
+// time read in the same pass (instead of calling is_directory(),
+// file_size(), etc. for each item). Symbolic links to directories
+// are reported as directories, but are not scanned.
+//
+// If a thread pool is given, subdirectories are scanned in parallel
+// (so the accept/enter functions must be thread-safe). If the token
+// is canceled, the scan stops and returns the items found so far.
+// The returned items are sorted by path.
+dir_entries scan_directory(const std::string& path,
+                           const scan_options& options = scan_options(),
+                           thread_pool* pool = nullptr,
+                           task_token* token = nullptr);
+
 // Returns true if the given character is a valud path separator
 // (any of '\' or '/' characters).
 inline constexpr bool is_path_separator(std::string::value_type chr)
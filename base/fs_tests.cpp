@@ -10,6 +10,8 @@
 #include "base/exception.h"
 #include "base/file_content.h"
 #include "base/fs.h"
+#include "base/task.h"
+#include "base/thread_pool.h"
 
 #include <algorithm>
 #include <cstdio>
@@ -553,6 +555,78 @@ TEST(FS, ListFiles)
   remove_directory("a");
 }
 
+TEST(FS, ScanDirectory)
+{
+  // Prepare files: s/{x, y/{z, w/{v}}, u}
+  make_all_directories("s/y/w");
+  make_directory("s/u");
+  write_file_content("s/x", (uint8_t*)"1", 1);
+  write_file_content("s/y/z", (uint8_t*)"12", 2);
+  write_file_content("s/y/w/v.png", (uint8_t*)"123", 3);
+
+  const std::string sep(1, path_separator);
+  thread_pool pool(3);
+  for (thread_pool* p : { (thread_pool*)nullptr, &pool }) {
+    EXPECT_TRUE(scan_directory("non-existent-folder", scan_options(), p).empty());
+
+    dir_entries entries = scan_directory("s", scan_options(), p);
+    ASSERT_EQ(6, entries.size());
+    EXPECT_EQ("u", entries[0].path);
+    EXPECT_TRUE(entries[0].is_directory());
+    EXPECT_EQ("x", entries[1].path);
+    EXPECT_FALSE(entries[1].is_directory());
+    EXPECT_EQ(1, entries[1].size);
+    EXPECT_EQ("y", entries[2].path);
+    EXPECT_EQ("y" + sep + "w", entries[3].path);
+    EXPECT_EQ("y" + sep + "w" + sep + "v.png", entries[4].path);
+    EXPECT_EQ(3, entries[4].size);
+    EXPECT_EQ("y" + sep + "z", entries[5].path);
+    EXPECT_EQ(2, entries[5].size);
+
+    // Same modification time as get_modification_time()
+    std::tm t;
+    safe_localtime(entries[4].mtime, &t);
+    EXPECT_EQ(get_modification_time("s/y/w/v.png"),
+              Time(t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec));
+
+    scan_options options;
+    options.filter = ItemType::Files;
+    options.match = "*.PNG";
+    entries = scan_directory("s", options, p);
+    ASSERT_EQ(1, entries.size());
+    EXPECT_EQ("y" + sep + "w" + sep + "v.png", entries[0].path);
+
+    options = scan_options();
+    options.filter = ItemType::Directories;
+    options.recursive = false;
+    entries = scan_directory("s", options, p);
+    ASSERT_EQ(2, entries.size());
+    EXPECT_EQ("u", entries[0].path);
+    EXPECT_EQ("y", entries[1].path);
+
+    options = scan_options();
+    options.accept = [](const dir_entry& e) { return e.size >= 2; };
+    options.enter = [&sep](const dir_entry& e) { return e.path != "y" + sep + "w"; };
+    entries = scan_directory("s", options, p);
+    ASSERT_EQ(1, entries.size());
+    EXPECT_EQ("y" + sep + "z", entries[0].path);
+
+    // A canceled token stops the scan
+    task_token token;
+    token.cancel();
+    EXPECT_TRUE(scan_directory("s", scan_options(), p, &token).empty());
+  }
+  pool.wait_all();
+
+  delete_file("s/y/w/v.png");
+  delete_file("s/y/z");
+  delete_file("s/x");
+  remove_directory("s/y/w");
+  remove_directory("s/y");
+  remove_directory("s/u");
+  remove_directory("s");
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
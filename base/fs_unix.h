@@ -13,6 +13,7 @@
 #include "base/time.h"
 
 #include <dirent.h>
+#include <fcntl.h>
 #include <fnmatch.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -255,4 +256,49 @@ paths list_files(const std::string& path, ItemType filter, const std::string& ma
   return files;
 }
 
+static bool match_file_name(const char* name, const std::string& pattern)
+{
+  return (fnmatch(pattern.c_str(), name, FNM_CASEFOLD) != FNM_NOMATCH);
+}
+
+// Calls func(name, is_dir, size, mtime, can_enter) for each item in
+// the given directory, until func() returns false. The metadata is
+// read with one fstatat() call relative to the opened directory (two
+// calls for symbolic links).
+template<typename Func>
+static void read_directory(const std::string& path, Func&& func)
+{
+  DIR* handle = opendir(path.c_str());
+  if (!handle)
+    return;
+
+  const int fd = dirfd(handle);
+  struct stat sts;
+  dirent* item;
+  while ((item = readdir(handle)) != nullptr) {
+    const char* name = item->d_name;
+    if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0)))
+      continue;
+
+    if (fstatat(fd, name, &sts, AT_SYMLINK_NOFOLLOW) != 0)
+      continue;
+
+    // Symbolic links are not scanned to avoid cycles, but we report
+    // the type/size of the target (if it exists).
+    bool can_enter = true;
+    if (S_ISLNK(sts.st_mode)) {
+      can_enter = false;
+      struct stat target;
+      if (fstatat(fd, name, &target, 0) == 0)
+        sts = target;
+    }
+
+    const bool is_dir = S_ISDIR(sts.st_mode);
+    if (!func(name, is_dir, is_dir ? 0 : uint64_t(sts.st_size), sts.st_mtime, is_dir && can_enter))
+      break;
+  }
+
+  closedir(handle);
+}
+
 } // namespace base
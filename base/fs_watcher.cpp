@@ -0,0 +1,404 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/fs_watcher.h"
+
+#include "base/fs.h"
+
+#if LAF_LINUX
+  #include <poll.h>
+  #include <sys/eventfd.h>
+  #include <sys/inotify.h>
+  #include <unistd.h>
+
+  #include <algorithm>
+  #include <atomic>
+  #include <cerrno>
+  #include <map>
+  #include <mutex>
+  #include <thread>
+#endif
+
+namespace base {
+
+#if LAF_LINUX
+
+class fs_watcher::impl {
+public:
+  impl()
+    : m_fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+    , m_wakeup(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+  {
+  }
+
+  ~impl()
+  {
+    if (m_thread.joinable()) {
+      m_running = false;
+      wakeup();
+      m_thread.join();
+    }
+    if (m_wakeup >= 0)
+      close(m_wakeup);
+    if (m_fd >= 0)
+      close(m_fd);
+  }
+
+  void on_changes(callback&& func)
+  {
+    const std::lock_guard lock(m_mutex);
+    m_callback = std::move(func);
+  }
+
+  void set_dispatcher(dispatcher&& func)
+  {
+    const std::lock_guard lock(m_mutex);
+    m_dispatcher = std::move(func);
+  }
+
+  void set_debounce(const tick_t msecs)
+  {
+    const std::lock_guard lock(m_mutex);
+    m_debounce = msecs;
+  }
+
+  bool add(const std::string& path, const bool recursive)
+  {
+    if (m_fd < 0 || m_wakeup < 0)
+      return false;
+
+    const std::lock_guard lock(m_mutex);
+    if (!add_watch(path, recursive, true))
+      return false;
+    if (recursive)
+      add_subdirs(path, false);
+
+    // The thread is started with m_mutex locked so two add() calls
+    // from different threads cannot start two threads.
+    if (!m_thread.joinable()) {
+      m_running = true;
+      m_thread = std::thread([this] { thread_proc(); });
+    }
+    return true;
+  }
+
+  void remove(const std::string& path)
+  {
+    const std::lock_guard lock(m_mutex);
+    remove_watches(path);
+  }
+
+private:
+  struct watch {
+    std::string path;
+    bool recursive = false;
+    bool root = false; // Added by the user with add()
+    bool directory = false;
+  };
+
+  struct pending_change {
+    change changes = change::none;
+    bool is_directory = false;
+  };
+
+  static constexpr uint32_t kMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB |
+                                    IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+
+  // m_mutex must be locked
+  bool add_watch(const std::string& path, const bool recursive, const bool root)
+  {
+    const int wd = inotify_add_watch(m_fd, path.c_str(), kMask | (recursive ? IN_ONLYDIR : 0));
+    if (wd < 0)
+      return false;
+
+    // inotify returns the same wd if the path was already watched
+    watch& w = m_watches[wd];
+    if (!w.path.empty())
+      m_paths.erase(w.path);
+    w.path = path;
+    w.recursive |= recursive;
+    w.root |= root;
+    w.directory = is_directory(path);
+    m_paths[path] = wd;
+    return true;
+  }
+
+  // Adds watches for all subdirectories of "path" (which is a
+  // directory inside a recursive watch). If "report" is true, the
+  // items inside it are reported as added (they could be created
+  // before the watch was added).
+  void add_subdirs(const std::string& path, const bool report)
+  {
+    scan_options options;
+    if (!report)
+      options.filter = ItemType::Directories;
+    for (const dir_entry& entry : scan_directory(path, options)) {
+      const std::string fullpath = join_path(path, entry.path);
+      if (entry.is_directory())
+        add_watch(fullpath, true, false);
+      if (report)
+        record(fullpath, change::added, entry.is_directory());
+    }
+  }
+
+  // Removes the watches of "path" and its subdirectories.
+  void remove_watches(const std::string& path)
+  {
+    auto it = m_paths.find(path);
+    if (it != m_paths.end())
+      remove_watch(it);
+
+    const std::string prefix = path + path_separator;
+    it = m_paths.lower_bound(prefix);
+    while (it != m_paths.end() && it->first.compare(0, prefix.size(), prefix) == 0)
+      it = remove_watch(it);
+  }
+
+  std::map<std::string, int>::iterator remove_watch(std::map<std::string, int>::iterator it)
+  {
+    inotify_rm_watch(m_fd, it->second);
+    m_watches.erase(it->second);
+    return m_paths.erase(it);
+  }
+
+  // Coalesces the given change with the pending changes of the same
+  // path (m_mutex must be locked).
+  void record(const std::string& path, const change c, const bool is_directory)
+  {
+    const tick_t now = current_tick();
+    if (m_pending.empty())
+      m_first = now;
+    m_deadline = std::min(now + m_debounce, m_first + 10 * m_debounce);
+
+    pending_change& p = m_pending[path];
+    p.is_directory = is_directory;
+    switch (c) {
+      case change::added:
+        // Deleted and created again: it was replaced
+        if ((p.changes & change::removed) != change::none)
+          p.changes = change::modified;
+        else
+          p.changes |= change::added;
+        break;
+      case change::removed:
+        // Created and deleted: it's like nothing happened
+        if ((p.changes & change::added) != change::none)
+          m_pending.erase(path);
+        else
+          p.changes = change::removed;
+        break;
+      case change::modified:
+        if ((p.changes & (change::added | change::removed)) == change::none)
+          p.changes |= change::modified;
+        break;
+      default: p.changes |= c; break;
+    }
+  }
+
+  void process_event(const inotify_event* ev)
+  {
+    if (ev->mask & IN_Q_OVERFLOW) {
+      for (const auto& [wd, w] : m_watches) {
+        if (w.root)
+          record(w.path, change::overflow, w.directory);
+      }
+      return;
+    }
+
+    auto it = m_watches.find(ev->wd);
+    if (it == m_watches.end())
+      return;
+
+    // Watch removed by the kernel (the file/directory was deleted)
+    if (ev->mask & IN_IGNORED) {
+      m_paths.erase(it->second.path);
+      m_watches.erase(it);
+      return;
+    }
+
+    const watch w = it->second;
+    const bool is_dir = (ev->mask & IN_ISDIR) ? true : false;
+    const std::string path = (ev->len > 0 ? join_path(w.path, ev->name) : w.path);
+
+    if (ev->mask & (IN_CREATE | IN_MOVED_TO)) {
+      record(path, change::added, is_dir);
+      if (is_dir && w.recursive) {
+        add_watch(path, true, false);
+        add_subdirs(path, true);
+      }
+    }
+    if (ev->mask & (IN_DELETE | IN_MOVED_FROM)) {
+      record(path, change::removed, is_dir);
+      if (is_dir)
+        remove_watches(path);
+    }
+    if (ev->mask & (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB)) {
+      // Changes in a watched directory itself are not interesting
+      if (ev->len > 0 || !w.recursive)
+        record(path, change::modified, is_dir);
+    }
+    // A watched path was deleted/moved (events of subdirectories are
+    // reported by their parent).
+    if ((ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) && w.root)
+      record(path, change::removed, w.directory);
+  }
+
+  void read_events()
+  {
+    alignas(inotify_event) char buf[64 * 1024];
+    while (true) {
+      const ssize_t n = read(m_fd, buf, sizeof(buf));
+      if (n <= 0)
+        break;
+
+      const std::lock_guard lock(m_mutex);
+      for (char* p = buf; p < buf + n;) {
+        const auto* ev = (const inotify_event*)p;
+        process_event(ev);
+        p += sizeof(inotify_event) + ev->len;
+      }
+    }
+  }
+
+  void deliver()
+  {
+    events evs;
+    callback cb;
+    dispatcher disp;
+    {
+      const std::lock_guard lock(m_mutex);
+      if (m_pending.empty() || current_tick() < m_deadline)
+        return;
+
+      evs.reserve(m_pending.size());
+      for (const auto& [path, p] : m_pending)
+        evs.push_back(event{ path, p.changes, p.is_directory });
+      m_pending.clear();
+      cb = m_callback;
+      disp = m_dispatcher;
+    }
+    if (!cb)
+      return;
+    if (disp)
+      disp([cb, evs = std::move(evs)] { cb(evs); });
+    else
+      cb(evs);
+  }
+
+  void thread_proc()
+  {
+    pollfd fds[2] = {
+      { m_fd,     POLLIN, 0 },
+      { m_wakeup, POLLIN, 0 },
+    };
+    while (m_running) {
+      int timeout = -1;
+      {
+        const std::lock_guard lock(m_mutex);
+        if (!m_pending.empty()) {
+          const tick_t now = current_tick();
+          timeout = (m_deadline > now ? int(m_deadline - now) : 0);
+        }
+      }
+
+      if (poll(fds, 2, timeout) < 0 && errno != EINTR)
+        break;
+
+      if (fds[1].revents & POLLIN) {
+        uint64_t value;
+        (void)read(m_wakeup, &value, sizeof(value));
+      }
+      if (fds[0].revents & POLLIN)
+        read_events();
+
+      deliver();
+    }
+  }
+
+  void wakeup()
+  {
+    const uint64_t value = 1;
+    (void)write(m_wakeup, &value, sizeof(value));
+  }
+
+  const int m_fd;
+  const int m_wakeup;
+  std::thread m_thread;
+  std::atomic<bool> m_running = false;
+
+  std::mutex m_mutex;
+  std::map<int, watch> m_watches;      // Watch descriptor -> watch
+  std::map<std::string, int> m_paths;  // Path -> watch descriptor
+  std::map<std::string, pending_change> m_pending;
+  tick_t m_first = 0;
+  tick_t m_deadline = 0;
+  tick_t m_debounce = 100;
+  callback m_callback;
+  dispatcher m_dispatcher;
+};
+
+bool fs_watcher::is_supported()
+{
+  return true;
+}
+
+#else
+
+// Dummy implementation for platforms without a backend
+class fs_watcher::impl {
+public:
+  void on_changes(callback&&) {}
+  void set_dispatcher(dispatcher&&) {}
+  void set_debounce(tick_t) {}
+  bool add(const std::string&, bool) { return false; }
+  void remove(const std::string&) {}
+};
+
+bool fs_watcher::is_supported()
+{
+  return false;
+}
+
+#endif
+
+fs_watcher::fs_watcher() : m_impl(std::make_unique<impl>())
+{
+}
+
+fs_watcher::~fs_watcher()
+{
+}
+
+void fs_watcher::on_changes(callback&& func)
+{
+  m_impl->on_changes(std::move(func));
+}
+
+void fs_watcher::set_dispatcher(dispatcher&& func)
+{
+  m_impl->set_dispatcher(std::move(func));
+}
+
+void fs_watcher::set_debounce(const tick_t msecs)
+{
+  m_impl->set_debounce(msecs);
+}
+
+bool fs_watcher::add(const std::string& path, const bool recursive)
+{
+  return m_impl->add(path, recursive);
+}
+
+void fs_watcher::remove(const std::string& path)
+{
+  m_impl->remove(path);
+}
+
+} // namespace base
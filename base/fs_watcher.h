@@ -0,0 +1,95 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_FS_WATCHER_H_INCLUDED
+#define BASE_FS_WATCHER_H_INCLUDED
+#pragma once
+
+#include "base/disable_copying.h"
+#include "base/enum_flags.h"
+#include "base/ints.h"
+#include "base/time.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace base {
+
+// Watches files and directories to know when they change (instead
+// of polling get_modification_time()). It's implemented with inotify
+// on Linux, on other platforms is_supported() returns false.
+//
+// Events are coalesced: all the changes of the same path in a short
+// interval (see set_debounce()) are reported as one event, e.g. a
+// file that is created and deleted is not reported, a file that is
+// deleted and created again is reported as modified. The callback
+// is called from the watcher thread, or through the dispatcher, e.g.
+// to receive the changes in the main thread of an os::System:
+//
+//   base::fs_watcher watcher;
+//   watcher.set_dispatcher(os::queue_callback);
+//   watcher.on_changes([](const base::fs_watcher::events& evs) { ... });
+//   watcher.add(path, true);
+//
+class fs_watcher {
+public:
+  enum class change : uint8_t {
+    none = 0,
+    added = 1,    // Created or moved into the watched directory
+    removed = 2,  // Deleted or moved out of the watched directory
+    modified = 4, // Content or attributes modified (or replaced)
+    overflow = 8, // Some events were lost, the path must be rescanned
+  };
+
+  struct event {
+    std::string path;
+    change changes = change::none;
+    bool is_directory = false;
+  };
+  using events = std::vector<event>;
+  using callback = std::function<void(const events&)>;
+  using dispatcher = std::function<void(std::function<void()>&&)>;
+
+  fs_watcher();
+  ~fs_watcher();
+
+  static bool is_supported();
+
+  // Function called with the changes (sorted by path).
+  void on_changes(callback&& func);
+
+  // Function used to execute the callback in another thread. By
+  // default (when it's nullptr) the callback is called from the
+  // watcher thread.
+  void set_dispatcher(dispatcher&& func);
+
+  // Changes are reported when there are no new changes in the given
+  // milliseconds (100ms by default), or when the first change is 10
+  // times older than this interval.
+  void set_debounce(tick_t msecs);
+
+  // Starts watching the given file or directory (and its
+  // subdirectories if "recursive" is true, including new ones).
+  // Returns false if the path cannot be watched.
+  bool add(const std::string& path, bool recursive = false);
+
+  // Stops watching the given path (added with add()).
+  void remove(const std::string& path);
+
+private:
+  class impl;
+  std::unique_ptr<impl> m_impl;
+
+  DISABLE_COPYING(fs_watcher);
+};
+
+LAF_ENUM_FLAGS(fs_watcher::change);
+
+} // namespace base
+
+#endif
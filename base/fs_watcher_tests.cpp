@@ -0,0 +1,140 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/fs_watcher.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using namespace base;
+using change = fs_watcher::change;
+
+// Collects the events received by the watcher callback
+class watcher_events {
+public:
+  watcher_events(fs_watcher& watcher)
+  {
+    watcher.on_changes([this](const fs_watcher::events& evs) {
+      const std::lock_guard lock(m_mutex);
+      for (const auto& ev : evs)
+        m_changes[ev.path] |= ev.changes;
+      m_cv.notify_all();
+    });
+  }
+
+  // Waits until a change of the given path is received (or a
+  // generous timeout for loaded machines), and returns all the
+  // changes received until that moment.
+  std::map<std::string, change> wait(const std::string& path)
+  {
+    std::unique_lock lock(m_mutex);
+    m_cv.wait_for(lock, std::chrono::seconds(30), [this, &path] {
+      return m_changes.find(path) != m_changes.end();
+    });
+    return std::move(m_changes);
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::map<std::string, change> m_changes;
+};
+
+TEST(FSWatcher, Changes)
+{
+  if (!fs_watcher::is_supported())
+    return;
+
+  make_directory("w");
+
+  // Changes are coalesced only if they happen in the debounce
+  // interval, so we use a long one for the tests of coalesced changes
+  // (the writes take a lot less than 500ms even in loaded machines),
+  // and a short one for the rest.
+  const tick_t kLongDebounce = 500;
+  const tick_t kShortDebounce = 100;
+
+  fs_watcher watcher;
+  watcher_events events(watcher);
+  watcher.set_debounce(kLongDebounce);
+  ASSERT_TRUE(watcher.add("w", true));
+  EXPECT_FALSE(watcher.add("non-existent-folder"));
+
+  // Several writes are coalesced in one event
+  const std::string a = join_path("w", "a");
+  write_file_content(a, (const uint8_t*)"1", 1);
+  write_file_content(a, (const uint8_t*)"12", 2);
+  auto changes = events.wait(a);
+  ASSERT_EQ(1, changes.size());
+  EXPECT_EQ(change::added, changes[a]);
+
+  watcher.set_debounce(kShortDebounce);
+  write_file_content(a, (const uint8_t*)"123", 3);
+  changes = events.wait(a);
+  ASSERT_EQ(1, changes.size());
+  EXPECT_EQ(change::modified, changes[a]);
+
+  // A temporary file (created and deleted) is not reported
+  watcher.set_debounce(kLongDebounce);
+  const std::string tmp = join_path("w", "tmp");
+  write_file_content(tmp, (const uint8_t*)"1", 1);
+  delete_file(tmp);
+  delete_file(a);
+  changes = events.wait(a);
+  ASSERT_EQ(1, changes.size());
+  EXPECT_EQ(change::removed, changes[a]);
+
+  // New subdirectories are watched too
+  watcher.set_debounce(kShortDebounce);
+  const std::string sub = join_path("w", "sub");
+  const std::string b = join_path(sub, "b");
+  make_directory(sub);
+  changes = events.wait(sub);
+  EXPECT_EQ(change::added, changes[sub]);
+
+  write_file_content(b, (const uint8_t*)"1", 1);
+  changes = events.wait(b);
+  ASSERT_EQ(1, changes.size());
+  EXPECT_EQ(change::added, changes[b]);
+
+  delete_file(b);
+  remove_directory(sub);
+  changes = events.wait(sub);
+  EXPECT_EQ(change::removed, changes[sub]);
+
+  remove_directory("w");
+}
+
+// Only one watcher thread must be started by concurrent add() calls
+TEST(FSWatcher, ConcurrentAdd)
+{
+  if (!fs_watcher::is_supported())
+    return;
+
+  make_directory("w1");
+  make_directory("w2");
+  for (int i = 0; i < 50; ++i) {
+    fs_watcher watcher;
+    std::thread t([&watcher] { EXPECT_TRUE(watcher.add("w1")); });
+    EXPECT_TRUE(watcher.add("w2"));
+    t.join();
+  }
+  remove_directory("w1");
+  remove_directory("w2");
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -13,6 +13,7 @@
 #include "base/win/win32_exception.h"
 
 #include <shlobj.h>
+#include <shlwapi.h>
 #include <stdexcept>
 #include <sys/stat.h>
 #include <windows.h>
@@ -205,6 +206,49 @@ paths list_files(const std::string& path, ItemType filter, const std::string& ma
   return files;
 }
 
+static bool match_file_name(const char* name, const std::string& pattern)
+{
+  return PathMatchSpec(from_utf8(name).c_str(), from_utf8(pattern).c_str()) ? true : false;
+}
+
+// Calls func(name, is_dir, size, mtime, can_enter) for each item in
+// the given directory, until func() returns false. FindFirstFileEx()
+// already returns the size and modification time of each item.
+template<typename Func>
+static void read_directory(const std::string& path, Func&& func)
+{
+  WIN32_FIND_DATA fd;
+  HANDLE handle = FindFirstFileEx(base::from_utf8(base::join_path(path, "*")).c_str(),
+                                  FindExInfoBasic,
+                                  &fd,
+                                  FindExSearchNameMatch,
+                                  NULL,
+                                  FIND_FIRST_EX_LARGE_FETCH);
+  if (handle == INVALID_HANDLE_VALUE)
+    return;
+
+  do {
+    if (lstrcmpW(fd.cFileName, L".") == 0 || lstrcmpW(fd.cFileName, L"..") == 0)
+      continue;
+
+    const bool is_dir = (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? true : false;
+    // Junctions/symbolic links are not scanned to avoid cycles
+    const bool can_enter = (is_dir && !(fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT));
+    const uint64_t size =
+      (is_dir ? 0 : (uint64_t(fd.nFileSizeHigh) << 32) | uint64_t(fd.nFileSizeLow));
+
+    // FILETIME is in 100-nanosecond intervals since 1601-01-01
+    const uint64_t ft = (uint64_t(fd.ftLastWriteTime.dwHighDateTime) << 32) |
+                        uint64_t(fd.ftLastWriteTime.dwLowDateTime);
+    const std::time_t mtime = std::time_t((ft - 116444736000000000ull) / 10000000ull);
+
+    if (!func(base::to_utf8(fd.cFileName).c_str(), is_dir, size, mtime, can_enter))
+      break;
+  } while (FindNextFile(handle, &fd));
+
+  FindClose(handle);
+}
+
 Version get_file_version(const std::string& filename)
 {
   return get_file_version(from_utf8(filename).c_str());
@@ -0,0 +1,250 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/hash.h"
+
+#include "base/endian.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace base {
+
+namespace {
+
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+// Seed of the high part of the 128-bit hash
+constexpr uint64_t kHighSeed = 0x9E3779B97F4A7C15ULL;
+
+inline uint64_t rotl(const uint64_t x, const int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+// XXH64 is defined in little-endian
+inline uint64_t read64(const uint8_t* p)
+{
+  return load_le<uint64_t>(p);
+}
+
+inline uint32_t read32(const uint8_t* p)
+{
+  return load_le<uint32_t>(p);
+}
+
+inline uint64_t mix_round(uint64_t acc, const uint64_t input)
+{
+  acc += input * kPrime2;
+  acc = rotl(acc, 31);
+  return acc * kPrime1;
+}
+
+inline uint64_t merge_round(uint64_t acc, const uint64_t val)
+{
+  acc ^= mix_round(0, val);
+  return acc * kPrime1 + kPrime4;
+}
+
+// Processes complete stripes of 32 bytes, returns the pointer to the
+// first unprocessed byte.
+inline const uint8_t* process_stripes(uint64_t acc[4], const uint8_t* p, const uint8_t* end)
+{
+  uint64_t v1 = acc[0], v2 = acc[1], v3 = acc[2], v4 = acc[3];
+  for (; p + 32 <= end; p += 32) {
+    v1 = mix_round(v1, read64(p));
+    v2 = mix_round(v2, read64(p + 8));
+    v3 = mix_round(v3, read64(p + 16));
+    v4 = mix_round(v4, read64(p + 24));
+  }
+  acc[0] = v1;
+  acc[1] = v2;
+  acc[2] = v3;
+  acc[3] = v4;
+  return p;
+}
+
+uint64_t finalize(const uint64_t acc[4],
+                  const uint64_t seed,
+                  const uint64_t length,
+                  const uint8_t* p,
+                  const uint8_t* end)
+{
+  uint64_t h;
+  if (length >= 32) {
+    h = rotl(acc[0], 1) + rotl(acc[1], 7) + rotl(acc[2], 12) + rotl(acc[3], 18);
+    h = merge_round(h, acc[0]);
+    h = merge_round(h, acc[1]);
+    h = merge_round(h, acc[2]);
+    h = merge_round(h, acc[3]);
+  }
+  else {
+    h = seed + kPrime5;
+  }
+  h += length;
+
+  for (; p + 8 <= end; p += 8) {
+    h ^= mix_round(0, read64(p));
+    h = rotl(h, 27) * kPrime1 + kPrime4;
+  }
+  if (p + 4 <= end) {
+    h ^= uint64_t(read32(p)) * kPrime1;
+    h = rotl(h, 23) * kPrime2 + kPrime3;
+    p += 4;
+  }
+  for (; p < end; ++p) {
+    h ^= (*p) * kPrime5;
+    h = rotl(h, 11) * kPrime1;
+  }
+
+  // Avalanche
+  h ^= h >> 33;
+  h *= kPrime2;
+  h ^= h >> 29;
+  h *= kPrime3;
+  h ^= h >> 32;
+  return h;
+}
+
+void init_acc(uint64_t acc[4], const uint64_t seed)
+{
+  acc[0] = seed + kPrime1 + kPrime2;
+  acc[1] = seed + kPrime2;
+  acc[2] = seed;
+  acc[3] = seed - kPrime1;
+}
+
+} // anonymous namespace
+
+uint64_t hash64(const void* data, size_t size, uint64_t seed)
+{
+  auto p = (const uint8_t*)data;
+  const uint8_t* end = p + size;
+  uint64_t acc[4];
+  init_acc(acc, seed);
+  p = process_stripes(acc, p, end);
+  return finalize(acc, seed, size, p, end);
+}
+
+hash128_t hash128(const void* data, size_t size, uint64_t seed)
+{
+  hash128_t h;
+  h.low = hash64(data, size, seed);
+  h.high = hash64(data, size, seed ^ kHighSeed);
+  return h;
+}
+
+void hasher64::reset(uint64_t seed)
+{
+  init_acc(m_acc, seed);
+  m_seed = seed;
+  m_length = 0;
+  m_bufSize = 0;
+}
+
+void hasher64::update(const void* data, size_t size)
+{
+  auto p = (const uint8_t*)data;
+  const uint8_t* end = p + size;
+  m_length += size;
+
+  if (m_bufSize > 0) {
+    const size_t n = std::min(size, sizeof(m_buf) - m_bufSize);
+    std::memcpy(m_buf + m_bufSize, p, n);
+    m_bufSize += n;
+    p += n;
+    if (m_bufSize < sizeof(m_buf))
+      return;
+    process_stripes(m_acc, m_buf, m_buf + sizeof(m_buf));
+    m_bufSize = 0;
+  }
+
+  p = process_stripes(m_acc, p, end);
+  if (p < end) {
+    m_bufSize = end - p;
+    std::memcpy(m_buf, p, m_bufSize);
+  }
+}
+
+uint64_t hasher64::digest() const
+{
+  return finalize(m_acc, m_seed, m_length, m_buf, m_buf + m_bufSize);
+}
+
+hasher128::hasher128(uint64_t seed) : m_low(seed), m_high(seed ^ kHighSeed)
+{
+}
+
+void hasher128::reset(uint64_t seed)
+{
+  m_low.reset(seed);
+  m_high.reset(seed ^ kHighSeed);
+}
+
+void hasher128::update(const void* data, size_t size)
+{
+  m_low.update(data, size);
+  m_high.update(data, size);
+}
+
+hash128_t hasher128::digest() const
+{
+  hash128_t h;
+  h.low = m_low.digest();
+  h.high = m_high.digest();
+  return h;
+}
+
+void hash_to_bytes(uint64_t hash, uint8_t out[8])
+{
+  for (int i = 7; i >= 0; --i, hash >>= 8)
+    out[i] = uint8_t(hash);
+}
+
+void hash_to_bytes(const hash128_t& hash, uint8_t out[16])
+{
+  hash_to_bytes(hash.high, out);
+  hash_to_bytes(hash.low, out + 8);
+}
+
+uint64_t hash64_from_bytes(const uint8_t in[8])
+{
+  uint64_t hash = 0;
+  for (int i = 0; i < 8; ++i)
+    hash = (hash << 8) | in[i];
+  return hash;
+}
+
+hash128_t hash128_from_bytes(const uint8_t in[16])
+{
+  hash128_t hash;
+  hash.high = hash64_from_bytes(in);
+  hash.low = hash64_from_bytes(in + 8);
+  return hash;
+}
+
+std::string hash_to_string(const uint64_t hash)
+{
+  char buf[17];
+  std::snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)hash);
+  return buf;
+}
+
+std::string hash_to_string(const hash128_t& hash)
+{
+  return hash_to_string(hash.high) + hash_to_string(hash.low);
+}
+
+} // namespace base
@@ -0,0 +1,97 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_HASH_H_INCLUDED
+#define BASE_HASH_H_INCLUDED
+#pragma once
+
+#include "base/ints.h"
+
+#include <cstddef>
+#include <string>
+
+namespace base {
+
+// Fast non-cryptographic hashes to be used as keys of caches (when
+// we don't need protection against collisions created on purpose,
+// in that case use base::Sha1).
+//
+// The 64-bit hash is the XXH64 algorithm, so the same input gives the
+// same hash in all platforms and versions (it can be saved in
+// files). The 128-bit hash is XXH64 with two different seeds.
+
+struct hash128_t {
+  uint64_t low = 0;
+  uint64_t high = 0;
+
+  bool operator==(const hash128_t& other) const
+  {
+    return low == other.low && high == other.high;
+  }
+  bool operator!=(const hash128_t& other) const { return !operator==(other); }
+  bool operator<(const hash128_t& other) const
+  {
+    return high < other.high || (high == other.high && low < other.low);
+  }
+};
+
+uint64_t hash64(const void* data, size_t size, uint64_t seed = 0);
+hash128_t hash128(const void* data, size_t size, uint64_t seed = 0);
+
+inline uint64_t hash64(const std::string& text, uint64_t seed = 0)
+{
+  return hash64(text.data(), text.size(), seed);
+}
+
+// Calculates the 64-bit hash incrementally (e.g. row by row of an
+// image). The result is the same as calling hash64() with all the
+// data.
+class hasher64 {
+public:
+  explicit hasher64(uint64_t seed = 0) { reset(seed); }
+
+  void reset(uint64_t seed = 0);
+  void update(const void* data, size_t size);
+
+  // Can be called several times (it doesn't modify the state).
+  uint64_t digest() const;
+
+private:
+  uint64_t m_acc[4];
+  uint64_t m_seed;
+  uint64_t m_length;
+  uint8_t m_buf[32]; // Pending bytes of an incomplete stripe
+  size_t m_bufSize;
+};
+
+// Calculates the 128-bit hash incrementally (twice the cost of
+// hasher64).
+class hasher128 {
+public:
+  explicit hasher128(uint64_t seed = 0);
+
+  void reset(uint64_t seed = 0);
+  void update(const void* data, size_t size);
+
+  hash128_t digest() const;
+
+private:
+  hasher64 m_low;
+  hasher64 m_high;
+};
+
+// Canonical representation (big-endian bytes) to store hashes in
+// files, and hexadecimal strings.
+void hash_to_bytes(uint64_t hash, uint8_t out[8]);
+void hash_to_bytes(const hash128_t& hash, uint8_t out[16]);
+uint64_t hash64_from_bytes(const uint8_t in[8]);
+hash128_t hash128_from_bytes(const uint8_t in[16]);
+std::string hash_to_string(uint64_t hash);
+std::string hash_to_string(const hash128_t& hash);
+
+} // namespace base
+
+#endif
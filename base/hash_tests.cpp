@@ -0,0 +1,85 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/hash.h"
+
+#include <vector>
+
+using namespace base;
+
+static std::vector<uint8_t> test_data()
+{
+  std::vector<uint8_t> data(5000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = uint8_t(i * 7 + (i >> 8));
+  return data;
+}
+
+// Values must never change as hashes can be saved in files.
+TEST(Hash, KnownValues)
+{
+  EXPECT_EQ(0xef46db3751d8e999ULL, hash64(""));
+  EXPECT_EQ(0xd24ec4f1a98c6e5bULL, hash64("a"));
+  EXPECT_EQ(0x44bc2cf5ad770999ULL, hash64("abc"));
+  EXPECT_EQ(0x0b242d361fda71bcULL, hash64("The quick brown fox jumps over the lazy dog"));
+
+  const auto data = test_data();
+  EXPECT_EQ(0x3434b44bd6cba68bULL, hash64(data.data(), data.size()));
+  EXPECT_EQ(0xe0eef1a6593424a2ULL, hash64(data.data(), data.size(), 1234));
+
+  const hash128_t h = hash128("abc", 3);
+  EXPECT_EQ(0x44bc2cf5ad770999ULL, h.low);
+  EXPECT_EQ(0x2ed0f59d6b43ac8bULL, h.high);
+}
+
+TEST(Hash, Incremental)
+{
+  const auto data = test_data();
+  const uint64_t expected = hash64(data.data(), data.size(), 5);
+  const hash128_t expected128 = hash128(data.data(), data.size(), 5);
+
+  for (size_t step : { 1, 7, 31, 32, 33, 100, 5000 }) {
+    hasher64 h(5);
+    hasher128 h128(5);
+    for (size_t i = 0; i < data.size(); i += step) {
+      h.update(&data[i], std::min(step, data.size() - i));
+      h128.update(&data[i], std::min(step, data.size() - i));
+    }
+    EXPECT_EQ(expected, h.digest());
+    EXPECT_EQ(expected128, h128.digest());
+  }
+
+  // Small inputs (less than one stripe)
+  hasher64 h;
+  h.update("a", 1);
+  h.update("bc", 2);
+  EXPECT_EQ(hash64("abc"), h.digest());
+  h.reset();
+  EXPECT_EQ(hash64(""), h.digest());
+}
+
+TEST(Hash, Canonical)
+{
+  uint8_t bytes[16];
+  hash_to_bytes(0x0102030405060708ULL, bytes);
+  EXPECT_EQ(1, bytes[0]);
+  EXPECT_EQ(8, bytes[7]);
+  EXPECT_EQ(0x0102030405060708ULL, hash64_from_bytes(bytes));
+  EXPECT_EQ("0102030405060708", hash_to_string(0x0102030405060708ULL));
+
+  const hash128_t h = hash128("abc", 3);
+  hash_to_bytes(h, bytes);
+  EXPECT_EQ(h, hash128_from_bytes(bytes));
+  EXPECT_EQ("2ed0f59d6b43ac8b44bc2cf5ad770999", hash_to_string(h));
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 // Copyright (C) 2001-2017  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -18,14 +18,19 @@
 #include "base/debug.h"
 #include "base/fstream_path.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -38,10 +43,234 @@ std::ofstream log_stream;
 std::ostream* log_ostream = &std::cerr;
 std::string log_filename;
 
+// Size of the buffer of each thread in asynchronous mode. Bigger
+// messages are written directly (after flushing the pending ones).
+constexpr size_t kRingSize = 64 * 1024;
+
+// Max time (msecs) that a message can stay in a buffer.
+constexpr int kFlushInterval = 50;
+
+// Writes a message in the log stream (log_mutex must be locked).
+void write_log(const char* buf, const size_t size)
+{
+  ASSERT(log_ostream);
+  log_ostream->write(buf, size);
+}
+
+// Buffer of messages of one thread: the thread that logs is the only
+// producer, and the consumer is the thread that calls drain() (the
+// writer thread or flush_log()), so we only need atomic indexes.
+struct log_ring {
+  std::unique_ptr<char[]> buf;
+  std::atomic<size_t> head; // Bytes written by the producer
+  std::atomic<size_t> tail; // Bytes read by the consumer
+  std::atomic<bool> dead;   // The thread was finished
+
+  log_ring() : buf(new char[kRingSize]), head(0), tail(0), dead(false) {}
+
+  size_t used() const
+  {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+  }
+
+  void push(const char* data, const size_t size)
+  {
+    const size_t h = head.load(std::memory_order_relaxed);
+    const size_t i = h % kRingSize;
+    const size_t n = std::min(size, kRingSize - i);
+    std::memcpy(&buf[i], data, n);
+    if (n < size)
+      std::memcpy(&buf[0], data + n, size - n);
+    head.store(h + size, std::memory_order_release);
+  }
+
+  // Writes all complete messages in the log stream (log_mutex must
+  // be locked). Returns true if something was written.
+  bool drain()
+  {
+    const size_t h = head.load(std::memory_order_acquire);
+    const size_t t = tail.load(std::memory_order_relaxed);
+    if (h == t)
+      return false;
+
+    const size_t i = t % kRingSize;
+    const size_t n = std::min(h - t, kRingSize - i);
+    write_log(&buf[i], n);
+    if (n < h - t)
+      write_log(&buf[0], h - t - n);
+    tail.store(h, std::memory_order_release);
+    return true;
+  }
+};
+
+// Background thread that writes the messages of all threads in
+// asynchronous mode.
+class async_writer {
+public:
+  ~async_writer() { stop(); }
+
+  bool enabled() const { return m_enabled; }
+
+  void start()
+  {
+    const std::lock_guard lock(m_stateMutex);
+    if (m_thread.joinable())
+      return;
+
+    m_stop = false;
+    m_thread = std::thread([this] { writer_thread(); });
+    m_enabled = true;
+  }
+
+  void stop()
+  {
+    const std::lock_guard lock(m_stateMutex);
+    if (!m_thread.joinable())
+      return;
+
+    // Wait for threads that are adding messages right now
+    m_enabled = false;
+    while (m_producers > 0)
+      std::this_thread::yield();
+
+    {
+      const std::lock_guard lock(m_mutex);
+      m_stop = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+    flush();
+  }
+
+  // Returns false if the asynchronous mode is disabled, in this case
+  // the message must be written directly.
+  bool push(const char* buf, const size_t size)
+  {
+    if (size > kRingSize / 2)
+      return false;
+
+    ++m_producers;
+    if (!m_enabled) {
+      --m_producers;
+      return false;
+    }
+
+    log_ring& ring = thread_ring();
+    while (kRingSize - ring.used() < size) {
+      // Full buffer, wake up the writer thread and wait
+      wake_up();
+      std::this_thread::yield();
+    }
+    ring.push(buf, size);
+    if (ring.used() > kRingSize / 2)
+      wake_up();
+
+    --m_producers;
+    return true;
+  }
+
+  // Writes all pending messages and flushes the log stream. It can
+  // be called from any thread.
+  void flush()
+  {
+    const std::lock_guard lock(m_drainMutex);
+    drain_all();
+  }
+
+private:
+  // Keeps the ring of each thread alive while it's registered in
+  // m_rings, and marks it as dead when the thread finishes.
+  struct ring_holder {
+    std::shared_ptr<log_ring> ring;
+    ~ring_holder()
+    {
+      if (ring)
+        ring->dead = true;
+    }
+  };
+
+  log_ring& thread_ring()
+  {
+    thread_local ring_holder holder;
+    if (!holder.ring) {
+      holder.ring = std::make_shared<log_ring>();
+      const std::lock_guard lock(m_ringsMutex);
+      m_rings.push_back(holder.ring);
+    }
+    return *holder.ring;
+  }
+
+  void wake_up()
+  {
+    if (!m_wakeUp.exchange(true)) {
+      const std::lock_guard lock(m_mutex);
+      m_cv.notify_one();
+    }
+  }
+
+  void writer_thread()
+  {
+    std::unique_lock lock(m_mutex);
+    while (!m_stop) {
+      m_cv.wait_for(lock, std::chrono::milliseconds(kFlushInterval), [this] {
+        return m_stop || m_wakeUp;
+      });
+      m_wakeUp = false;
+
+      lock.unlock();
+      flush();
+      lock.lock();
+    }
+  }
+
+  // Writes the messages of all rings with only one flush (m_drainMutex
+  // must be locked).
+  void drain_all()
+  {
+    std::vector<std::shared_ptr<log_ring>> rings;
+    {
+      const std::lock_guard lock(m_ringsMutex);
+      rings = m_rings;
+      // Remove rings of finished threads (after this drain they will
+      // be empty forever)
+      m_rings.erase(std::remove_if(m_rings.begin(),
+                                   m_rings.end(),
+                                   [](const auto& ring) { return ring->dead.load(); }),
+                    m_rings.end());
+    }
+
+    const std::lock_guard lock(log_mutex);
+    bool written = false;
+    for (auto& ring : rings)
+      written |= ring->drain();
+    if (written)
+      log_ostream->flush();
+  }
+
+  std::atomic<bool> m_enabled = false;
+  std::atomic<int> m_producers = 0;
+  std::atomic<bool> m_wakeUp = false;
+  bool m_stop = false;
+  std::thread m_thread;
+  std::mutex m_mutex;      // To wait in m_cv
+  std::mutex m_stateMutex; // To start/stop the thread
+  std::mutex m_drainMutex; // Only one consumer at the same time
+  std::mutex m_ringsMutex;
+  std::condition_variable m_cv;
+  std::vector<std::shared_ptr<log_ring>> m_rings;
+};
+
+// Defined after log_stream so it's destroyed before (writing the
+// pending messages).
+async_writer log_writer;
+
 } // anonymous namespace
 
 void base::set_log_filename(const char* filename)
 {
+  log_writer.flush();
+
+  const std::lock_guard lock(log_mutex);
   if (log_stream.is_open()) {
     log_stream.close();
     log_ostream = &std::cerr;
@@ -67,48 +296,74 @@ LogLevel base::get_log_level()
   return log_level;
 }
 
-static void LOGva(const char* format, va_list ap)
+void base::set_log_async(const bool state)
+{
+  if (state)
+    log_writer.start();
+  else
+    log_writer.stop();
+}
+
+bool base::is_log_async()
+{
+  return log_writer.enabled();
+}
+
+void base::flush_log()
+{
+  log_writer.flush();
+
+  const std::lock_guard lock(log_mutex);
+  log_ostream->flush();
+}
+
+static void LOGva(const LogLevel level, const char* format, va_list ap)
 {
+  // Format the message in the stack (most messages are small), and
+  // use the heap only for big messages.
+  char stackBuf[1024];
+  std::vector<char> heapBuf;
+  char* buf = stackBuf;
+
   va_list apTmp;
   va_copy(apTmp, ap);
-  const int size = std::vsnprintf(nullptr, 0, format, apTmp);
+  const int size = std::vsnprintf(stackBuf, sizeof(stackBuf), format, apTmp);
   va_end(apTmp);
   if (size < 1)
     return; // Nothing to log
 
-  std::vector<char> buf(size + 1);
-  std::vsnprintf(buf.data(), buf.size(), format, ap);
+  if (size_t(size) >= sizeof(stackBuf)) {
+    heapBuf.resize(size + 1);
+    std::vsnprintf(heapBuf.data(), heapBuf.size(), format, ap);
+    buf = heapBuf.data();
+  }
+
+  if (log_writer.push(buf, size)) {
+    // A fatal error must be in the log before we crash
+    if (level == FATAL)
+      base::flush_log();
+  }
+  else {
+    // Pending messages of this thread must be written first
+    if (log_writer.enabled())
+      log_writer.flush();
 
-  {
     const std::lock_guard lock(log_mutex);
-    ASSERT(log_ostream);
-    log_ostream->write(buf.data(), size);
+    write_log(buf, size);
     log_ostream->flush();
   }
 
 #ifdef _DEBUG
   #ifdef LAF_WINDOWS
-  ::OutputDebugStringA(buf.data());
+  ::OutputDebugStringA(buf);
   #else
-  fputs(buf.data(), stderr);
+  fputs(buf, stderr);
   fflush(stderr);
   #endif
 #endif
 }
 
-void LOG(const char* format, ...)
-{
-  ASSERT(format);
-  if (!format || log_level < INFO)
-    return;
-
-  va_list ap;
-  va_start(ap, format);
-  LOGva(format, ap);
-  va_end(ap);
-}
-
-void LOG(const LogLevel level, const char* format, ...)
+void base::log_print(const LogLevel level, const char* format, ...)
 {
   ASSERT(format);
   if (!format || log_level < level)
@@ -116,6 +371,6 @@ void LOG(const LogLevel level, const char* format, ...)
 
   va_list ap;
   va_start(ap, format);
-  LOGva(format, ap);
+  LOGva(level, format, ap);
   va_end(ap);
 }
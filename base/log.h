@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2020  Igara Studio S.A.
+// Copyright (c) 2020-2025  Igara Studio S.A.
 // Copyright (c) 2001-2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -27,8 +27,16 @@ enum LogLevel {
   VERBOSE = 5, // Information step by step
 };
 
+  // Maximum log level compiled in the program. LOG() calls with a
+  // greater level (constant) are removed at compile time. E.g. define
+  // LAF_LOG_MAX_LEVEL=3 to remove INFO and VERBOSE logs.
+  #ifndef LAF_LOG_MAX_LEVEL
+    #define LAF_LOG_MAX_LEVEL 5 // VERBOSE
+  #endif
+
   #ifdef __cplusplus
     #include <iosfwd>
+    #include <utility>
 
 namespace base {
 
@@ -36,21 +44,73 @@ void set_log_filename(const char* filename);
 void set_log_level(LogLevel level);
 LogLevel get_log_level();
 
-} // namespace base
+// When the asynchronous mode is enabled, LOG() formats the message
+// in a buffer of the calling thread and a background thread writes
+// all buffers to the log file in batches (one flush per batch
+// instead of one per line). Messages of each thread keep their
+// order, but messages of different threads can be interleaved in a
+// different order. FATAL messages flush the log immediately.
+void set_log_async(bool state);
+bool is_log_async();
+
+// Writes all pending messages (of the asynchronous mode) and
+// flushes the log file.
+void flush_log();
+
+// Function used by LOG() to format and write the message.
+void log_print(LogLevel level, const char* format, ...);
+
+namespace log_detail {
+
+// Level of a LOG() call from its first argument: LOG("text") uses
+// INFO, and LOG(level, "text") uses the given level.
+constexpr LogLevel level_of(const LogLevel level)
+{
+  return level;
+}
+constexpr LogLevel level_of(const char*)
+{
+  return INFO;
+}
+
+// This is in case LOG() is used with an integer value instead of
+// LogLevel, an error must be triggered (e.g. on wingdi.h ERROR is
+// defined as 0, and with this definition we avoid calling LOG(const
+// char* format=0=nullptr) and we detect the problem at compile time.
+LogLevel level_of(int) = delete;
 
-// E.g. LOG("text in information log level\n");
-void LOG(const char* format, ...);
-void LOG(LogLevel level, const char* format, ...);
+template<typename... Args>
+inline void print(const char* format, Args&&... args)
+{
+  log_print(INFO, format, std::forward<Args>(args)...);
+}
 
-inline void LOG(int)
+template<typename... Args>
+inline void print(const LogLevel level, const char* format, Args&&... args)
 {
-  // This is in case LOG() is used with an integer value instead of
-  // LogLevel, an error must be triggered (e.g. on wingdi.h ERROR is
-  // defined as 0, and with this definition we avoid calling LOG(const
-  // char* format=0=nullptr) and we detect the problem at compile
-  // time.
+  log_print(level, format, std::forward<Args>(args)...);
 }
 
+} // namespace log_detail
+} // namespace base
+
+    // Extra macro expansion needed for MSVC traditional preprocessor
+    #define LAF_LOG_EXPAND(x)           x
+    #define LAF_LOG_FIRST_ARG_(first, ...) first
+    #define LAF_LOG_FIRST_ARG(...)      LAF_LOG_EXPAND(LAF_LOG_FIRST_ARG_(__VA_ARGS__, 0))
+
+    // E.g. LOG("text in information log level\n");
+    //      LOG(ERROR, "text in error log level\n");
+    //
+    // It's a macro so the arguments are not evaluated when the level
+    // is greater than LAF_LOG_MAX_LEVEL.
+    #define LOG(...)                                                                 \
+      do {                                                                           \
+        if (base::log_detail::level_of(LAF_LOG_FIRST_ARG(__VA_ARGS__)) <=            \
+            LAF_LOG_MAX_LEVEL)                                                       \
+          base::log_detail::print(__VA_ARGS__);                                      \
+      } while (0)
+
   #endif
 
 #endif
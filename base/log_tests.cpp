@@ -0,0 +1,143 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+// Remove VERBOSE logs at compile time
+#define LAF_LOG_MAX_LEVEL 4
+#include "base/log.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace base;
+
+static const char* fn = "_test_log_.tmp";
+
+static std::string read_log()
+{
+  set_log_filename(nullptr);
+  std::ifstream f(fn);
+  std::stringstream s;
+  s << f.rdbuf();
+  return s.str();
+}
+
+TEST(Log, Levels)
+{
+  set_log_async(false);
+  set_log_filename(fn);
+  set_log_level(INFO);
+  LOG("a");
+  LOG(ERROR, "b%d", 1);
+  LOG(INFO, "c");
+  set_log_level(VERBOSE);
+  LOG(VERBOSE, "d"); // Removed at compile time
+  set_log_level(ERROR);
+  LOG(WARNING, "e");
+  EXPECT_EQ("ab1c", read_log());
+}
+
+TEST(Log, RemovedArgsAreNotEvaluated)
+{
+  set_log_async(false);
+  set_log_filename(fn);
+  set_log_level(VERBOSE);
+  int calls = 0;
+  auto arg = [&calls] {
+    ++calls;
+    return "x";
+  };
+  LOG(VERBOSE, "%s", arg()); // Removed at compile time
+  EXPECT_EQ(0, calls);
+  LOG(INFO, "%s", arg());
+  LOG("%s", arg());
+  EXPECT_EQ(2, calls);
+  EXPECT_EQ("xx", read_log());
+}
+
+TEST(Log, BigMessages)
+{
+  const std::string big(5000, 'x');
+  for (bool async : { false, true }) {
+    set_log_async(async);
+    set_log_filename(fn);
+    set_log_level(INFO);
+    LOG("a");
+    LOG("%s", big.c_str());
+    LOG("b");
+    set_log_async(false);
+    EXPECT_EQ("a" + big + "b", read_log());
+  }
+}
+
+TEST(Log, AsyncOrderPerThread)
+{
+  constexpr int kThreads = 4;
+  constexpr int kLines = 20000;
+
+  set_log_filename(fn);
+  set_log_level(INFO);
+  set_log_async(true);
+  EXPECT_TRUE(is_log_async());
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([t] {
+      for (int i = 0; i < kLines; ++i)
+        LOG(INFO, "%d %d\n", t, i);
+    });
+  }
+  for (auto& t : threads)
+    t.join();
+
+  set_log_async(false);
+  EXPECT_FALSE(is_log_async());
+
+  std::istringstream s(read_log());
+  std::vector<int> next(kThreads, 0);
+  int t, i, lines = 0;
+  while (s >> t >> i) {
+    ASSERT_TRUE(t >= 0 && t < kThreads);
+    EXPECT_EQ(next[t], i);
+    next[t] = i + 1;
+    ++lines;
+  }
+  EXPECT_EQ(kThreads * kLines, lines);
+}
+
+TEST(Log, AsyncFatalFlush)
+{
+  set_log_filename(fn);
+  set_log_level(INFO);
+  set_log_async(true);
+  LOG(INFO, "a");
+  LOG(FATAL, "b");
+
+  // The fatal message (and the previous ones) must be in the file
+  // without waiting the writer thread.
+  {
+    std::ifstream f(fn);
+    std::stringstream s;
+    s << f.rdbuf();
+    EXPECT_EQ("ab", s.str());
+  }
+
+  set_log_async(false);
+  EXPECT_EQ("ab", read_log());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  const int result = RUN_ALL_TESTS();
+  std::remove(fn);
+  return result;
+}
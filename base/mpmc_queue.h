@@ -0,0 +1,189 @@
+// LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_MPMC_QUEUE_H_INCLUDED
+#define BASE_MPMC_QUEUE_H_INCLUDED
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace base {
+
+// Lock-free bounded multi-producer/multi-consumer queue (Dmitry
+// Vyukov's ring buffer). Each cell has a sequence number that tells
+// if the cell is ready to be written (seq == pos) or read (seq ==
+// pos+1), so producers and consumers only compete for the head/tail
+// indexes with a CAS.
+//
+// Capacity must be a power of two. push() waits (yielding the
+// thread) while the queue is full, use try_push() if you don't want
+// to wait.
+template<typename T, size_t Capacity>
+class mpmc_queue {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "mpmc_queue capacity must be a power of two");
+
+public:
+  mpmc_queue() : m_cells(new cell[Capacity]), m_waiters(0)
+  {
+    for (size_t i = 0; i < Capacity; ++i)
+      m_cells[i].seq.store(i, std::memory_order_relaxed);
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+  }
+  mpmc_queue(const mpmc_queue&) = delete;
+  mpmc_queue& operator=(const mpmc_queue&) = delete;
+  ~mpmc_queue() {}
+
+  static constexpr size_t capacity() { return Capacity; }
+
+  bool empty() const
+  {
+    const size_t pos = m_tail.load(std::memory_order_relaxed);
+    const cell& c = m_cells[pos & kMask];
+    return (c.seq.load(std::memory_order_acquire) != pos + 1);
+  }
+
+  // Approximated number of elements (other threads can be pushing
+  // or popping elements concurrently).
+  size_t size() const
+  {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    return (head > tail ? head - tail : 0);
+  }
+
+  void clear()
+  {
+    T value;
+    while (try_pop(value))
+      ;
+  }
+
+  void push(const T& value)
+  {
+    T copy(value);
+    while (!try_push(std::move(copy)))
+      std::this_thread::yield();
+  }
+
+  bool try_push(const T& value)
+  {
+    T copy(value);
+    return try_push(std::move(copy));
+  }
+
+  bool try_push(T&& value)
+  {
+    size_t pos = m_head.load(std::memory_order_relaxed);
+    cell* c;
+    for (;;) {
+      c = &m_cells[pos & kMask];
+      const size_t seq = c->seq.load(std::memory_order_acquire);
+      const intptr_t diff = intptr_t(seq) - intptr_t(pos);
+      if (diff == 0) {
+        if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if (diff < 0) {
+        return false; // Full
+      }
+      else {
+        pos = m_head.load(std::memory_order_relaxed);
+      }
+    }
+    c->value = std::move(value);
+    c->seq.store(pos + 1, std::memory_order_release);
+
+    // Wake up a consumer waiting in pop()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_waiters.load(std::memory_order_relaxed) > 0) {
+      const std::lock_guard lock(m_mutex);
+      m_cv.notify_one();
+    }
+    return true;
+  }
+
+  // Never fails spuriously, returns false only if the queue is
+  // empty.
+  bool try_pop(T& value)
+  {
+    size_t pos = m_tail.load(std::memory_order_relaxed);
+    cell* c;
+    for (;;) {
+      c = &m_cells[pos & kMask];
+      const size_t seq = c->seq.load(std::memory_order_acquire);
+      const intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+      if (diff == 0) {
+        if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if (diff < 0) {
+        return false; // Empty
+      }
+      else {
+        pos = m_tail.load(std::memory_order_relaxed);
+      }
+    }
+    value = std::move(c->value);
+    c->seq.store(pos + Capacity, std::memory_order_release);
+    return true;
+  }
+
+  // Waits until there is an element to pop or the timeout (in
+  // seconds) is reached. Returns false in case of timeout.
+  bool pop(T& value, const double timeout)
+  {
+    if (try_pop(value))
+      return true;
+
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::duration<double>(timeout);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    ++m_waiters;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool result;
+    while (!(result = try_pop(value))) {
+      if (m_cv.wait_until(lock, deadline) == std::cv_status::timeout) {
+        result = try_pop(value);
+        break;
+      }
+    }
+    --m_waiters;
+    return result;
+  }
+
+private:
+  static constexpr size_t kMask = Capacity - 1;
+
+  struct cell {
+    std::atomic<size_t> seq;
+    T value;
+  };
+
+  std::unique_ptr<cell[]> m_cells;
+
+  // Indexes in different cache lines to avoid false sharing between
+  // producers and consumers.
+  alignas(64) std::atomic<size_t> m_head; // Next position to push
+  alignas(64) std::atomic<size_t> m_tail; // Next position to pop
+
+  // Used only to wait elements in pop()
+  alignas(64) std::atomic<int> m_waiters;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+};
+
+} // namespace base
+
+#endif
@@ -0,0 +1,224 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_PARALLEL_H_INCLUDED
+#define BASE_PARALLEL_H_INCLUDED
+#pragma once
+
+#include "base/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace base {
+
+namespace details {
+
+// State shared between the caller and the helper works of one
+// parallel_for/parallel_reduce call. Helpers keep a reference to this
+// state (not to the caller stack) so the caller doesn't need to wait
+// helpers that didn't start yet (e.g. because the pool is busy with
+// jobs from other subsystems): when they start they will not find
+// more chunks to process and will finish immediately.
+template<typename Index>
+class parallel_state {
+public:
+  parallel_state(const Index begin, const Index end, const Index grain, const int participants)
+    : m_next(begin)
+    , m_end(end)
+    , m_grain(grain)
+    , m_participants(participants)
+    , m_remaining(end - begin)
+  {
+  }
+
+  // Gets the next chunk [from, to) to be processed. Chunks are
+  // bigger at the beginning and get smaller (but never smaller than
+  // the grain) as we approach the end of the range to balance the
+  // load between participants.
+  bool next(Index& from, Index& to)
+  {
+    Index i = m_next.load(std::memory_order_relaxed);
+    while (i < m_end) {
+      const Index left = m_end - i;
+      const Index n = std::min(left, std::max(m_grain, Index(left / (2 * m_participants))));
+      if (m_next.compare_exchange_weak(i, i + n)) {
+        from = i;
+        to = i + n;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Runs chunks until there are no more. "body" is called only for
+  // chunks taken by this participant, so it's safe to use references
+  // to the caller stack inside it.
+  template<typename Body>
+  void run(const Body& body)
+  {
+    Index from, to;
+    while (next(from, to)) {
+      try {
+        body(from, to);
+      }
+      catch (...) {
+        set_error(std::current_exception());
+      }
+      done(to - from);
+    }
+  }
+
+  // Waits all chunks to be processed (not all helpers to finish).
+  void wait()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() -> bool { return m_remaining == 0; });
+    if (m_error)
+      std::rethrow_exception(m_error);
+  }
+
+private:
+  void done(const Index n)
+  {
+    if (m_remaining.fetch_sub(n) == n) {
+      const std::lock_guard lock(m_mutex);
+      m_cv.notify_all();
+    }
+  }
+
+  void set_error(std::exception_ptr&& error)
+  {
+    {
+      const std::lock_guard lock(m_mutex);
+      if (!m_error)
+        m_error = std::move(error);
+    }
+    // Skip all the chunks that weren't started
+    const Index i = m_next.exchange(m_end);
+    if (i < m_end)
+      done(m_end - i);
+  }
+
+  std::atomic<Index> m_next;
+  const Index m_end;
+  const Index m_grain;
+  const int m_participants;
+  std::atomic<Index> m_remaining;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::exception_ptr m_error;
+};
+
+// Calls body(participant, from, to) for each chunk of [begin, end)
+// in the caller thread and in the given pool, and waits only for the
+// chunks of this call. "participant" is 0 for the caller thread, and
+// 1...N for helpers in the pool.
+template<typename Index, typename Body>
+void parallel_run(thread_pool& pool, const Index begin, const Index end, Index grain, Body&& body)
+{
+  static_assert(std::is_integral_v<Index>, "parallel_for() needs an integral index");
+
+  if (begin >= end)
+    return;
+
+  const Index total = end - begin;
+  const int threads = int(pool.size()) + 1;
+  if (grain < 1)
+    grain = std::max(Index(1), Index(total / (threads * 4)));
+
+  const Index chunks = (total + grain - 1) / grain;
+  const int helpers = int(std::min(Index(threads - 1), Index(chunks - 1)));
+  if (helpers <= 0) {
+    body(0, begin, end);
+    return;
+  }
+
+  auto state = std::make_shared<parallel_state<Index>>(begin, end, grain, helpers + 1);
+  for (int i = 1; i <= helpers; ++i) {
+    pool.execute([state, &body, i] {
+      state->run([&body, i](const Index from, const Index to) { body(i, from, to); });
+    });
+  }
+
+  state->run([&body](const Index from, const Index to) { body(0, from, to); });
+  state->wait();
+}
+
+} // namespace details
+
+// Calls func(from, to) for subranges of [begin, end) in parallel
+// using the given thread pool and the caller thread. Subranges
+// contain at least "grain" elements (except the last one), a grain
+// <= 0 chooses a grain automatically. Returns when the whole range
+// was processed, without waiting for other jobs in the pool, so
+// several subsystems can share the same pool. If func() throws, the
+// remaining subranges are skipped and the exception is re-thrown in
+// the caller thread.
+//
+// Example:
+//
+//   base::parallel_for(pool, 0, h, 16, [&](int y0, int y1) {
+//     for (int y = y0; y < y1; ++y)
+//       process_row(y);
+//   });
+//
+template<typename Index, typename Func>
+void parallel_for(thread_pool& pool, const Index begin, const Index end, const Index grain, Func&& func)
+{
+  details::parallel_run(pool,
+                        begin,
+                        end,
+                        grain,
+                        [&func](int, const Index from, const Index to) { func(from, to); });
+}
+
+// Reduces the [begin, end) range in parallel. func(from, to) must
+// return the value of the given subrange, and reduce(a, b) must
+// combine two values (it must be associative and commutative, as
+// subranges are not combined in a specific order). "identity" is the
+// neutral value for reduce().
+//
+// Example:
+//
+//   int sum = base::parallel_reduce(
+//     pool, 0, n, 0, 0,
+//     [&](int i, int j) { return std::accumulate(v+i, v+j, 0); },
+//     std::plus<int>());
+//
+template<typename Index, typename T, typename Func, typename Reduce>
+T parallel_reduce(thread_pool& pool,
+                  const Index begin,
+                  const Index end,
+                  const Index grain,
+                  const T& identity,
+                  Func&& func,
+                  Reduce&& reduce)
+{
+  std::vector<T> partials(pool.size() + 1, identity);
+  details::parallel_run(pool,
+                        begin,
+                        end,
+                        grain,
+                        [&func, &reduce, &partials](int i, const Index from, const Index to) {
+                          partials[i] = reduce(partials[i], func(from, to));
+                        });
+
+  T result = identity;
+  for (const T& v : partials)
+    result = reduce(result, v);
+  return result;
+}
+
+} // namespace base
+
+#endif
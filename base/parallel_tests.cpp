@@ -0,0 +1,114 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/parallel.h"
+#include "base/thread_pool.h"
+
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+using namespace base;
+
+TEST(Parallel, For)
+{
+  thread_pool p(4);
+  std::vector<int> v(10000, 0);
+  parallel_for(p, 0, int(v.size()), 16, [&v](int i, int j) {
+    for (; i < j; ++i)
+      ++v[i];
+  });
+  for (int i : v)
+    EXPECT_EQ(1, i);
+}
+
+TEST(Parallel, ForEmptyAndSmallRanges)
+{
+  thread_pool p(4);
+  std::atomic<int> c(0);
+  parallel_for(p, 10, 10, 1, [&c](int i, int j) { c += j - i; });
+  EXPECT_EQ(0, c);
+  parallel_for(p, 10, 11, 1, [&c](int i, int j) { c += j - i; });
+  EXPECT_EQ(1, c);
+  parallel_for(p, 0, 100, 0, [&c](int i, int j) { c += j - i; });
+  EXPECT_EQ(101, c);
+}
+
+TEST(Parallel, Reduce)
+{
+  thread_pool p(4);
+  std::vector<int64_t> v(100000);
+  for (size_t i = 0; i < v.size(); ++i)
+    v[i] = i;
+
+  const int64_t sum = parallel_reduce(
+    p,
+    size_t(0),
+    v.size(),
+    size_t(100),
+    int64_t(0),
+    [&v](size_t i, size_t j) {
+      int64_t s = 0;
+      for (; i < j; ++i)
+        s += v[i];
+      return s;
+    },
+    std::plus<int64_t>());
+  EXPECT_EQ(int64_t(v.size()) * (v.size() - 1) / 2, sum);
+}
+
+// A parallel_for() must not wait for unrelated jobs of the same pool.
+TEST(Parallel, DoesntWaitOtherJobs)
+{
+  thread_pool p(2);
+  std::atomic<bool> go(false);
+  p.execute([&go] {
+    while (!go)
+      std::this_thread::yield();
+  });
+
+  std::atomic<int> c(0);
+  parallel_for(p, 0, 1000, 1, [&c](int i, int j) { c += j - i; });
+  EXPECT_EQ(1000, c);
+
+  go = true;
+  p.wait_all();
+}
+
+TEST(Parallel, Nested)
+{
+  thread_pool p(4, thread_pool::mode::WORK_STEALING);
+  std::atomic<int> c(0);
+  parallel_for(p, 0, 100, 1, [&p, &c](int i, int j) {
+    for (; i < j; ++i)
+      parallel_for(p, 0, 100, 1, [&c](int k, int l) { c += l - k; });
+  });
+  EXPECT_EQ(10000, c);
+}
+
+TEST(Parallel, Exception)
+{
+  thread_pool p(4);
+  EXPECT_THROW(parallel_for(p,
+                            0,
+                            1000,
+                            1,
+                            [](int i, int j) {
+                              if (i <= 500 && 500 < j)
+                                throw std::runtime_error("error");
+                            }),
+               std::runtime_error);
+  p.wait_all();
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
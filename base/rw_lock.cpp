@@ -12,7 +12,6 @@
 #include "base/rw_lock.h"
 
 #include "base/debug.h"
-#include "base/thread.h"
 
 #include <algorithm>
 
@@ -22,6 +21,25 @@
 
 namespace base {
 
+namespace {
+
+// Each thread uses a different read slot (round-robin).
+std::atomic<int> g_next_slot(0);
+thread_local int t_slot = -1;
+
+// Counts the current thread as waiting for the lock while this
+// object is alive, so unlocking readers will notify us.
+class ScopedWaiting {
+public:
+  ScopedWaiting(std::atomic<int>& waiting) : m_waiting(waiting) { ++m_waiting; }
+  ~ScopedWaiting() { --m_waiting; }
+
+private:
+  std::atomic<int>& m_waiting;
+};
+
+} // anonymous namespace
+
 RWLock::RWLock()
 {
 }
@@ -30,7 +48,7 @@ RWLock::~RWLock()
 {
   ASSERT(!m_write_lock);
   ASSERT(m_write_thread == std::thread::id());
-  ASSERT(m_read_locks == 0);
+  ASSERT(readLocks() == 0);
   ASSERT(m_weak_lock == nullptr);
 }
 
@@ -45,80 +63,66 @@ bool RWLock::canWriteLockFromRead() const
   }
   // If only we are reading (one lock) and nobody is writing, we can
   // lock for writing..
-  return (m_read_locks == 1 && !m_write_lock);
+  return (readLocks() == 1 && !m_write_lock);
 }
 
 RWLock::LockResult RWLock::lock(LockType lockType, int timeout)
 {
+  // Fast path for readers: if nobody is writing, we can just
+  // increment our read counter (no need to check for re-entrant
+  // locks as there is no writer).
+  if (lockType == ReadLock && !m_writer) {
+    ReadSlot& slot = readSlot();
+    ++slot.count;
+    if (!m_writer)
+      return LockResult::OK;
+
+    // A writer appeared in the middle, undo the read lock and go to
+    // the slow path.
+    readUnlock();
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(std::max(0, timeout));
+  std::unique_lock lock(m_mutex);
+
   // Check for re-entrant write locks (multiple write-lock in the same
   // thread are allowed, even a read lock if we are writing in the
   // same thread).
-  // if (lockType == WriteLock) {
-  {
-    const std::lock_guard lock(m_mutex);
-    if (m_write_lock && m_write_thread == std::this_thread::get_id()) {
-      return LockResult::Reentrant;
-    }
+  if (m_write_lock && m_write_thread == std::this_thread::get_id()) {
+    return LockResult::Reentrant;
   }
 
-  while (timeout >= 0) {
-    {
-      const std::lock_guard lock(m_mutex);
-
-      switch (lockType) {
-        case ReadLock:
-          // If no body is writing the object...
-          if (!m_write_lock) {
-            // We can read it
-            ++m_read_locks;
-            return LockResult::OK;
-          }
-          break;
-
-        case WriteLock:
-          // Check that there is no weak lock
-          if (m_weak_lock) {
-            if (*m_weak_lock == WeakLocked)
-              *m_weak_lock = WeakUnlocking;
-
-            if (*m_weak_lock == WeakUnlocking)
-              goto go_wait;
-
-            ASSERT(*m_weak_lock == WeakUnlocked);
-          }
-
-          // If no body is reading and writing...
-          if (m_read_locks == 0 && !m_write_lock) {
-            // We can start writing the object...
-            m_write_lock = true;
-            m_write_thread = std::this_thread::get_id();
-
-            LCK_TRACE("LCK: lock: Locked", this, "to write in thread", m_write_thread);
-            return LockResult::OK;
-          }
-          break;
-      }
-
-    go_wait:;
+  const ScopedWaiting waiting(m_waiting);
+  do {
+    switch (lockType) {
+      case ReadLock:
+        // If no body is writing the object...
+        if (!m_write_lock) {
+          // We can read it (writers check read counters with m_mutex
+          // locked, so it's safe to increment it here)
+          ++readSlot().count;
+          return LockResult::OK;
+        }
+        break;
+
+      case WriteLock:
+        if (tryWriteLock(false)) {
+          LCK_TRACE("LCK: lock: Locked", this, "to write in thread", m_write_thread);
+          return LockResult::OK;
+        }
+        break;
     }
 
-    if (timeout > 0) {
-      const int delay = std::min(100, timeout);
-      timeout -= delay;
-
-      LCK_TRACE("LCK: lock: wait 100 msecs for", this);
-      base::this_thread::sleep_for(double(delay) / 1000.0);
-    }
-    else
-      break;
-  }
+    LCK_TRACE("LCK: lock: wait for", this);
+  } while (timeout > 0 && waitUntil(lock, deadline));
 
   LCK_TRACE("LCK: lock: Cannot lock",
             this,
             "to",
             (lockType == ReadLock ? "read" : "write"),
             "(has",
-            m_read_locks,
+            readLocks(),
             "read locks and",
             m_write_lock,
             "write locks)");
@@ -132,12 +136,14 @@ void RWLock::downgradeToRead(LockResult lockResult)
 
   const std::lock_guard lock(m_mutex);
 
-  ASSERT(m_read_locks == 0);
+  ASSERT(readLocks() == 0);
   ASSERT(m_write_lock);
 
   m_write_lock = false;
   m_write_thread = std::thread::id();
-  m_read_locks = 1;
+  ++readSlot().count;
+  m_writer = false;
+  m_cv.notify_all();
 }
 
 void RWLock::unlock(LockResult lockResult)
@@ -145,14 +151,24 @@ void RWLock::unlock(LockResult lockResult)
   if (lockResult != LockResult::OK)
     return; // Do nothing for failed or reentrant locks
 
+  // Fast path for readers: if there is no writer this must be a read
+  // lock.
+  if (!m_writer) {
+    readUnlock();
+    return;
+  }
+
   const std::lock_guard lock(m_mutex);
 
   if (m_write_lock) {
     m_write_lock = false;
     m_write_thread = std::thread::id();
+    m_writer = false;
+    m_cv.notify_all();
   }
-  else if (m_read_locks > 0) {
-    --m_read_locks;
+  else if (readLocks() > 0) {
+    --readSlot().count;
+    m_cv.notify_all();
   }
   else {
     ASSERT(false);
@@ -182,65 +198,37 @@ void RWLock::weakUnlock()
   if (m_weak_lock) {
     *m_weak_lock = WeakLock::WeakUnlocked;
     m_weak_lock = nullptr;
+    m_cv.notify_all();
   }
 }
 
 RWLock::LockResult RWLock::upgradeToWrite(int timeout)
 {
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(std::max(0, timeout));
+  std::unique_lock lock(m_mutex);
+
   // Check for re-entrant upgrade to write (multiple write-lock in the
   // same thread are allowed).
-  {
-    const std::lock_guard lock(m_mutex);
-    if (m_write_lock && m_write_thread == std::this_thread::get_id()) {
-      return LockResult::Reentrant;
-    }
+  if (m_write_lock && m_write_thread == std::this_thread::get_id()) {
+    return LockResult::Reentrant;
   }
 
-  while (timeout >= 0) {
-    {
-      const std::lock_guard lock(m_mutex);
-
-      // Check that there is no weak lock
-      if (m_weak_lock) {
-        if (*m_weak_lock == WeakLocked)
-          *m_weak_lock = WeakUnlocking;
-
-        // Wait some time
-        if (*m_weak_lock == WeakUnlocking)
-          goto go_wait;
-
-        ASSERT(*m_weak_lock == WeakUnlocked);
-      }
-
-      // this only is possible if there are just one reader
-      if (m_read_locks == 1) {
-        ASSERT(!m_write_lock);
-        m_read_locks = 0;
-        m_write_lock = true;
-        m_write_thread = std::this_thread::get_id();
-
-        LCK_TRACE("LCK: upgradeToWrite: Locked", this, "to write in thread", m_write_thread);
-        return LockResult::OK;
-      }
-
-    go_wait:;
+  const ScopedWaiting waiting(m_waiting);
+  do {
+    // this only is possible if there are just one reader
+    if (tryWriteLock(true)) {
+      LCK_TRACE("LCK: upgradeToWrite: Locked", this, "to write in thread", m_write_thread);
+      return LockResult::OK;
     }
 
-    if (timeout > 0) {
-      const int delay = std::min(100, timeout);
-      timeout -= delay;
-
-      LCK_TRACE("LCK: upgradeToWrite: wait 100 msecs for", this);
-      base::this_thread::sleep_for(double(delay) / 1000.0);
-    }
-    else
-      break;
-  }
+    LCK_TRACE("LCK: upgradeToWrite: wait for", this);
+  } while (timeout > 0 && waitUntil(lock, deadline));
 
   LCK_TRACE("LCK: upgradeToWrite: Cannot lock",
             this,
             "to write (has",
-            m_read_locks,
+            readLocks(),
             "read locks and",
             m_write_lock,
             "write locks)");
@@ -257,4 +245,75 @@ void RWLock::updateWriterThread()
   }
 }
 
+int RWLock::readLocks() const
+{
+  int n = 0;
+  for (const ReadSlot& slot : m_read_slots)
+    n += slot.count;
+  return n;
+}
+
+RWLock::ReadSlot& RWLock::readSlot()
+{
+  if (t_slot < 0)
+    t_slot = (g_next_slot++ % kReadSlots);
+  return m_read_slots[t_slot];
+}
+
+bool RWLock::tryWriteLock(const bool upgrade)
+{
+  // Check that there is no weak lock
+  if (m_weak_lock) {
+    if (*m_weak_lock == WeakLocked)
+      *m_weak_lock = WeakUnlocking;
+
+    // Wait until the weak lock is released
+    if (*m_weak_lock == WeakUnlocking)
+      return false;
+
+    ASSERT(*m_weak_lock == WeakUnlocked);
+  }
+
+  if (m_write_lock)
+    return false;
+
+  // Avoid new readers in the fast path while we check the read
+  // counters. As m_waiting was incremented before this check,
+  // readers unlocking from now on will wake us up if we cannot lock
+  // now.
+  ASSERT(m_waiting > 0);
+  m_writer = true;
+
+  const int readers = readLocks();
+  if (readers == (upgrade ? 1 : 0)) {
+    if (upgrade)
+      --readSlot().count;
+
+    m_write_lock = true;
+    m_write_thread = std::this_thread::get_id();
+    return true;
+  }
+
+  // Readers can continue using the fast path (reader-biased lock).
+  m_writer = false;
+  return false;
+}
+
+bool RWLock::waitUntil(std::unique_lock<std::mutex>& lock,
+                       const std::chrono::steady_clock::time_point& deadline)
+{
+  return (m_cv.wait_until(lock, deadline) == std::cv_status::no_timeout);
+}
+
+void RWLock::readUnlock()
+{
+  --readSlot().count;
+
+  // Wake up writers waiting for readers
+  if (m_waiting > 0) {
+    const std::lock_guard lock(m_mutex);
+    m_cv.notify_all();
+  }
+}
+
 } // namespace base
@@ -12,12 +12,21 @@
 #include "base/disable_copying.h"
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 #include <thread>
 
 namespace base {
 
-// A readers-writer lock implementation
+// A readers-writer lock implementation.
+//
+// It's reader-biased: readers are only blocked by an active writer
+// (not by writers waiting to lock the object). Read locks use a
+// fast path without locking the mutex, incrementing one of several
+// counters (one per cache line) selected by thread, so readers in
+// different threads don't compete for the same cache line. Threads
+// wait for the lock using a condition variable instead of sleeping.
 class RWLock {
 public:
   enum LockType { ReadLock, WriteLock };
@@ -78,15 +87,52 @@ public:
   void weakUnlock();
 
 private:
+  // Number of counters for read locks.
+  static constexpr int kReadSlots = 8;
+
+  struct alignas(64) ReadSlot {
+    std::atomic<int> count = 0;
+  };
+
+  // Total number of read locks.
+  int readLocks() const;
+
+  // Slot used by the current thread.
+  ReadSlot& readSlot();
+
+  // Locks the object for writing (m_mutex must be locked) if it's
+  // possible. When "upgrade" is true, the current thread must have
+  // one read lock that will be converted to a write lock.
+  bool tryWriteLock(bool upgrade);
+
+  // Waits until there is some change in the lock state or until the
+  // timeout is reached (m_waiting must be incremented). Returns false
+  // in case of timeout.
+  bool waitUntil(std::unique_lock<std::mutex>& lock,
+                 const std::chrono::steady_clock::time_point& deadline);
+
+  // Releases a read lock and wakes up waiting writers.
+  void readUnlock();
+
   // Mutex to modify the 'locked' flag.
   mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
 
   // True if some thread is writing the object.
   bool m_write_lock = false;
   std::thread::id m_write_thread = {};
 
-  // Greater than zero when one or more threads are reading the object.
-  int m_read_locks = 0;
+  // True when some thread is write-locking the object (or is
+  // checking if it can be locked). Readers can take the fast path
+  // only when this is false.
+  std::atomic<bool> m_writer = false;
+
+  // Number of threads waiting in m_cv.
+  std::atomic<int> m_waiting = 0;
+
+  // Counters of read locks. The sum of all counters is the number of
+  // threads reading the object.
+  ReadSlot m_read_slots[kReadSlots];
 
   // If this isn' nullptr, it means that it points to an unique
   // "weak" lock that can be unlocked from other thread. E.g. the
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2020 Igara Studio S.A.
+// Copyright (c) 2020-2025 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -7,9 +7,12 @@
 
 #include <gtest/gtest.h>
 
+#include "base/chrono.h"
 #include "base/rw_lock.h"
 
+#include <cstdio>
 #include <thread>
+#include <vector>
 
 using namespace base;
 using LockResult = RWLock::LockResult;
@@ -105,6 +108,95 @@ TEST(RWLock, WeakLock)
   a.unlock(res[0]); // Unlock the write lock
 }
 
+TEST(RWLock, WaitReaders)
+{
+  RWLock a;
+  LockResult res;
+  EXPECT_OK(res = a.lock(RWLock::ReadLock, 0));
+
+  std::thread t([&a] {
+    // This must wait until the read lock is released
+    LockResult r;
+    EXPECT_OK(r = a.lock(RWLock::WriteLock, 10000));
+    a.unlock(r);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  a.unlock(res);
+  t.join();
+}
+
+TEST(RWLock, WaitWriter)
+{
+  RWLock a;
+  LockResult res;
+  EXPECT_OK(res = a.lock(RWLock::WriteLock, 0));
+  BGTHREAD(EXPECT_FAIL(a.lock(RWLock::ReadLock, 10)));
+
+  std::thread t([&a] {
+    // This must wait until the write lock is released
+    LockResult r;
+    EXPECT_OK(r = a.lock(RWLock::ReadLock, 10000));
+    a.unlock(r);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  a.unlock(res);
+  t.join();
+}
+
+TEST(RWLock, ReadersAndWriters)
+{
+  RWLock a;
+  int x = 0, y = 0;
+  std::vector<std::thread> v;
+  for (int i = 0; i < 8; ++i) {
+    v.emplace_back([&a, &x, &y, i] {
+      for (int j = 0; j < 2000; ++j) {
+        if ((i & 1) == 0) {
+          const LockResult r = a.lock(RWLock::WriteLock, 10000);
+          EXPECT_OK(r);
+          ++x;
+          ++y;
+          a.unlock(r);
+        }
+        else {
+          const LockResult r = a.lock(RWLock::ReadLock, 10000);
+          EXPECT_OK(r);
+          EXPECT_EQ(x, y);
+          a.unlock(r);
+        }
+      }
+    });
+  }
+  for (auto& t : v)
+    t.join();
+  EXPECT_EQ(8000, x);
+}
+
+// Benchmark of read locks from 1 to N threads, disabled by default
+// (run it with --gtest_also_run_disabled_tests).
+TEST(RWLock, DISABLED_ReadersScaling)
+{
+  const int n = 200000;
+  const int maxThreads = std::max(1, int(std::thread::hardware_concurrency()));
+  for (int threads = 1; threads <= maxThreads; threads *= 2) {
+    RWLock a;
+    std::vector<std::thread> v;
+    Chrono chrono;
+    for (int i = 0; i < threads; ++i) {
+      v.emplace_back([&a, n] {
+        for (int j = 0; j < n; ++j) {
+          const LockResult r = a.lock(RWLock::ReadLock, 0);
+          EXPECT_OK(r);
+          a.unlock(r);
+        }
+      });
+    }
+    for (auto& t : v)
+      t.join();
+    std::printf("%2d readers: %.0f read locks/sec\n", threads, threads * n / chrono.elapsed());
+  }
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
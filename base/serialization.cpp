@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -10,10 +11,72 @@
 
 #include "base/serialization.h"
 
+#include "base/endian.h"
+
+#include <cstring>
 #include <iostream>
 
 namespace base { namespace serialization {
 
+namespace {
+
+// Values are read/written with one read()/write() call instead of
+// one get()/put() per byte.
+
+template<typename T, endian E>
+std::ostream& write_value(std::ostream& os, const T value)
+{
+  uint8_t buf[sizeof(T)];
+  store<T>(buf, value, E);
+  os.write((const char*)buf, sizeof(T));
+  return os;
+}
+
+template<typename T, endian E>
+T read_value(std::istream& is)
+{
+  uint8_t buf[sizeof(T)];
+  if (!is.read((char*)buf, sizeof(T)))
+    std::memset(buf + is.gcount(), 0xff, sizeof(T) - is.gcount()); // EOF
+  return load<T>(buf, E);
+}
+
+template<endian E>
+std::ostream& write_float(std::ostream& os, const float value)
+{
+  uint32_t v;
+  std::memcpy(&v, &value, sizeof(v));
+  return write_value<uint32_t, E>(os, v);
+}
+
+template<endian E>
+std::ostream& write_double(std::ostream& os, const double value)
+{
+  uint64_t v;
+  std::memcpy(&v, &value, sizeof(v));
+  return write_value<uint64_t, E>(os, v);
+}
+
+template<endian E>
+float read_float(std::istream& is)
+{
+  const uint32_t v = read_value<uint32_t, E>(is);
+  float f;
+  std::memcpy(&f, &v, sizeof(f));
+  return f;
+}
+
+template<endian E>
+double read_double(std::istream& is)
+{
+  const uint64_t v = read_value<uint64_t, E>(is);
+  double d;
+  std::memcpy(&d, &v, sizeof(d));
+  return d;
+}
+
+} // anonymous namespace
+
 std::ostream& write8(std::ostream& os, uint8_t byte)
 {
   os.put(byte);
@@ -27,232 +90,102 @@ uint8_t read8(std::istream& is)
 
 std::ostream& little_endian::write16(std::ostream& os, uint16_t word)
 {
-  os.put((int)((word & 0x00ff)));
-  os.put((int)((word & 0xff00) >> 8));
-  return os;
+  return write_value<uint16_t, endian::little>(os, word);
 }
 
 std::ostream& little_endian::write32(std::ostream& os, uint32_t dword)
 {
-  os.put((int)((dword & 0x000000ffl)));
-  os.put((int)((dword & 0x0000ff00l) >> 8));
-  os.put((int)((dword & 0x00ff0000l) >> 16));
-  os.put((int)((dword & 0xff000000l) >> 24));
-  return os;
+  return write_value<uint32_t, endian::little>(os, dword);
 }
 
 std::ostream& little_endian::write64(std::ostream& os, uint64_t qword)
 {
-  os.put((int)((qword & 0x00000000000000ffl)));
-  os.put((int)((qword & 0x000000000000ff00l) >> 8));
-  os.put((int)((qword & 0x0000000000ff0000l) >> 16));
-  os.put((int)((qword & 0x00000000ff000000l) >> 24));
-  os.put((int)((qword & 0x000000ff00000000l) >> 32));
-  os.put((int)((qword & 0x0000ff0000000000l) >> 40));
-  os.put((int)((qword & 0x00ff000000000000l) >> 48));
-  os.put((int)((qword & 0xff00000000000000l) >> 56));
-  return os;
+  return write_value<uint64_t, endian::little>(os, qword);
 }
 
 std::ostream& little_endian::write_float(std::ostream& os, float value)
 {
-  const int b = *(reinterpret_cast<int*>(&value));
-  os.put((int)((b & 0x000000ffl)));
-  os.put((int)((b & 0x0000ff00l) >> 8));
-  os.put((int)((b & 0x00ff0000l) >> 16));
-  os.put((int)((b & 0xff000000l) >> 24));
-  return os;
+  return serialization::write_float<endian::little>(os, value);
 }
 
 std::ostream& little_endian::write_double(std::ostream& os, double value)
 {
-  const long long b = *(reinterpret_cast<long long*>(&value));
-  os.put((int)((b & 0x00000000000000ffl)));
-  os.put((int)((b & 0x000000000000ff00l) >> 8));
-  os.put((int)((b & 0x0000000000ff0000l) >> 16));
-  os.put((int)((b & 0x00000000ff000000l) >> 24));
-  os.put((int)((b & 0x000000ff00000000l) >> 32));
-  os.put((int)((b & 0x0000ff0000000000l) >> 40));
-  os.put((int)((b & 0x00ff000000000000l) >> 48));
-  os.put((int)((b & 0xff00000000000000l) >> 56));
-  return os;
+  return serialization::write_double<endian::little>(os, value);
 }
 
 uint16_t little_endian::read16(std::istream& is)
 {
-  int b1, b2;
-  b1 = is.get();
-  b2 = is.get();
-  return ((b2 << 8) | b1);
+  return read_value<uint16_t, endian::little>(is);
 }
 
 uint32_t little_endian::read32(std::istream& is)
 {
-  int b1, b2, b3, b4;
-  b1 = is.get();
-  b2 = is.get();
-  b3 = is.get();
-  b4 = is.get();
-  return ((b4 << 24) | (b3 << 16) | (b2 << 8) | b1);
+  return read_value<uint32_t, endian::little>(is);
 }
 
 uint64_t little_endian::read64(std::istream& is)
 {
-  int b1, b2, b3, b4, b5, b6, b7, b8;
-  b1 = is.get();
-  b2 = is.get();
-  b3 = is.get();
-  b4 = is.get();
-  b5 = is.get();
-  b6 = is.get();
-  b7 = is.get();
-  b8 = is.get();
-  return (((long long)b8 << 56) | ((long long)b7 << 48) | ((long long)b6 << 40) |
-          ((long long)b5 << 32) | ((long long)b4 << 24) | ((long long)b3 << 16) |
-          ((long long)b2 << 8) | (long long)b1);
+  return read_value<uint64_t, endian::little>(is);
 }
 
 float little_endian::read_float(std::istream& is)
 {
-  int b1, b2, b3, b4;
-  b1 = is.get();
-  b2 = is.get();
-  b3 = is.get();
-  b4 = is.get();
-  int v = ((b4 << 24) | (b3 << 16) | (b2 << 8) | b1);
-  return *reinterpret_cast<float*>(&v);
+  return serialization::read_float<endian::little>(is);
 }
 
 double little_endian::read_double(std::istream& is)
 {
-  int b1, b2, b3, b4, b5, b6, b7, b8;
-  b1 = is.get();
-  b2 = is.get();
-  b3 = is.get();
-  b4 = is.get();
-  b5 = is.get();
-  b6 = is.get();
-  b7 = is.get();
-  b8 = is.get();
-  int v = (((long long)b8 << 56) | ((long long)b7 << 48) | ((long long)b6 << 40) |
-           ((long long)b5 << 32) | ((long long)b4 << 24) | ((long long)b3 << 16) |
-           ((long long)b2 << 8) | (long long)b1);
-  return *reinterpret_cast<double*>(&v);
+  return serialization::read_double<endian::little>(is);
 }
 
 std::ostream& big_endian::write16(std::ostream& os, uint16_t word)
 {
-  os.put((int)((word & 0xff00) >> 8));
-  os.put((int)((word & 0x00ff)));
-  return os;
+  return write_value<uint16_t, endian::big>(os, word);
 }
 
 std::ostream& big_endian::write32(std::ostream& os, uint32_t dword)
 {
-  os.put((int)((dword & 0xff000000l) >> 24));
-  os.put((int)((dword & 0x00ff0000l) >> 16));
-  os.put((int)((dword & 0x0000ff00l) >> 8));
-  os.put((int)((dword & 0x000000ffl)));
-  return os;
+  return write_value<uint32_t, endian::big>(os, dword);
 }
 
 std::ostream& big_endian::write64(std::ostream& os, uint64_t qword)
 {
-  os.put((int)((qword & 0xff00000000000000l) >> 56));
-  os.put((int)((qword & 0x00ff000000000000l) >> 48));
-  os.put((int)((qword & 0x0000ff0000000000l) >> 40));
-  os.put((int)((qword & 0x000000ff00000000l) >> 32));
-  os.put((int)((qword & 0x00000000ff000000l) >> 24));
-  os.put((int)((qword & 0x0000000000ff0000l) >> 16));
-  os.put((int)((qword & 0x000000000000ff00l) >> 8));
-  os.put((int)((qword & 0x00000000000000ffl)));
-  return os;
+  return write_value<uint64_t, endian::big>(os, qword);
 }
 
 std::ostream& big_endian::write_float(std::ostream& os, float value)
 {
-  const int b = *(reinterpret_cast<int*>(&value));
-  os.put((int)((b & 0xff000000l) >> 24));
-  os.put((int)((b & 0x00ff0000l) >> 16));
-  os.put((int)((b & 0x0000ff00l) >> 8));
-  os.put((int)((b & 0x000000ffl)));
-  return os;
+  return serialization::write_float<endian::big>(os, value);
 }
 
 std::ostream& big_endian::write_double(std::ostream& os, double value)
 {
-  const long long b = *(reinterpret_cast<long long*>(&value));
-  os.put((int)((b & 0xff00000000000000l) >> 56));
-  os.put((int)((b & 0x00ff000000000000l) >> 48));
-  os.put((int)((b & 0x0000ff0000000000l) >> 40));
-  os.put((int)((b & 0x000000ff00000000l) >> 32));
-  os.put((int)((b & 0x00000000ff000000l) >> 24));
-  os.put((int)((b & 0x0000000000ff0000l) >> 16));
-  os.put((int)((b & 0x000000000000ff00l) >> 8));
-  os.put((int)((b & 0x00000000000000ffl)));
-  return os;
+  return serialization::write_double<endian::big>(os, value);
 }
 
 uint16_t big_endian::read16(std::istream& is)
 {
-  int b1, b2;
-  b2 = is.get();
-  b1 = is.get();
-  return ((b2 << 8) | b1);
+  return read_value<uint16_t, endian::big>(is);
 }
 
 uint32_t big_endian::read32(std::istream& is)
 {
-  int b1, b2, b3, b4;
-  b4 = is.get();
-  b3 = is.get();
-  b2 = is.get();
-  b1 = is.get();
-  return ((b4 << 24) | (b3 << 16) | (b2 << 8) | b1);
+  return read_value<uint32_t, endian::big>(is);
 }
 
 uint64_t big_endian::read64(std::istream& is)
 {
-  int b1, b2, b3, b4, b5, b6, b7, b8;
-  b8 = is.get();
-  b7 = is.get();
-  b6 = is.get();
-  b5 = is.get();
-  b4 = is.get();
-  b3 = is.get();
-  b2 = is.get();
-  b1 = is.get();
-  return (((long long)b8 << 56) | ((long long)b7 << 48) | ((long long)b6 << 40) |
-          ((long long)b5 << 32) | ((long long)b4 << 24) | ((long long)b3 << 16) |
-          ((long long)b2 << 8) | (long long)b1);
+  return read_value<uint64_t, endian::big>(is);
 }
 
 float big_endian::read_float(std::istream& is)
 {
-  int b1, b2, b3, b4;
-  b4 = is.get();
-  b3 = is.get();
-  b2 = is.get();
-  b1 = is.get();
-  int v = ((b4 << 24) | (b3 << 16) | (b2 << 8) | b1);
-  return *reinterpret_cast<float*>(&v);
+  return serialization::read_float<endian::big>(is);
 }
 
 double big_endian::read_double(std::istream& is)
 {
-  int b1, b2, b3, b4, b5, b6, b7, b8;
-  b8 = is.get();
-  b7 = is.get();
-  b6 = is.get();
-  b5 = is.get();
-  b4 = is.get();
-  b3 = is.get();
-  b2 = is.get();
-  b1 = is.get();
-  int v = (((long long)b8 << 56) | ((long long)b7 << 48) | ((long long)b6 << 40) |
-           ((long long)b5 << 32) | ((long long)b4 << 24) | ((long long)b3 << 16) |
-           ((long long)b2 << 8) | (long long)b1);
-  return *reinterpret_cast<double*>(&v);
+  return serialization::read_double<endian::big>(is);
 }
 
 }} // namespace base::serialization
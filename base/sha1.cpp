@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -8,15 +9,238 @@
   #include "config.h"
 #endif
 
-#include "base/debug.h"
-#include "base/fstream_path.h"
 #include "base/sha1.h"
-#include "base/sha1_rfc3174.h"
 
-#include <fstream>
+#include "base/cpu_features.h"
+#include "base/debug.h"
+#include "base/file_view.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if LAF_CPU_X86
+  #include <immintrin.h>
+#endif
 
 namespace base {
 
+namespace {
+
+// Processes "blocks" blocks of 64 bytes.
+using compress_func = Sha1Hasher::CompressFunc;
+
+inline uint32_t rol(const uint32_t x, const int n)
+{
+  return (x << n) | (x >> (32 - n));
+}
+
+inline uint32_t load_be32(const uint8_t* p)
+{
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+inline void store_be32(uint8_t* p, const uint32_t v)
+{
+  p[0] = uint8_t(v >> 24);
+  p[1] = uint8_t(v >> 16);
+  p[2] = uint8_t(v >> 8);
+  p[3] = uint8_t(v);
+}
+
+// Portable version. The message schedule is kept in a circular
+// buffer of 16 words and the rounds are unrolled with macros, so the
+// compiler can keep the state in registers.
+void compress_scalar(uint32_t state[5], const uint8_t* data, size_t blocks)
+{
+  uint32_t w[16];
+
+#define SHA1_W(t)                                                                                 \
+  (w[(t) & 15] = rol(w[((t) + 13) & 15] ^ w[((t) + 8) & 15] ^ w[((t) + 2) & 15] ^ w[(t) & 15], 1))
+
+#define SHA1_ROUND(a, b, c, d, e, f, k, wt)                                                        \
+  e += rol(a, 5) + (f) + (k) + (wt);                                                               \
+  b = rol(b, 30);
+
+#define SHA1_F0(b, c, d) (d ^ (b & (c ^ d)))
+#define SHA1_F1(b, c, d) (b ^ c ^ d)
+#define SHA1_F2(b, c, d) ((b & c) | (d & (b | c)))
+
+#define SHA1_R0(a, b, c, d, e, t) SHA1_ROUND(a, b, c, d, e, SHA1_F0(b, c, d), 0x5A827999, w[t])
+#define SHA1_R1(a, b, c, d, e, t) SHA1_ROUND(a, b, c, d, e, SHA1_F0(b, c, d), 0x5A827999, SHA1_W(t))
+#define SHA1_R2(a, b, c, d, e, t) SHA1_ROUND(a, b, c, d, e, SHA1_F1(b, c, d), 0x6ED9EBA1, SHA1_W(t))
+#define SHA1_R3(a, b, c, d, e, t) SHA1_ROUND(a, b, c, d, e, SHA1_F2(b, c, d), 0x8F1BBCDC, SHA1_W(t))
+#define SHA1_R4(a, b, c, d, e, t) SHA1_ROUND(a, b, c, d, e, SHA1_F1(b, c, d), 0xCA62C1D6, SHA1_W(t))
+
+// Five rounds rotating the variables
+#define SHA1_5(R, t)                                                                               \
+  R(a, b, c, d, e, t + 0);                                                                         \
+  R(e, a, b, c, d, t + 1);                                                                         \
+  R(d, e, a, b, c, t + 2);                                                                         \
+  R(c, d, e, a, b, t + 3);                                                                         \
+  R(b, c, d, e, a, t + 4);
+
+  for (; blocks > 0; --blocks, data += 64) {
+    for (int i = 0; i < 16; ++i)
+      w[i] = load_be32(data + 4 * i);
+
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
+
+    SHA1_5(SHA1_R0, 0);
+    SHA1_5(SHA1_R0, 5);
+    SHA1_5(SHA1_R0, 10);
+    SHA1_R0(a, b, c, d, e, 15);
+    SHA1_R1(e, a, b, c, d, 16);
+    SHA1_R1(d, e, a, b, c, 17);
+    SHA1_R1(c, d, e, a, b, 18);
+    SHA1_R1(b, c, d, e, a, 19);
+    SHA1_5(SHA1_R2, 20);
+    SHA1_5(SHA1_R2, 25);
+    SHA1_5(SHA1_R2, 30);
+    SHA1_5(SHA1_R2, 35);
+    SHA1_5(SHA1_R3, 40);
+    SHA1_5(SHA1_R3, 45);
+    SHA1_5(SHA1_R3, 50);
+    SHA1_5(SHA1_R3, 55);
+    SHA1_5(SHA1_R4, 60);
+    SHA1_5(SHA1_R4, 65);
+    SHA1_5(SHA1_R4, 70);
+    SHA1_5(SHA1_R4, 75);
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+  }
+
+#undef SHA1_W
+#undef SHA1_ROUND
+#undef SHA1_F0
+#undef SHA1_F1
+#undef SHA1_F2
+#undef SHA1_R0
+#undef SHA1_R1
+#undef SHA1_R2
+#undef SHA1_R3
+#undef SHA1_R4
+#undef SHA1_5
+}
+
+#if LAF_CPU_X86
+
+// Version using the SHA extensions (each sha1rnds4 instruction
+// calculates 4 rounds, and sha1msg1/sha1msg2 the message schedule).
+LAF_TARGET("sha,sse4.1,ssse3")
+void compress_shani(uint32_t state[5], const uint8_t* data, size_t blocks)
+{
+  const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+  __m128i abcd = _mm_loadu_si128((const __m128i*)state);
+  __m128i e0 = _mm_set_epi32(int(state[4]), 0, 0, 0);
+  abcd = _mm_shuffle_epi32(abcd, 0x1B);
+
+  // Rounds 4*g to 4*g+3 (g >= 3). "cur" has the message words of
+  // this group, and the words of the next groups are calculated in
+  // the other three registers.
+  #define SHA1_GROUP(ein, eout, cur, m2, mx, m1, g)                                                \
+    ein = _mm_sha1nexte_epu32(ein, cur);                                                           \
+    eout = abcd;                                                                                   \
+    m2 = _mm_sha1msg2_epu32(m2, cur);                                                              \
+    abcd = _mm_sha1rnds4_epu32(abcd, ein, (g) / 5);                                                \
+    m1 = _mm_sha1msg1_epu32(m1, cur);                                                              \
+    mx = _mm_xor_si128(mx, cur);
+
+  for (; blocks > 0; --blocks, data += 64) {
+    const __m128i abcd_save = abcd;
+    const __m128i e0_save = e0;
+    __m128i e1;
+
+    // Rounds 0-3
+    __m128i msg0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), mask);
+    e0 = _mm_add_epi32(e0, msg0);
+    e1 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+    // Rounds 4-7
+    __m128i msg1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), mask);
+    e1 = _mm_sha1nexte_epu32(e1, msg1);
+    e0 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+    msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+    // Rounds 8-11
+    __m128i msg2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), mask);
+    e0 = _mm_sha1nexte_epu32(e0, msg2);
+    e1 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+    msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+    msg0 = _mm_xor_si128(msg0, msg2);
+
+    // Rounds 12-75
+    __m128i msg3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), mask);
+    SHA1_GROUP(e1, e0, msg3, msg0, msg1, msg2, 3);
+    SHA1_GROUP(e0, e1, msg0, msg1, msg2, msg3, 4);
+    SHA1_GROUP(e1, e0, msg1, msg2, msg3, msg0, 5);
+    SHA1_GROUP(e0, e1, msg2, msg3, msg0, msg1, 6);
+    SHA1_GROUP(e1, e0, msg3, msg0, msg1, msg2, 7);
+    SHA1_GROUP(e0, e1, msg0, msg1, msg2, msg3, 8);
+    SHA1_GROUP(e1, e0, msg1, msg2, msg3, msg0, 9);
+    SHA1_GROUP(e0, e1, msg2, msg3, msg0, msg1, 10);
+    SHA1_GROUP(e1, e0, msg3, msg0, msg1, msg2, 11);
+    SHA1_GROUP(e0, e1, msg0, msg1, msg2, msg3, 12);
+    SHA1_GROUP(e1, e0, msg1, msg2, msg3, msg0, 13);
+    SHA1_GROUP(e0, e1, msg2, msg3, msg0, msg1, 14);
+    SHA1_GROUP(e1, e0, msg3, msg0, msg1, msg2, 15);
+    SHA1_GROUP(e0, e1, msg0, msg1, msg2, msg3, 16);
+    SHA1_GROUP(e1, e0, msg1, msg2, msg3, msg0, 17);
+    SHA1_GROUP(e0, e1, msg2, msg3, msg0, msg1, 18);
+
+    // Rounds 76-79
+    e1 = _mm_sha1nexte_epu32(e1, msg3);
+    e0 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+
+    e0 = _mm_sha1nexte_epu32(e0, e0_save);
+    abcd = _mm_add_epi32(abcd, abcd_save);
+  }
+
+  #undef SHA1_GROUP
+
+  abcd = _mm_shuffle_epi32(abcd, 0x1B);
+  _mm_storeu_si128((__m128i*)state, abcd);
+  state[4] = uint32_t(_mm_extract_epi32(e0, 3));
+}
+
+#endif // LAF_CPU_X86
+
+compress_func get_accelerated_compress_func()
+{
+#if LAF_CPU_X86
+  const cpu_features& cpu = get_cpu_features();
+  if (cpu.sha && cpu.sse41 && cpu.ssse3)
+    return compress_shani;
+#endif
+  return nullptr;
+}
+
+// Resolved on first use (not in a namespace-scope initializer) so a
+// Sha1Hasher can be used during the static initialization of other
+// translation units.
+compress_func get_compress_func()
+{
+  static const compress_func f = []() -> compress_func {
+    const compress_func accelerated = get_accelerated_compress_func();
+    return (accelerated ? accelerated : compress_scalar);
+  }();
+  return f;
+}
+
+} // anonymous namespace
+
 Sha1::Sha1() : m_digest(20, 0)
 {
 }
@@ -29,50 +253,126 @@ Sha1::Sha1(const std::vector<uint8_t>& digest) : m_digest(digest)
 // Calculates the SHA1 of the given file.
 Sha1 Sha1::calculateFromFile(const std::string& fileName)
 {
-  using namespace std;
-
-  ifstream file(FSTREAM_PATH(fileName), ios::in | ios::binary);
-  if (!file.good())
+  // The file is mapped in memory, so it's hashed in one update()
+  // without intermediate copies.
+  const file_view file(fileName);
+  if (!file.is_open())
     return Sha1();
 
-  SHA1Context sha;
-  SHA1Reset(&sha);
+  Sha1Hasher hasher;
+  hasher.update(file.data(), file.size());
+  return hasher.finalize();
+}
+
+// Calculates the SHA1 of the given string.
+Sha1 Sha1::calculateFromString(const std::string& text)
+{
+  Sha1Hasher hasher;
+  hasher.update(text);
+  return hasher.finalize();
+}
+
+bool Sha1::operator==(const Sha1& other) const
+{
+  return m_digest == other.m_digest;
+}
+
+bool Sha1::operator!=(const Sha1& other) const
+{
+  return m_digest != other.m_digest;
+}
+
+Sha1Hasher::Sha1Hasher() : m_compress(get_compress_func())
+{
+  reset();
+}
+
+Sha1Hasher::Sha1Hasher(CompressFunc compress) : m_compress(compress)
+{
+  ASSERT(compress);
+  reset();
+}
+
+void Sha1Hasher::reset()
+{
+  m_state[0] = 0x67452301;
+  m_state[1] = 0xEFCDAB89;
+  m_state[2] = 0x98BADCFE;
+  m_state[3] = 0x10325476;
+  m_state[4] = 0xC3D2E1F0;
+  m_length = 0;
+  m_blockSize = 0;
+}
+
+void Sha1Hasher::update(const void* data, size_t size)
+{
+  auto p = (const uint8_t*)data;
+  m_length += size;
 
-  unsigned char buf[1024];
-  while (file.good()) {
-    file.read((char*)buf, 1024);
-    const unsigned int len = (unsigned int)file.gcount();
-    if (len > 0)
-      SHA1Input(&sha, buf, len);
+  // Complete the pending block
+  if (m_blockSize > 0) {
+    const size_t n = std::min(size, sizeof(m_block) - m_blockSize);
+    std::memcpy(m_block + m_blockSize, p, n);
+    m_blockSize += n;
+    p += n;
+    size -= n;
+    if (m_blockSize < sizeof(m_block))
+      return;
+    m_compress(m_state, m_block, 1);
+    m_blockSize = 0;
   }
 
-  vector<uint8_t> digest(HashSize);
-  SHA1Result(&sha, digest.data());
+  // Process all complete blocks directly from the input
+  const size_t blocks = size / 64;
+  if (blocks > 0) {
+    m_compress(m_state, p, blocks);
+    p += 64 * blocks;
+    size -= 64 * blocks;
+  }
 
-  return Sha1(digest);
+  if (size > 0) {
+    std::memcpy(m_block, p, size);
+    m_blockSize = size;
+  }
 }
 
-// Calculates the SHA1 of the given string.
-Sha1 Sha1::calculateFromString(const std::string& text)
+Sha1 Sha1Hasher::finalize()
 {
-  SHA1Context sha;
-  SHA1Reset(&sha);
-  SHA1Input(&sha, (uint8_t*)text.c_str(), (unsigned int)text.size());
+  const uint64_t bits = m_length * 8;
+
+  // Padding: 0x80, zeros, and the length in bits (big-endian) at the
+  // end of the last block.
+  uint8_t padding[128] = { 0x80 };
+  const size_t padSize = (m_blockSize < 56 ? 56 - m_blockSize : 120 - m_blockSize);
+  store_be32(padding + padSize, uint32_t(bits >> 32));
+  store_be32(padding + padSize + 4, uint32_t(bits));
+  update(padding, padSize + 8);
+  ASSERT(m_blockSize == 0);
 
-  std::vector<uint8_t> digest(HashSize);
-  SHA1Result(&sha, digest.data());
+  std::vector<uint8_t> digest(Sha1::HashSize);
+  for (int i = 0; i < 5; ++i)
+    store_be32(&digest[4 * i], m_state[i]);
 
+  reset();
   return Sha1(digest);
 }
 
-bool Sha1::operator==(const Sha1& other) const
+// static
+bool Sha1Hasher::isAccelerated()
 {
-  return m_digest == other.m_digest;
+  return get_compress_func() != compress_scalar;
 }
 
-bool Sha1::operator!=(const Sha1& other) const
+// static
+Sha1Hasher::CompressFunc Sha1Hasher::scalarCompressFunc()
 {
-  return m_digest != other.m_digest;
+  return compress_scalar;
+}
+
+// static
+Sha1Hasher::CompressFunc Sha1Hasher::acceleratedCompressFunc()
+{
+  return get_accelerated_compress_func();
 }
 
 } // namespace base
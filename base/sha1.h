@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -13,8 +14,6 @@
 
 #include "base/ints.h"
 
-extern "C" struct SHA1Context;
-
 namespace base {
 
 class Sha1 {
@@ -41,6 +40,48 @@ private:
   std::vector<uint8_t> m_digest;
 };
 
+// Calculates the SHA1 incrementally, e.g.
+//
+//   Sha1Hasher hasher;
+//   hasher.update(header, headerSize);
+//   hasher.update(body, bodySize);
+//   Sha1 sha1 = hasher.finalize();
+//
+// Uses the SHA extensions of x86 CPUs when they are available.
+class Sha1Hasher {
+public:
+  // Function to process complete blocks of 64 bytes.
+  typedef void (*CompressFunc)(uint32_t state[5], const uint8_t* data, size_t blocks);
+
+  Sha1Hasher();
+
+  // Uses a specific implementation of the compression function
+  // (e.g. to test the scalar and accelerated versions).
+  explicit Sha1Hasher(CompressFunc compress);
+
+  void reset();
+  void update(const void* data, size_t size);
+  void update(const std::string& text) { update(text.data(), text.size()); }
+
+  // Returns the SHA1 of all the data and resets the hasher.
+  Sha1 finalize();
+
+  // Returns true if the SHA extensions are used.
+  static bool isAccelerated();
+
+  // Returns the scalar compression function, and the one that uses
+  // the SHA extensions (nullptr if the CPU doesn't support them).
+  static CompressFunc scalarCompressFunc();
+  static CompressFunc acceleratedCompressFunc();
+
+private:
+  CompressFunc m_compress;
+  uint32_t m_state[5];
+  uint64_t m_length;    // Total number of bytes
+  uint8_t m_block[64];  // Pending bytes of an incomplete block
+  size_t m_blockSize;
+};
+
 } // namespace base
 
 #endif // BASE_SHA1_H_INCLUDED
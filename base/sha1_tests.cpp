@@ -0,0 +1,117 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/convert_to.h"
+#include "base/file_content.h"
+#include "base/fs.h"
+#include "base/sha1.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace base;
+
+static std::string hex(const Sha1& sha1)
+{
+  return convert_to<std::string>(sha1);
+}
+
+static std::string hex(Sha1Hasher::CompressFunc compress, const std::string& text)
+{
+  Sha1Hasher hasher(compress);
+  hasher.update(text);
+  return hex(hasher.finalize());
+}
+
+// All the available implementations of the compression function
+// (scalar and SHA-NI if the CPU supports it).
+static std::vector<Sha1Hasher::CompressFunc> compress_funcs()
+{
+  std::vector<Sha1Hasher::CompressFunc> funcs = { Sha1Hasher::scalarCompressFunc() };
+  if (auto f = Sha1Hasher::acceleratedCompressFunc())
+    funcs.push_back(f);
+  return funcs;
+}
+
+TEST(Sha1, KnownValues)
+{
+  EXPECT_EQ("da39a3ee5e6b4b0d3255bfef95601890afd80709", hex(Sha1::calculateFromString("")));
+  EXPECT_EQ("a9993e364706816aba3e25717850c26c9cd0d89d", hex(Sha1::calculateFromString("abc")));
+
+  for (auto f : compress_funcs()) {
+    EXPECT_EQ("da39a3ee5e6b4b0d3255bfef95601890afd80709", hex(f, ""));
+    EXPECT_EQ("a9993e364706816aba3e25717850c26c9cd0d89d", hex(f, "abc"));
+    EXPECT_EQ("84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+              hex(f, "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"));
+    EXPECT_EQ("34aa973cd4c4daa4f61eeb2bdbad27316534016f", hex(f, std::string(1000000, 'a')));
+  }
+}
+
+TEST(Sha1, Incremental)
+{
+  std::vector<uint8_t> data(5000);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = uint8_t(i * 7 + (i >> 8));
+
+  Sha1Hasher scalar(Sha1Hasher::scalarCompressFunc());
+  scalar.update(data.data(), data.size());
+  const Sha1 expected = scalar.finalize();
+
+  for (auto f : compress_funcs()) {
+    Sha1Hasher hasher(f);
+
+    // Split the data in pieces of different sizes (to test partial
+    // blocks)
+    for (size_t step : { 1, 3, 63, 64, 65, 1000, 5000 }) {
+      for (size_t i = 0; i < data.size(); i += step)
+        hasher.update(&data[i], std::min(step, data.size() - i));
+      EXPECT_EQ(expected, hasher.finalize());
+    }
+  }
+}
+
+TEST(Sha1, File)
+{
+  const char* fn = "_test_sha1_.tmp";
+  buffer buf(100000);
+  for (size_t i = 0; i < buf.size(); ++i)
+    buf[i] = uint8_t(i);
+  write_file_content(fn, buf);
+
+  Sha1Hasher hasher;
+  hasher.update(buf.data(), buf.size());
+  EXPECT_EQ(hasher.finalize(), Sha1::calculateFromFile(fn));
+  delete_file(fn);
+
+  EXPECT_EQ(Sha1(), Sha1::calculateFromFile(fn));
+}
+
+// Disabled by default (it only prints the speed), run it with
+// --gtest_also_run_disabled_tests.
+TEST(Sha1, DISABLED_Throughput)
+{
+  std::vector<uint8_t> data(64 * 1024 * 1024, 1);
+  Sha1Hasher hasher;
+
+  const auto t0 = std::chrono::steady_clock::now();
+  hasher.update(data.data(), data.size());
+  hasher.finalize();
+  const double secs =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  std::printf("Sha1 %s: %.1f MB/s\n",
+              Sha1Hasher::isAccelerated() ? "SHA-NI" : "scalar",
+              data.size() / (1024.0 * 1024.0) / secs);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
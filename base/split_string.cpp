@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -10,83 +11,147 @@
 
 #include "base/split_string.h"
 
-#include <algorithm>
+#include "base/count_bits.h"
+
+#include <cstring>
+
+// SSE2 is always available on x86-64
+#if defined(__SSE2__) || defined(_M_X64)
+  #define LAF_SPLIT_SSE2 1
+  #include <emmintrin.h>
+#endif
+
+namespace base {
 
 namespace {
-struct is_separator {
-  const std::string* separators;
 
-  is_separator(const std::string* seps) : separators(seps) {}
+constexpr size_t npos = std::string_view::npos;
 
-  bool operator()(std::string::value_type chr) const
-  {
-    for (std::string::const_iterator it = separators->begin(), end = separators->end(); it != end;
-         ++it) {
-      if (chr == *it)
-        return true;
-    }
-    return false;
-  }
-};
+#if LAF_SPLIT_SSE2
 
-struct is_separator_view {
-  const std::string_view* separators;
+// Compares 16 chars per iteration with each separator (up to 16
+// separators).
+size_t find_any_sse2(const char* s, const size_t n, size_t i, std::string_view chars)
+{
+  __m128i seps[16];
+  const size_t nseps = chars.size();
+  for (size_t j = 0; j < nseps; ++j)
+    seps[j] = _mm_set1_epi8(chars[j]);
 
-  is_separator_view(const std::string_view* seps) : separators(seps) {}
+  for (; i + 16 <= n; i += 16) {
+    const __m128i input = _mm_loadu_si128((const __m128i*)(s + i));
+    __m128i eq = _mm_cmpeq_epi8(input, seps[0]);
+    for (size_t j = 1; j < nseps; ++j)
+      eq = _mm_or_si128(eq, _mm_cmpeq_epi8(input, seps[j]));
+    const int mask = _mm_movemask_epi8(eq);
+    if (mask)
+      return i + count_trailing_zeros(mask);
+  }
+  return i;
+}
 
-  bool operator()(std::string_view::value_type chr) const
-  {
-    for (std::string_view::const_iterator it = separators->begin(), end = separators->end();
-         it != end;
-         ++it) {
-      if (chr == *it)
-        return true;
+// Looks for the first and last chars of "substr" in 16 positions
+// per iteration, and compares the rest of the string only in the
+// candidate positions (W. Muła's "SIMD-friendly algorithms for
+// substring searching"). Returns the position where the scalar
+// search should continue if it wasn't found.
+size_t find_sse2(const char* s, const size_t n, size_t i, std::string_view substr, size_t& found)
+{
+  const size_t k = substr.size();
+  const __m128i first = _mm_set1_epi8(substr[0]);
+  const __m128i last = _mm_set1_epi8(substr[k - 1]);
+
+  for (; i + k - 1 + 16 <= n; i += 16) {
+    const __m128i a = _mm_loadu_si128((const __m128i*)(s + i));
+    const __m128i b = _mm_loadu_si128((const __m128i*)(s + i + k - 1));
+    int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+    while (mask) {
+      const int bit = count_trailing_zeros(mask);
+      if (k <= 2 || std::memcmp(s + i + bit + 1, substr.data() + 1, k - 2) == 0) {
+        found = i + bit;
+        return i;
+      }
+      mask &= mask - 1;
     }
-    return false;
   }
-};
-} // namespace
+  found = npos;
+  return i;
+}
+
+#endif // LAF_SPLIT_SSE2
 
-void base::split_string(const std::string& string,
-                        std::vector<std::string>& parts,
-                        const std::string& separators)
+} // anonymous namespace
+
+size_t string_find_any(std::string_view str, std::string_view chars, size_t pos)
 {
-  const std::size_t elements =
-    1 + std::count_if(string.begin(), string.end(), is_separator(&separators));
-  parts.reserve(elements);
-
-  std::size_t beg = 0, end;
-  while (true) {
-    end = string.find_first_of(separators, beg);
-    if (end != std::string::npos) {
-      parts.push_back(string.substr(beg, end - beg));
-      beg = end + 1;
-    }
-    else {
-      parts.push_back(string.substr(beg));
-      break;
+  const size_t n = str.size();
+  if (pos >= n || chars.empty())
+    return npos;
+
+  const char* s = str.data();
+  if (chars.size() == 1) {
+    const void* p = std::memchr(s + pos, chars[0], n - pos);
+    return (p ? (const char*)p - s : npos);
+  }
+
+#if LAF_SPLIT_SSE2
+  if (chars.size() <= 16) {
+    pos = find_any_sse2(s, n, pos, chars);
+    for (; pos < n; ++pos) {
+      if (chars.find(s[pos]) != npos)
+        return pos;
     }
+    return npos;
+  }
+#endif
+
+  bool table[256] = {};
+  for (const char c : chars)
+    table[(unsigned char)c] = true;
+  for (; pos < n; ++pos) {
+    if (table[(unsigned char)s[pos]])
+      return pos;
   }
+  return npos;
 }
 
-void base::split_string(const std::string_view& string,
-                        std::vector<std::string_view>& parts,
-                        const std::string_view& separators)
+size_t string_find(std::string_view str, std::string_view substr, size_t pos)
 {
-  const std::size_t elements =
-    1 + std::count_if(string.begin(), string.end(), is_separator_view(&separators));
-  parts.reserve(elements);
-
-  std::size_t beg = 0, end;
-  while (true) {
-    end = string.find_first_of(separators, beg);
-    if (end != std::string::npos) {
-      parts.push_back(string.substr(beg, end - beg));
-      beg = end + 1;
-    }
-    else {
-      parts.push_back(string.substr(beg));
-      break;
-    }
+  const size_t n = str.size();
+  const size_t k = substr.size();
+  if (pos > n || k > n - pos)
+    return npos;
+  if (k == 0)
+    return pos;
+  if (k == 1) {
+    const void* p = std::memchr(str.data() + pos, substr[0], n - pos);
+    return (p ? (const char*)p - str.data() : npos);
   }
+
+#if LAF_SPLIT_SSE2
+  size_t found;
+  pos = find_sse2(str.data(), n, pos, substr, found);
+  if (found != npos)
+    return found;
+#endif
+
+  return str.find(substr, pos);
+}
+
+void split_string(const std::string& string,
+                  std::vector<std::string>& parts,
+                  const std::string& separators)
+{
+  for (const std::string_view part : split_view(string, separators))
+    parts.emplace_back(part);
 }
+
+void split_string(const std::string_view& string,
+                  std::vector<std::string_view>& parts,
+                  const std::string_view& separators)
+{
+  for (const std::string_view part : split_view(string, separators))
+    parts.push_back(part);
+}
+
+} // namespace base
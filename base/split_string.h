@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -8,11 +9,143 @@
 #define BASE_SPLIT_STRING_H_INCLUDED
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <string>
 #include <string_view>
 #include <vector>
 
 namespace base {
+
+// Returns the position of the first char in "str" (starting from
+// "pos") that is equal to any of the given "chars", or
+// std::string_view::npos if there is no such char.
+size_t string_find_any(std::string_view str, std::string_view chars, size_t pos = 0);
+
+// Returns the position of the first occurrence of "substr" in "str"
+// (starting from "pos"), or std::string_view::npos if it's not
+// found.
+size_t string_find(std::string_view str, std::string_view substr, size_t pos = 0);
+
+// Lazy range of the parts of a string. The parts are
+// std::string_view pointing to the original string, so no memory is
+// allocated, but the string must outlive the range. E.g.
+//
+//   for (std::string_view part : base::split_view(str, ",;"))
+//     ...
+//
+class split_range {
+public:
+  enum class mode {
+    any_of,    // Parts are separated by any of the separator chars
+    delimiter, // Parts are separated by the whole separator string
+  };
+
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = const std::string_view&;
+
+    iterator() {}
+    iterator(const split_range* range, size_t pos) : m_range(range), m_next(pos)
+    {
+      if (pos != std::string_view::npos)
+        next();
+      else
+        m_pos = std::string_view::npos;
+    }
+
+    reference operator*() const { return m_part; }
+    pointer operator->() const { return &m_part; }
+
+    iterator& operator++()
+    {
+      next();
+      return *this;
+    }
+
+    iterator operator++(int)
+    {
+      iterator old(*this);
+      next();
+      return old;
+    }
+
+    bool operator==(const iterator& that) const { return (m_pos == that.m_pos); }
+    bool operator!=(const iterator& that) const { return (m_pos != that.m_pos); }
+
+  private:
+    void next()
+    {
+      if (m_next == std::string_view::npos) {
+        m_pos = std::string_view::npos;
+        return;
+      }
+      const std::string_view str = m_range->m_str;
+      const size_t end = m_range->find(m_next);
+      m_pos = m_next;
+      if (end == std::string_view::npos) {
+        m_part = str.substr(m_pos);
+        m_next = std::string_view::npos;
+      }
+      else {
+        m_part = str.substr(m_pos, end - m_pos);
+        m_next = end + m_range->m_sepLength;
+      }
+    }
+
+    const split_range* m_range = nullptr;
+    size_t m_pos = std::string_view::npos;  // Position of the current part
+    size_t m_next = std::string_view::npos; // Position of the next part
+    std::string_view m_part;
+  };
+
+  split_range(std::string_view str, std::string_view separators, mode m = mode::any_of)
+    : m_str(str)
+    , m_separators(separators)
+    , m_mode(m)
+    , m_sepLength(m == mode::any_of ? 1 : separators.size())
+  {
+  }
+
+  iterator begin() const { return iterator(this, 0); }
+  iterator end() const { return iterator(this, std::string_view::npos); }
+
+private:
+  size_t find(size_t pos) const
+  {
+    if (m_mode == mode::any_of)
+      return string_find_any(m_str, m_separators, pos);
+    // An empty delimiter doesn't split the string
+    if (m_separators.empty())
+      return std::string_view::npos;
+    return string_find(m_str, m_separators, pos);
+  }
+
+  std::string_view m_str;
+  std::string_view m_separators;
+  mode m_mode;
+  size_t m_sepLength;
+};
+
+// Splits the string by any of the given separator chars (same parts
+// as split_string()).
+inline split_range split_view(std::string_view str, std::string_view separators)
+{
+  return split_range(str, separators, split_range::mode::any_of);
+}
+
+// Splits the string by a multi-char delimiter (e.g. "\r\n" or ", ").
+inline split_range split_view_by(std::string_view str, std::string_view delimiter)
+{
+  return split_range(str, delimiter, split_range::mode::delimiter);
+}
+
+// Adds to "parts" each part of the string separated by any of the
+// given separator chars.
 void split_string(const std::string& string,
                   std::vector<std::string>& parts,
                   const std::string& separators);
@@ -20,6 +153,7 @@ void split_string(const std::string& string,
 void split_string(const std::string_view& string,
                   std::vector<std::string_view>& parts,
                   const std::string_view& separators);
+
 } // namespace base
 
 #endif
@@ -1,4 +1,5 @@
 // LAF Base Library
+// Copyright (c) 2025 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -6,6 +7,7 @@
 
 #include <gtest/gtest.h>
 
+#include <random>
 #include <string>
 #include <vector>
 
@@ -86,6 +88,112 @@ TEST(SplitStringView, MultipleSeparators)
   EXPECT_EQ("ld", result[2]);
 }
 
+TEST(SplitView, AnyOf)
+{
+  std::vector<std::string_view> result;
+  for (std::string_view part : base::split_view("Hello,World", ",r"))
+    result.push_back(part);
+  ASSERT_EQ(3, result.size());
+  EXPECT_EQ("Hello", result[0]);
+  EXPECT_EQ("Wo", result[1]);
+  EXPECT_EQ("ld", result[2]);
+
+  // Empty parts are included
+  result.clear();
+  for (std::string_view part : base::split_view(",a,,b,", ","))
+    result.push_back(part);
+  ASSERT_EQ(5, result.size());
+  EXPECT_EQ("", result[0]);
+  EXPECT_EQ("a", result[1]);
+  EXPECT_EQ("", result[2]);
+  EXPECT_EQ("b", result[3]);
+  EXPECT_EQ("", result[4]);
+
+  // Empty string has one empty part
+  int n = 0;
+  for (std::string_view part : base::split_view("", ",")) {
+    EXPECT_EQ("", part);
+    ++n;
+  }
+  EXPECT_EQ(1, n);
+}
+
+TEST(SplitView, Delimiter)
+{
+  std::vector<std::string_view> result;
+  for (std::string_view part : base::split_view_by("a, b,c, , d", ", "))
+    result.push_back(part);
+  ASSERT_EQ(4, result.size());
+  EXPECT_EQ("a", result[0]);
+  EXPECT_EQ("b,c", result[1]);
+  EXPECT_EQ("", result[2]);
+  EXPECT_EQ("d", result[3]);
+
+  result.clear();
+  for (std::string_view part : base::split_view_by("line1\r\nline2\r\n", "\r\n"))
+    result.push_back(part);
+  ASSERT_EQ(3, result.size());
+  EXPECT_EQ("line1", result[0]);
+  EXPECT_EQ("line2", result[1]);
+  EXPECT_EQ("", result[2]);
+
+  // Empty delimiter doesn't split the string
+  result.clear();
+  for (std::string_view part : base::split_view_by("abc", ""))
+    result.push_back(part);
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ("abc", result[0]);
+}
+
+// Compares the SIMD search with std::string_view functions using
+// random strings of different sizes.
+TEST(SplitView, Find)
+{
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<int> chr('a', 'h');
+  for (int i = 0; i < 2000; ++i) {
+    std::string str(i % 130, ' ');
+    for (char& c : str)
+      c = char(chr(gen));
+
+    const std::string chars[] = { "a", "hg", "bcd", "xyz", "abcdefghijklmnopqrstu" };
+    for (const std::string& c : chars) {
+      for (size_t pos : { size_t(0), size_t(1), size_t(17) }) {
+        EXPECT_EQ(std::string_view(str).find_first_of(c, pos), base::string_find_any(str, c, pos));
+      }
+    }
+
+    const std::string substrs[] = { "a", "ab", "hhh", "abca", "abcdefgh", "hahahahahahahahaha" };
+    for (const std::string& sub : substrs) {
+      for (size_t pos : { size_t(0), size_t(1), size_t(17) }) {
+        EXPECT_EQ(std::string_view(str).find(sub, pos), base::string_find(str, sub, pos));
+      }
+    }
+  }
+}
+
+TEST(SplitView, SameAsSplitString)
+{
+  std::mt19937 gen(2);
+  std::uniform_int_distribution<int> chr('a', 'f');
+  for (int i = 0; i < 500; ++i) {
+    std::string str(i, ' ');
+    for (char& c : str)
+      c = char(chr(gen));
+
+    std::vector<std::string_view> expected, result;
+    size_t beg = 0, end;
+    while ((end = str.find_first_of("ab", beg)) != std::string::npos) {
+      expected.push_back(std::string_view(str).substr(beg, end - beg));
+      beg = end + 1;
+    }
+    expected.push_back(std::string_view(str).substr(beg));
+
+    base::split_string(std::string_view(str), result, "ab");
+    EXPECT_EQ(expected, result);
+  }
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2020-2024 Igara Studio S.A.
+// Copyright (c) 2020-2025 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,17 +9,25 @@
   #include "config.h"
 #endif
 
-#include "base/debug.h"
 #include "base/string.h"
+#include "base/count_bits.h"
+#include "base/cpu_features.h"
+#include "base/debug.h"
 #include "base/utf8_decode.h"
 
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <vector>
 
 #ifdef LAF_WINDOWS
   #include <windows.h>
 #endif
 
+#if LAF_CPU_X86
+  #include <immintrin.h>
+#endif
+
 namespace base {
 
 // Based on Allegro Unicode code (allegro/src/unicode.c)
@@ -62,6 +70,482 @@ static std::size_t insert_utf8_char(const codepoint_t chr, std::string* result =
   return size;
 }
 
+namespace {
+
+size_t ascii_prefix_scalar(const uint8_t* src, const size_t n)
+{
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    uint64_t v;
+    std::memcpy(&v, src + i, 8);
+    if (v & 0x8080808080808080ull)
+      break;
+  }
+  while (i < n && src[i] < 0x80)
+    ++i;
+  return i;
+}
+
+// Decodes one code point in the same permissive way that
+// utf8_decode::next() does (overlong encodings and surrogates are
+// accepted). Returns false if the sequence is invalid.
+inline bool decode_one(const uint8_t*& p, const uint8_t* end, codepoint_t& c)
+{
+  c = *p++;
+  if (c < 0x80)
+    return true;
+
+  int n = 0;
+  int f = 0b0100'0000;
+  while (c & f) {
+    ++n;
+    f >>= 1;
+  }
+  if (n == 0 || end - p < n)
+    return false;
+
+  c &= (0b0001'1111 >> (n - 1));
+  while (n--) {
+    const uint8_t chr = *p++;
+    if ((chr & 0b1100'0000) != 0b1000'0000)
+      return false;
+    c = (c << 6) | (chr & 0b0011'1111);
+  }
+  return true;
+}
+
+bool is_valid_scalar(const uint8_t* p, const uint8_t* end)
+{
+  while (p < end) {
+    p += ascii_prefix_scalar(p, end - p);
+    if (p == end)
+      break;
+
+    const uint8_t lead = *p;
+    int n;
+    codepoint_t c, min;
+    if (lead < 0xC2) // Continuation byte or overlong 2-byte sequence
+      return false;
+    if (lead < 0xE0) {
+      n = 1;
+      c = lead & 0x1F;
+      min = 0x80;
+    }
+    else if (lead < 0xF0) {
+      n = 2;
+      c = lead & 0x0F;
+      min = 0x800;
+    }
+    else if (lead < 0xF5) {
+      n = 3;
+      c = lead & 0x07;
+      min = 0x10000;
+    }
+    else
+      return false;
+
+    if (end - p <= n)
+      return false;
+    for (int i = 1; i <= n; ++i) {
+      const uint8_t chr = p[i];
+      if ((chr & 0xC0) != 0x80)
+        return false;
+      c = (c << 6) | (chr & 0x3F);
+    }
+    if (c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+      return false;
+    p += n + 1;
+  }
+  return true;
+}
+
+template<typename Char>
+size_t to_utf32_scalar(const uint8_t* p, const uint8_t* end, Char* dst)
+{
+  Char* out = dst;
+  codepoint_t c;
+  while (p < end && decode_one(p, end, c))
+    *out++ = Char(c);
+  return out - dst;
+}
+
+template<typename Char>
+size_t to_utf16_scalar(const uint8_t* p, const uint8_t* end, Char* dst)
+{
+  Char* out = dst;
+  codepoint_t c;
+  while (p < end && decode_one(p, end, c)) {
+    if (c < 0x10000) {
+      *out++ = Char(c);
+    }
+    else if (c <= 0x10FFFF) {
+      c -= 0x10000;
+      *out++ = Char(0xD800 | (c >> 10));
+      *out++ = Char(0xDC00 | (c & 0x3FF));
+    }
+    else
+      break;
+  }
+  return out - dst;
+}
+
+#if LAF_CPU_X86
+
+LAF_TARGET("ssse3")
+size_t ascii_prefix_ssse3(const uint8_t* src, const size_t n)
+{
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(src + i)));
+    if (mask)
+      return i + count_trailing_zeros(mask);
+  }
+  return i + ascii_prefix_scalar(src + i, n - i);
+}
+
+// Validates 16 bytes per iteration using the lookup algorithm by
+// J. Keiser and D. Lemire ("Validating UTF-8 In Less Than One
+// Instruction Per Byte"). The high and low nibbles of each pair of
+// consecutive bytes select a set of possible errors from three
+// tables, and the final "and" of the three sets contains the real
+// errors. The number of continuation bytes is accumulated in "conts"
+// to count code points in the same pass.
+LAF_TARGET("ssse3")
+bool is_valid_ssse3(const uint8_t* p, const size_t n, size_t& conts)
+{
+  enum : uint8_t {
+    TOO_SHORT = 1 << 0,  // 11______ 0_______ or 11______ 11______
+    TOO_LONG = 1 << 1,   // 0_______ 10______
+    OVERLONG_3 = 1 << 2, // 11100000 100_____
+    TOO_LARGE = 1 << 3,  // 11110100 1001____ or 11110100 101_____
+    SURROGATE = 1 << 4,  // 11101101 101_____
+    OVERLONG_2 = 1 << 5, // 1100000_ 10______
+    TOO_LARGE_1000 = 1 << 6,
+    OVERLONG_4 = 1 << 6, // 11110000 1000____
+    TWO_CONTS = 1 << 7,  // 10______ 10______
+    CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS,
+  };
+
+  const __m128i byte_1_high_table = _mm_setr_epi8(
+    // 0_______ (ASCII)
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    // 10______ (continuation)
+    char(TWO_CONTS),
+    char(TWO_CONTS),
+    char(TWO_CONTS),
+    char(TWO_CONTS),
+    // 1100____ / 1101____ (2-byte lead)
+    TOO_SHORT | OVERLONG_2,
+    TOO_SHORT,
+    // 1110____ (3-byte lead)
+    TOO_SHORT | OVERLONG_3 | SURROGATE,
+    // 1111____ (4-byte lead)
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+
+  const __m128i byte_1_low_table = _mm_setr_epi8(
+    // ____0000
+    char(CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4),
+    // ____0001
+    char(CARRY | OVERLONG_2),
+    // ____001_
+    char(CARRY),
+    char(CARRY),
+    // ____0100
+    char(CARRY | TOO_LARGE),
+    // ____0101 to ____1111
+    char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+    char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+    char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+    char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+    char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+    char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+    char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+    char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+    char(CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE),
+    char(CARRY | TOO_LARGE | TOO_LARGE_1000),
+    char(CARRY | TOO_LARGE | TOO_LARGE_1000));
+
+  const __m128i byte_2_high_table = _mm_setr_epi8(
+    // 0_______ (ASCII after a lead byte)
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    // 1000____
+    char(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4),
+    // 1001____
+    char(TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE),
+    // 101_____
+    char(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE),
+    char(TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE),
+    // 11______ (lead after a lead byte)
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT);
+
+  // Lead bytes at the end of a block that need more bytes in the
+  // next block.
+  const __m128i max_complete =
+    _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1);
+
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  __m128i error = zero;
+  __m128i prev_input = zero;
+  __m128i prev_incomplete = zero;
+  __m128i conts8 = zero;  // Continuation bytes in each lane (up to 255)
+  __m128i conts64 = zero; // Continuation bytes (two 64-bit sums)
+  int conts8_iters = 0;
+
+  uint8_t tail[16];
+  const uint8_t* end = p + n;
+  while (p < end) {
+    __m128i input;
+    if (end - p >= 16) {
+      input = _mm_loadu_si128((const __m128i*)p);
+      p += 16;
+    }
+    else {
+      // Pad the last block with zeros (ASCII chars)
+      std::memset(tail, 0, sizeof(tail));
+      std::memcpy(tail, p, end - p);
+      input = _mm_loadu_si128((const __m128i*)tail);
+      p = end;
+    }
+
+    if (_mm_movemask_epi8(input) == 0) {
+      // An ASCII block is valid if the previous one was complete
+      error = _mm_or_si128(error, prev_incomplete);
+      prev_incomplete = zero;
+    }
+    else {
+      const __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+      const __m128i byte_1_high =
+        _mm_shuffle_epi8(byte_1_high_table, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+      const __m128i byte_1_low = _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(prev1, nibble));
+      const __m128i byte_2_high =
+        _mm_shuffle_epi8(byte_2_high_table, _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+      const __m128i special_cases =
+        _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+      // The 3rd/4th bytes of 3/4-byte sequences must be continuation
+      // bytes (bit 0x80 in special_cases, as TWO_CONTS).
+      const __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+      const __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+      const __m128i is_third_byte = _mm_subs_epu8(prev2, _mm_set1_epi8(char(0xE0 - 0x80)));
+      const __m128i is_fourth_byte = _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xF0 - 0x80)));
+      const __m128i must_be_2_3_cont =
+        _mm_and_si128(_mm_or_si128(is_third_byte, is_fourth_byte), _mm_set1_epi8(char(0x80)));
+      error = _mm_or_si128(error, _mm_xor_si128(must_be_2_3_cont, special_cases));
+
+      prev_incomplete = _mm_subs_epu8(input, max_complete);
+
+      // Bytes in the range 0x80-0xBF are less than -64 as signed
+      conts8 = _mm_sub_epi8(conts8, _mm_cmplt_epi8(input, _mm_set1_epi8(-64)));
+      if (++conts8_iters == 255) {
+        conts64 = _mm_add_epi64(conts64, _mm_sad_epu8(conts8, zero));
+        conts8 = zero;
+        conts8_iters = 0;
+      }
+    }
+    prev_input = input;
+  }
+  error = _mm_or_si128(error, prev_incomplete);
+
+  conts64 = _mm_add_epi64(conts64, _mm_sad_epu8(conts8, zero));
+  conts = size_t(_mm_cvtsi128_si32(conts64)) + size_t(_mm_extract_epi16(conts64, 4));
+  return (_mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) == 0xFFFF);
+}
+
+// Returns 8 code points in 16-bit lanes if the 16 bytes are 8 code
+// points encoded with 2-byte sequences (e.g. Cyrillic or Greek text).
+LAF_TARGET("ssse3")
+inline bool decode_2byte_ssse3(const __m128i input, __m128i& result)
+{
+  // 110xxxxx 10xxxxxx (lead byte in even positions)
+  const __m128i masked = _mm_and_si128(input, _mm_set1_epi16(short(0xC0E0)));
+  if (_mm_movemask_epi8(_mm_cmpeq_epi8(masked, _mm_set1_epi16(short(0x80C0)))) != 0xFFFF)
+    return false;
+
+  // Swap bytes so each 16-bit lane is 110aaaaa'10bbbbbb
+  const __m128i v =
+    _mm_shuffle_epi8(input, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+  result = _mm_or_si128(_mm_and_si128(v, _mm_set1_epi16(0x003F)),
+                        _mm_srli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x1F00)), 2));
+  return true;
+}
+
+// Returns 4 code points in 32-bit lanes if the first 12 bytes are 4
+// code points encoded with 3-byte sequences (e.g. CJK text).
+LAF_TARGET("ssse3")
+inline bool decode_3byte_ssse3(const __m128i input, __m128i& result)
+{
+  // 1110xxxx 10xxxxxx 10xxxxxx
+  const __m128i masked = _mm_and_si128(
+    input,
+    _mm_setr_epi8(char(0xF0), char(0xC0), char(0xC0), char(0xF0), char(0xC0), char(0xC0),
+                  char(0xF0), char(0xC0), char(0xC0), char(0xF0), char(0xC0), char(0xC0),
+                  0, 0, 0, 0));
+  const __m128i expected =
+    _mm_setr_epi8(char(0xE0), char(0x80), char(0x80), char(0xE0), char(0x80), char(0x80),
+                  char(0xE0), char(0x80), char(0x80), char(0xE0), char(0x80), char(0x80),
+                  0, 0, 0, 0);
+  if (_mm_movemask_epi8(_mm_cmpeq_epi8(masked, expected)) != 0xFFFF)
+    return false;
+
+  // Each 32-bit lane is 10cccccc'10bbbbbb'1110aaaa'00000000
+  const __m128i v = _mm_shuffle_epi8(
+    input,
+    _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1));
+  result = _mm_or_si128(
+    _mm_or_si128(_mm_and_si128(v, _mm_set1_epi32(0x0000003F)),
+                 _mm_srli_epi32(_mm_and_si128(v, _mm_set1_epi32(0x00003F00)), 2)),
+    _mm_srli_epi32(_mm_and_si128(v, _mm_set1_epi32(0x000F0000)), 4));
+  return true;
+}
+
+// Converts runs of ASCII chars (16 per iteration), 4 code points
+// encoded with 3-byte sequences, or 8 code points encoded with 2-byte
+// sequences, and the rest of chars one by one. Returns false if an
+// invalid sequence is found. Each iteration writes up to 16 elements
+// in "out", which is safe because the number of
+// written elements is never greater than the number of consumed
+// bytes, and we iterate only when 16 bytes are available.
+template<typename Char>
+LAF_TARGET("ssse3")
+bool to_utf32_ssse3(const uint8_t*& p, const uint8_t* end, Char*& out)
+{
+  static_assert(sizeof(Char) == 4);
+  const __m128i zero = _mm_setzero_si128();
+  while (end - p >= 16) {
+    const __m128i input = _mm_loadu_si128((const __m128i*)p);
+    const int mask = _mm_movemask_epi8(input);
+    __m128i v;
+
+    if ((mask & 1) == 0) { // Starts with ASCII chars
+      const __m128i lo = _mm_unpacklo_epi8(input, zero);
+      const __m128i hi = _mm_unpackhi_epi8(input, zero);
+      _mm_storeu_si128((__m128i*)(out), _mm_unpacklo_epi16(lo, zero));
+      _mm_storeu_si128((__m128i*)(out + 4), _mm_unpackhi_epi16(lo, zero));
+      _mm_storeu_si128((__m128i*)(out + 8), _mm_unpacklo_epi16(hi, zero));
+      _mm_storeu_si128((__m128i*)(out + 12), _mm_unpackhi_epi16(hi, zero));
+      const int n = (mask == 0 ? 16 : count_trailing_zeros(mask));
+      p += n;
+      out += n;
+    }
+    else if (decode_3byte_ssse3(input, v)) {
+      _mm_storeu_si128((__m128i*)out, v);
+      p += 12;
+      out += 4;
+    }
+    else if (decode_2byte_ssse3(input, v)) {
+      _mm_storeu_si128((__m128i*)(out), _mm_unpacklo_epi16(v, zero));
+      _mm_storeu_si128((__m128i*)(out + 4), _mm_unpackhi_epi16(v, zero));
+      p += 16;
+      out += 8;
+    }
+    else {
+      codepoint_t c;
+      if (!decode_one(p, end, c))
+        return false;
+      *out++ = Char(c);
+    }
+  }
+  return true;
+}
+
+template<typename Char>
+LAF_TARGET("ssse3")
+bool to_utf16_ssse3(const uint8_t*& p, const uint8_t* end, Char*& out)
+{
+  static_assert(sizeof(Char) == 2);
+  const __m128i zero = _mm_setzero_si128();
+  while (end - p >= 16) {
+    const __m128i input = _mm_loadu_si128((const __m128i*)p);
+    const int mask = _mm_movemask_epi8(input);
+    __m128i v;
+
+    if ((mask & 1) == 0) { // Starts with ASCII chars
+      _mm_storeu_si128((__m128i*)(out), _mm_unpacklo_epi8(input, zero));
+      _mm_storeu_si128((__m128i*)(out + 8), _mm_unpackhi_epi8(input, zero));
+      const int n = (mask == 0 ? 16 : count_trailing_zeros(mask));
+      p += n;
+      out += n;
+    }
+    else if (decode_3byte_ssse3(input, v)) {
+      // Code points are in the BMP, so we keep the lower 16 bits
+      v = _mm_shuffle_epi8(v,
+                           _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1));
+      _mm_storel_epi64((__m128i*)out, v);
+      p += 12;
+      out += 4;
+    }
+    else if (decode_2byte_ssse3(input, v)) {
+      _mm_storeu_si128((__m128i*)out, v);
+      p += 16;
+      out += 8;
+    }
+    else {
+      codepoint_t c;
+      if (!decode_one(p, end, c) || c > 0x10FFFF)
+        return false;
+      if (c < 0x10000) {
+        *out++ = Char(c);
+      }
+      else {
+        c -= 0x10000;
+        *out++ = Char(0xD800 | (c >> 10));
+        *out++ = Char(0xDC00 | (c & 0x3FF));
+      }
+    }
+  }
+  return true;
+}
+
+#endif // LAF_CPU_X86
+
+template<typename Char>
+size_t to_utf32(const char* src, const size_t n, Char* dst)
+{
+  const uint8_t* p = (const uint8_t*)src;
+  const uint8_t* end = p + n;
+  Char* out = dst;
+#if LAF_CPU_X86
+  static const bool ssse3 = get_cpu_features().ssse3;
+  if (ssse3 && !to_utf32_ssse3(p, end, out))
+    return out - dst;
+#endif
+  return (out - dst) + to_utf32_scalar(p, end, out);
+}
+
+template<typename Char>
+size_t to_utf16(const char* src, const size_t n, Char* dst)
+{
+  const uint8_t* p = (const uint8_t*)src;
+  const uint8_t* end = p + n;
+  Char* out = dst;
+#if LAF_CPU_X86
+  static const bool ssse3 = get_cpu_features().ssse3;
+  if (ssse3 && !to_utf16_ssse3(p, end, out))
+    return out - dst;
+#endif
+  return (out - dst) + to_utf16_scalar(p, end, out);
+}
+
+} // anonymous namespace
+
 std::string string_printf(const char* format, ...)
 {
   std::va_list ap;
@@ -135,7 +619,7 @@ codepoint_t utf16_to_codepoint(const uint16_t low, const uint16_t hi)
   // Surrogate pair
   if (low >= 0xDC00 && low <= 0xDFFF) {
     ASSERT(hi >= 0xD800 && hi <= 0xDBFF);
-    return (0x10000 | (((low - 0xDC00)) | ((hi - 0xD800) << 10)));
+    return (0x10000 + ((low - 0xDC00) | ((hi - 0xD800) << 10)));
   }
 
   return 0;
@@ -194,36 +678,81 @@ std::string to_utf8(const wchar_t* src, const size_t n)
 
 std::wstring from_utf8(const std::string& src)
 {
-  int required_size = utf8_length(src);
-  std::vector<wchar_t> buf(++required_size);
-  std::vector<wchar_t>::iterator buf_it = buf.begin();
-  #ifdef _DEBUG
-  std::vector<wchar_t>::iterator buf_end = buf.end();
-  #endif
-  utf8_decode decode(src);
-
-  while (const int chr = decode.next()) {
-    ASSERT(buf_it != buf_end);
-    *buf_it = chr;
-    ++buf_it;
-  }
-
-  return std::wstring(buf.data());
+  std::wstring result(src.size(), 0);
+  size_t n;
+  if constexpr (sizeof(wchar_t) == 4)
+    n = to_utf32(src.c_str(), src.size(), &result[0]);
+  else
+    n = to_utf16(src.c_str(), src.size(), &result[0]);
+
+  // Stop at the first null character (as utf8_decode does)
+  result.resize(std::min(n, result.find(L'\0')));
+  return result;
 }
 
 #endif
 
-int utf8_length(const std::string& utf8string)
+int utf8_length(const char* src, size_t n)
 {
-  utf8_decode decode(utf8string);
-  int c = 0;
+  // Only the text before the first null character is counted
+  if (const void* nul = std::memchr(src, 0, n))
+    n = (const char*)nul - src;
+
+#if LAF_CPU_X86
+  // Valid UTF-8 text has one code point for each byte that is not a
+  // continuation byte.
+  static const bool ssse3 = get_cpu_features().ssse3;
+  size_t conts;
+  if (ssse3 && is_valid_ssse3((const uint8_t*)src, n, conts))
+    return int(n - conts);
+#endif
 
-  while (decode.next())
+  const uint8_t* p = (const uint8_t*)src;
+  const uint8_t* end = p + n;
+  int c = 0;
+  codepoint_t chr;
+  while (p < end) {
+    const size_t ascii = ascii_prefix_scalar(p, end - p);
+    p += ascii;
+    c += int(ascii);
+    if (p == end || !decode_one(p, end, chr) || chr == 0)
+      break;
     ++c;
-
+  }
   return c;
 }
 
+size_t utf8_ascii_prefix(const char* src, const size_t n)
+{
+#if LAF_CPU_X86
+  static const bool ssse3 = get_cpu_features().ssse3;
+  if (ssse3)
+    return ascii_prefix_ssse3((const uint8_t*)src, n);
+#endif
+  return ascii_prefix_scalar((const uint8_t*)src, n);
+}
+
+bool utf8_is_valid(const char* src, const size_t n)
+{
+#if LAF_CPU_X86
+  static const bool ssse3 = get_cpu_features().ssse3;
+  size_t conts;
+  if (ssse3)
+    return is_valid_ssse3((const uint8_t*)src, n, conts);
+#endif
+  return is_valid_scalar((const uint8_t*)src, (const uint8_t*)src + n);
+}
+
+size_t utf8_to_utf32(const char* src, const size_t n, codepoint_t* dst)
+{
+  return to_utf32(src, n, dst);
+}
+
+size_t utf8_to_utf16(const char* src, const size_t n, uint16_t* dst)
+{
+  return to_utf16(src, n, dst);
+}
+
 int utf8_icmp(const std::string& a, const std::string& b, int n)
 {
   utf8_decode a_decode(a);
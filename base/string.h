@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2020-2024 Igara Studio S.A.
+// Copyright (c) 2020-2025 Igara Studio S.A.
 // Copyright (c) 2001-2017 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -36,7 +36,38 @@ inline std::string to_utf8(const std::wstring& widestring)
 
 std::wstring from_utf8(const std::string& utf8string);
 
-int utf8_length(const std::string& utf8string);
+// Returns the number of code points of the given UTF-8 string. It
+// stops counting at the first null character or invalid sequence
+// (like base::utf8_decode does).
+int utf8_length(const char* src, size_t n);
+
+inline int utf8_length(const std::string& utf8string)
+{
+  return utf8_length(utf8string.c_str(), utf8string.size());
+}
+
+// Returns the number of bytes at the beginning of "src" that are
+// ASCII characters (< 0x80).
+size_t utf8_ascii_prefix(const char* src, size_t n);
+
+// Returns true if the string is well-formed UTF-8 (RFC 3629), i.e.
+// without overlong encodings, surrogates, or code points above
+// U+10FFFF.
+bool utf8_is_valid(const char* src, size_t n);
+
+inline bool utf8_is_valid(const std::string& utf8string)
+{
+  return utf8_is_valid(utf8string.c_str(), utf8string.size());
+}
+
+// Converts the UTF-8 string to UTF-32 or UTF-16 into the given
+// buffer, which must have space for at least "n" elements (one
+// element per input byte is the worst case). Null characters are
+// converted as any other character, and the conversion stops at the
+// first invalid sequence. Returns the number of written elements.
+size_t utf8_to_utf32(const char* src, size_t n, codepoint_t* dst);
+size_t utf8_to_utf16(const char* src, size_t n, uint16_t* dst);
+
 int utf8_icmp(const std::string& a, const std::string& b, int n = 0);
 
 } // namespace base
@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2022 Igara Studio S.A.
+// Copyright (c) 2022-2025 Igara Studio S.A.
 // Copyright (c) 2001-2016 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,7 +11,11 @@
 #include "base/utf8_decode.h"
 
 #include <algorithm>
+#include <chrono>
 #include <clocale>
+#include <cstdio>
+#include <random>
+#include <vector>
 
 using namespace base;
 
@@ -177,6 +181,224 @@ TEST(String, Utf8DecodeDontCrash)
   }
 }
 
+// Strict UTF-8 validation (RFC 3629) decoding one code point at a
+// time to compare the results of utf8_is_valid().
+static bool is_valid_utf8_reference(const std::string& str)
+{
+  for (size_t i = 0; i < str.size();) {
+    const uint8_t c = str[i];
+    int n;
+    codepoint_t cp;
+    if (c < 0x80) {
+      ++i;
+      continue;
+    }
+    else if ((c & 0xE0) == 0xC0) {
+      n = 1;
+      cp = c & 0x1F;
+    }
+    else if ((c & 0xF0) == 0xE0) {
+      n = 2;
+      cp = c & 0x0F;
+    }
+    else if ((c & 0xF8) == 0xF0) {
+      n = 3;
+      cp = c & 0x07;
+    }
+    else
+      return false;
+    if (i + n >= str.size())
+      return false;
+    for (int j = 1; j <= n; ++j) {
+      const uint8_t b = str[i + j];
+      if ((b & 0xC0) != 0x80)
+        return false;
+      cp = (cp << 6) | (b & 0x3F);
+    }
+    const codepoint_t min[] = { 0, 0x80, 0x800, 0x10000 };
+    if (cp < min[n] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+      return false;
+    i += n + 1;
+  }
+  return true;
+}
+
+// Generates text with a mix of ASCII, 2-byte, 3-byte and 4-byte
+// sequences, and optionally some random bytes.
+static std::string random_utf8(std::mt19937& gen, const int chars, const bool garbage)
+{
+  std::uniform_int_distribution<int> kind(0, garbage ? 4 : 3);
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::string str;
+  for (int i = 0; i < chars; ++i) {
+    switch (kind(gen)) {
+      case 0:  str.push_back(char(1 + byte(gen) % 127)); break;
+      case 1:  str += codepoint_to_utf8(0x80 + byte(gen) * 7); break;
+      case 2:  str += codepoint_to_utf8(0x4E00 + byte(gen) * 80); break;
+      case 3:  str += codepoint_to_utf8(0x10000 + byte(gen) * 4000); break;
+      case 4:  str.push_back(char(byte(gen))); break;
+    }
+  }
+  return str;
+}
+
+static std::vector<codepoint_t> decode_all(const std::string& str)
+{
+  std::vector<codepoint_t> result;
+  utf8_decode decode(str);
+  while (const codepoint_t chr = decode.next())
+    result.push_back(chr);
+  return result;
+}
+
+TEST(String, Utf8Validation)
+{
+  EXPECT_TRUE(utf8_is_valid(""));
+  EXPECT_TRUE(utf8_is_valid("abc"));
+  EXPECT_TRUE(utf8_is_valid("\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E"));
+  EXPECT_TRUE(utf8_is_valid("\xF0\x9F\x98\x80"));               // U+1F600
+  EXPECT_TRUE(utf8_is_valid("\xF4\x8F\xBF\xBF"));               // U+10FFFF
+  EXPECT_TRUE(utf8_is_valid("\xED\x9F\xBF"));                   // U+D7FF
+  EXPECT_TRUE(utf8_is_valid(std::string("a\0b", 3)));           // Null char
+  EXPECT_FALSE(utf8_is_valid("\x80"));                          // Lone continuation
+  EXPECT_FALSE(utf8_is_valid("\xC0\xAF"));                      // Overlong
+  EXPECT_FALSE(utf8_is_valid("\xE0\x80\xAF"));                  // Overlong
+  EXPECT_FALSE(utf8_is_valid("\xF0\x80\x80\xAF"));              // Overlong
+  EXPECT_FALSE(utf8_is_valid("\xED\xA0\x80"));                  // Surrogate
+  EXPECT_FALSE(utf8_is_valid("\xF4\x90\x80\x80"));              // > U+10FFFF
+  EXPECT_FALSE(utf8_is_valid("\xF8\x88\x80\x80\x80"));          // 5 bytes
+  EXPECT_FALSE(utf8_is_valid("\xE6\x97"));                      // Incomplete
+  EXPECT_FALSE(utf8_is_valid("0123456789abcde\xE6"));           // Incomplete at block end
+  EXPECT_FALSE(utf8_is_valid("0123456789abcde\xE6"
+                             "0123456789abcdef")); // Incomplete before an ASCII block
+
+  std::mt19937 gen(1);
+  for (int i = 0; i < 5000; ++i) {
+    const std::string str = random_utf8(gen, i % 80, (i & 1));
+    EXPECT_EQ(is_valid_utf8_reference(str), utf8_is_valid(str)) << "i=" << i;
+  }
+}
+
+TEST(String, Utf8LengthAndConversion)
+{
+  std::mt19937 gen(2);
+  std::vector<codepoint_t> utf32;
+  std::vector<uint16_t> utf16;
+  for (int i = 0; i < 5000; ++i) {
+    const std::string str = random_utf8(gen, i % 100, (i % 3) == 0);
+    const std::vector<codepoint_t> expected = decode_all(str);
+
+    EXPECT_EQ(int(expected.size()), utf8_length(str)) << "i=" << i;
+
+    utf32.resize(str.size());
+    utf32.resize(utf8_to_utf32(str.c_str(), str.size(), utf32.data()));
+    utf32.resize(std::min(utf32.size(), expected.size()));
+    EXPECT_EQ(expected, utf32) << "i=" << i;
+
+    if (!is_valid_utf8_reference(str))
+      continue;
+
+    utf16.resize(str.size());
+    utf16.resize(utf8_to_utf16(str.c_str(), str.size(), utf16.data()));
+    std::vector<codepoint_t> decoded16;
+    for (size_t j = 0; j < utf16.size(); ++j) {
+      if (utf16[j] >= 0xD800 && utf16[j] <= 0xDBFF && j + 1 < utf16.size()) {
+        decoded16.push_back(utf16_to_codepoint(utf16[j + 1], utf16[j]));
+        ++j;
+      }
+      else
+        decoded16.push_back(utf16[j]);
+    }
+    EXPECT_EQ(expected, decoded16) << "i=" << i;
+  }
+
+  // Long runs of each kind of text
+  for (const codepoint_t base : { 0x41, 0x430, 0x65E5, 0x1F600 }) {
+    std::string str;
+    std::vector<codepoint_t> expected;
+    for (int i = 0; i < 100; ++i) {
+      str += codepoint_to_utf8(base + i % 20);
+      expected.push_back(base + i % 20);
+    }
+    utf32.resize(str.size());
+    utf32.resize(utf8_to_utf32(str.c_str(), str.size(), utf32.data()));
+    EXPECT_EQ(expected, utf32);
+    EXPECT_EQ(100, utf8_length(str));
+  }
+
+  // Conversion stops at the first invalid sequence, but length stops
+  // at the first null character too.
+  const std::string str("abc\0d\xE6\x97\xA5\xE6\x9Cxyz", 12);
+  utf32.resize(str.size());
+  EXPECT_EQ(6, utf8_to_utf32(str.c_str(), str.size(), utf32.data()));
+  EXPECT_EQ(3, utf8_length(str));
+  EXPECT_EQ(L"abc", from_utf8(str));
+}
+
+TEST(String, Utf8AsciiPrefix)
+{
+  std::string str(100, 'a');
+  for (size_t i = 0; i < str.size(); ++i) {
+    str[i] = '\xC3';
+    EXPECT_EQ(i, utf8_ascii_prefix(str.c_str(), str.size()));
+    str[i] = 'a';
+  }
+  EXPECT_EQ(str.size(), utf8_ascii_prefix(str.c_str(), str.size()));
+}
+
+// Speed of UTF-8 functions with ASCII/CJK/mixed text. Only prints the
+// results, so it must be run explicitly with
+// --gtest_also_run_disabled_tests.
+TEST(String, DISABLED_Utf8Throughput)
+{
+  // Text with different proportions of ASCII/CJK chars
+  const std::string ascii = "Layer 1, Frame 24 (100ms) ";
+  const std::string cjk = "\xE3\x83\xAC\xE3\x82\xA4\xE3\x83\xA4\xE3\x83\xBC" // レイヤー
+                          "\xE5\x9B\xBE\xE5\xB1\x82";                      // 图层
+  const std::string corpora[] = { ascii, cjk, ascii + cjk };
+  const char* names[] = { "ASCII", "CJK", "Mixed" };
+
+  std::vector<codepoint_t> utf32;
+  for (int k = 0; k < 3; ++k) {
+    std::string text;
+    while (text.size() < 1024 * 1024)
+      text += corpora[k];
+    utf32.resize(text.size());
+
+    const int iters = 20;
+    auto bench = [&](auto&& func) {
+      const auto t0 = std::chrono::high_resolution_clock::now();
+      size_t result = 0;
+      for (int i = 0; i < iters; ++i)
+        result += func();
+      const auto t1 = std::chrono::high_resolution_clock::now();
+      const double secs = std::chrono::duration<double>(t1 - t0).count();
+      EXPECT_GT(result, 0);
+      return double(text.size()) * iters / secs / 1024.0 / 1024.0;
+    };
+
+    const double decodeSpeed = bench([&] {
+      utf8_decode decode(text);
+      size_t n = 0;
+      while (const codepoint_t chr = decode.next())
+        utf32[n++] = chr;
+      return n;
+    });
+    const double utf32Speed = bench(
+      [&] { return utf8_to_utf32(text.c_str(), text.size(), utf32.data()); });
+    const double lengthSpeed = bench([&] { return size_t(utf8_length(text)); });
+    const double validSpeed = bench([&] { return size_t(utf8_is_valid(text)); });
+
+    std::printf("%-5s utf8_decode %7.1f MB/s, utf8_to_utf32 %7.1f MB/s, "
+                "utf8_length %7.1f MB/s, utf8_is_valid %7.1f MB/s\n",
+                names[k],
+                decodeSpeed,
+                utf32Speed,
+                lengthSpeed,
+                validSpeed);
+  }
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
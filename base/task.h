@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -17,10 +17,12 @@
 namespace base {
 
 class task;
+class task_graph;
 class thread_pool;
 
 class task_token {
   friend class task;
+  friend class task_graph;
 
 public:
   task_token() : m_canceled(false), m_progress(0.0f), m_progress_min(0.0f), m_progress_max(1.0f) {}
@@ -88,7 +90,11 @@ public:
   // safely.
   void on_finished(finfunc_t&& f) { m_finished = std::move(f); }
 
-  task_token& start(thread_pool& pool);
+  // Enqueues the task in the given thread pool with the given
+  // priority and optional deadline (see thread_pool::execute()).
+  task_token& start(thread_pool& pool,
+                    thread_pool::priority priority = thread_pool::priority::NORMAL,
+                    tick_t deadline = 0);
   bool try_pop(thread_pool& pool);
 
   bool running() const { return m_state == state::RUNNING; }
@@ -0,0 +1,275 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/task_graph.h"
+
+#include "base/debug.h"
+#include "base/log.h"
+
+#include <algorithm>
+
+namespace base {
+
+task_graph::task_graph()
+{
+}
+
+task_graph::~task_graph()
+{
+  // The graph must not be running when we are destroying it.
+  ASSERT(!m_running);
+}
+
+task_graph::node_id task_graph::add(func_t&& f, float weight)
+{
+  const std::lock_guard lock(m_mutex);
+  ASSERT(!m_running);
+  ASSERT(weight >= 0.0f);
+
+  auto n = std::make_unique<node>();
+  n->func = std::move(f);
+  n->weight = weight;
+  m_nodes.push_back(std::move(n));
+  m_total_weight += weight;
+  return m_nodes.size() - 1;
+}
+
+void task_graph::add_dependency(node_id node, node_id input)
+{
+  const std::lock_guard lock(m_mutex);
+  ASSERT(!m_running);
+  ASSERT(node < m_nodes.size());
+  ASSERT(input < node);
+
+  m_nodes[input]->outputs.push_back(node);
+  ++m_nodes[node]->inputs;
+}
+
+task_token& task_graph::start(thread_pool& pool)
+{
+  bool finished;
+  {
+    const std::lock_guard lock(m_mutex);
+
+    // Cannot start the graph if it's already running
+    ASSERT(!m_running);
+
+    m_pool = &pool;
+    m_token.reset();
+    m_finished_nodes = 0;
+    m_running = true;
+
+    for (auto& n : m_nodes) {
+      n->pending = n->inputs;
+      n->canceled_input = false;
+      n->started = false;
+      n->finished = false;
+      n->canceled = false;
+      n->token = nullptr;
+    }
+
+    for (node_id id = 0; id < m_nodes.size(); ++id) {
+      if (m_nodes[id]->inputs == 0)
+        start_node(id);
+    }
+
+    // Empty graph
+    finished = m_nodes.empty();
+    if (finished)
+      m_running = false;
+  }
+
+  if (finished && m_finished) {
+    task_token token = m_token;
+    m_finished(token);
+  }
+  return m_token;
+}
+
+void task_graph::cancel()
+{
+  std::vector<node*> started;
+  {
+    const std::lock_guard lock(m_mutex);
+    if (!m_running)
+      return;
+
+    m_token.cancel();
+    for (auto& n : m_nodes) {
+      if (n->started && !n->finished)
+        started.push_back(n.get());
+    }
+    // While m_cancelling > 0 the "finished" callback is deferred, so
+    // the graph cannot be destroyed while we iterate the nodes.
+    ++m_cancelling;
+  }
+
+  // This is done without locking m_mutex because task::try_pop() can
+  // call on_node_finished() from this same thread.
+  for (node* n : started) {
+    if (!n->task.try_pop(*m_pool))
+      n->token->cancel();
+  }
+
+  bool finished = false;
+  {
+    const std::lock_guard lock(m_mutex);
+    if (--m_cancelling == 0 && m_finish_deferred) {
+      m_finish_deferred = false;
+      m_running = false;
+      finished = true;
+    }
+  }
+
+  // The graph could be destroyed inside this callback, so we cannot
+  // touch "this" after calling it.
+  if (finished)
+    call_finished();
+}
+
+float task_graph::progress() const
+{
+  const std::lock_guard lock(m_mutex);
+  if (m_total_weight <= 0.0f)
+    return m_token.progress();
+
+  float p = finished_progress();
+  for (const auto& n : m_nodes) {
+    if (n->started && !n->finished && n->token)
+      p += n->weight * n->token->progress() / m_total_weight;
+  }
+  // Map the progress to the range specified in the graph token
+  task_token token = m_token;
+  token.set_progress(std::clamp(p, 0.0f, 1.0f));
+  return token.progress();
+}
+
+bool task_graph::running() const
+{
+  const std::lock_guard lock(m_mutex);
+  return m_running;
+}
+
+bool task_graph::completed() const
+{
+  const std::lock_guard lock(m_mutex);
+  return !m_running && m_finished_nodes == m_nodes.size();
+}
+
+bool task_graph::canceled(node_id node) const
+{
+  const std::lock_guard lock(m_mutex);
+  ASSERT(node < m_nodes.size());
+  return m_nodes[node]->canceled;
+}
+
+// Must be called with m_mutex locked.
+void task_graph::start_node(node_id id)
+{
+  node& n = *m_nodes[id];
+  ASSERT(!n.started);
+
+  n.started = true;
+  n.task.on_execute([this, id](task_token& token) {
+    // Don't execute the node if the whole graph was canceled
+    if (m_token.canceled()) {
+      token.cancel();
+      return;
+    }
+    m_nodes[id]->func(token);
+  });
+  n.task.on_finished([this, id](const task_token& token) { on_node_finished(id, token); });
+  n.token = &n.task.start(*m_pool);
+}
+
+void task_graph::on_node_finished(node_id id, const task_token& token)
+{
+  bool finished;
+  {
+    const std::lock_guard lock(m_mutex);
+    finish_node(id, token.canceled());
+
+    m_token.set_progress(std::clamp(finished_progress(), 0.0f, 1.0f));
+
+    finished = (m_finished_nodes == m_nodes.size());
+    if (finished) {
+      // cancel() is iterating the nodes, it will call the "finished"
+      // callback when it's done.
+      if (m_cancelling > 0) {
+        m_finish_deferred = true;
+        finished = false;
+      }
+      else
+        m_running = false;
+    }
+  }
+
+  if (finished)
+    call_finished();
+}
+
+// Executes the "finished" callback of the graph (if it was set). The
+// callback and the token are copied because the graph can be
+// destroyed inside the callback.
+void task_graph::call_finished()
+{
+  if (m_finished) {
+    try {
+      finfunc_t finished = m_finished;
+      task_token graphToken = m_token;
+      finished(graphToken);
+    }
+    catch (const std::exception& ex) {
+      LOG(ERROR, "Exception executing 'finished' callback: %s\n", ex.what());
+    }
+  }
+}
+
+// Must be called with m_mutex locked.
+void task_graph::finish_node(node_id id, bool canceled)
+{
+  node& n = *m_nodes[id];
+  ASSERT(!n.finished);
+
+  n.finished = true;
+  n.canceled = canceled;
+  ++m_finished_nodes;
+
+  for (node_id o : n.outputs) {
+    node& out = *m_nodes[o];
+    if (canceled || m_token.canceled())
+      out.canceled_input = true;
+
+    // All inputs are finished, now we can start this node or cancel
+    // it if one of the inputs was canceled.
+    if (--out.pending == 0) {
+      if (out.canceled_input)
+        finish_node(o, true);
+      else
+        start_node(o);
+    }
+  }
+}
+
+// Must be called with m_mutex locked.
+float task_graph::finished_progress() const
+{
+  if (m_total_weight <= 0.0f)
+    return 0.0f;
+
+  float w = 0.0f;
+  for (const auto& n : m_nodes) {
+    if (n->finished)
+      w += n->weight;
+  }
+  return w / m_total_weight;
+}
+
+} // namespace base
@@ -0,0 +1,114 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_TASK_GRAPH_H_INCLUDED
+#define BASE_TASK_GRAPH_H_INCLUDED
+#pragma once
+
+#include "base/disable_copying.h"
+#include "base/task.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace base {
+
+class thread_pool;
+
+// A set of tasks (nodes) with dependencies between them (edges). A
+// node is started in the thread pool as soon as all the nodes it
+// depends on are finished, so independent branches of the graph
+// (e.g. decode -> convert -> pack -> encode for several files) can
+// overlap.
+//
+// If a node is canceled (its task_token is canceled), all the nodes
+// that depend on it (directly or indirectly) are canceled too and
+// never executed. Other branches continue running.
+class task_graph {
+public:
+  typedef size_t node_id;
+  typedef task::func_t func_t;
+  typedef task::finfunc_t finfunc_t;
+
+  task_graph();
+  ~task_graph();
+
+  // Adds a new node to the graph. The weight is the relative cost of
+  // this node to calculate the aggregated progress of the graph.
+  node_id add(func_t&& f, float weight = 1.0f);
+
+  // The "node" will be started after "input" finishes. To avoid
+  // cycles, the input must be added before the node.
+  void add_dependency(node_id node, node_id input);
+
+  // Called when all nodes are finished or canceled. It's safe to
+  // destroy the graph inside this callback.
+  void on_finished(finfunc_t&& f) { m_finished = std::move(f); }
+
+  // Token of the whole graph. You can use set_progress_range() on it
+  // before calling start() to map the aggregated progress to a
+  // sub-range (e.g. when the graph is one step of a bigger process).
+  task_token& token() { return m_token; }
+
+  // Starts all nodes without dependencies. Returns the token of the
+  // whole graph.
+  task_token& start(thread_pool& pool);
+
+  // Cancels the whole graph: running nodes get their tokens
+  // canceled, enqueued nodes are removed from the pool, and pending
+  // nodes will not be executed.
+  void cancel();
+
+  // Aggregated progress of all nodes (weighted by the node weights
+  // and mapped to the token progress range).
+  float progress() const;
+
+  bool running() const;
+  bool completed() const;
+
+  // Returns true if the given node was canceled (or wasn't executed
+  // because one of its inputs was canceled).
+  bool canceled(node_id node) const;
+
+private:
+  struct node {
+    base::task task;
+    func_t func;
+    float weight = 1.0f;
+    std::vector<node_id> outputs;
+    int inputs = 0;
+    int pending = 0;
+    bool canceled_input = false;
+    bool started = false;
+    bool finished = false;
+    bool canceled = false;
+    task_token* token = nullptr;
+  };
+
+  void start_node(node_id id);
+  void on_node_finished(node_id id, const task_token& token);
+  void finish_node(node_id id, bool canceled);
+  void call_finished();
+  float finished_progress() const;
+
+  mutable std::mutex m_mutex;
+  std::vector<std::unique_ptr<node>> m_nodes;
+  thread_pool* m_pool = nullptr;
+  task_token m_token;
+  finfunc_t m_finished = nullptr;
+  float m_total_weight = 0.0f;
+  size_t m_finished_nodes = 0;
+  int m_cancelling = 0;
+  bool m_finish_deferred = false;
+  bool m_running = false;
+
+  DISABLE_COPYING(task_graph);
+};
+
+} // namespace base
+
+#endif
@@ -0,0 +1,172 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/task_graph.h"
+#include "base/thread_pool.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace base;
+
+TEST(TaskGraph, Order)
+{
+  thread_pool p(4);
+  task_graph g;
+  std::mutex m;
+  std::vector<int> order;
+  auto push = [&m, &order](int i) {
+    const std::lock_guard lock(m);
+    order.push_back(i);
+  };
+
+  // a -> c <- b, c -> d
+  auto a = g.add([&](task_token&) { push(0); });
+  auto b = g.add([&](task_token&) { push(1); });
+  auto c = g.add([&](task_token&) { push(2); });
+  auto d = g.add([&](task_token&) { push(3); });
+  g.add_dependency(c, a);
+  g.add_dependency(c, b);
+  g.add_dependency(d, c);
+
+  std::atomic<bool> finished(false);
+  g.on_finished([&finished](const task_token&) { finished = true; });
+  g.start(p);
+  p.wait_all();
+
+  EXPECT_TRUE(finished);
+  EXPECT_TRUE(g.completed());
+  ASSERT_EQ(4u, order.size());
+  EXPECT_EQ(2, order[2]);
+  EXPECT_EQ(3, order[3]);
+  EXPECT_EQ(1.0f, g.progress());
+}
+
+TEST(TaskGraph, Empty)
+{
+  thread_pool p(1);
+  task_graph g;
+  bool finished = false;
+  g.on_finished([&finished](const task_token&) { finished = true; });
+  g.start(p);
+  EXPECT_TRUE(finished);
+  EXPECT_TRUE(g.completed());
+}
+
+TEST(TaskGraph, CancelPropagation)
+{
+  thread_pool p(4);
+  task_graph g;
+  std::atomic<int> c(0);
+
+  // a -> b -> d, c -> d, e (independent)
+  auto a = g.add([](task_token& t) { t.cancel(); });
+  auto b = g.add([&c](task_token&) { ++c; });
+  auto cc = g.add([&c](task_token&) { ++c; });
+  auto d = g.add([&c](task_token&) { ++c; });
+  auto e = g.add([&c](task_token&) { c += 10; });
+  g.add_dependency(b, a);
+  g.add_dependency(d, b);
+  g.add_dependency(d, cc);
+  g.start(p);
+  p.wait_all();
+
+  EXPECT_TRUE(g.completed());
+  EXPECT_EQ(11, c);
+  EXPECT_TRUE(g.canceled(a));
+  EXPECT_TRUE(g.canceled(b));
+  EXPECT_FALSE(g.canceled(cc));
+  EXPECT_TRUE(g.canceled(d));
+  EXPECT_FALSE(g.canceled(e));
+}
+
+TEST(TaskGraph, CancelGraph)
+{
+  thread_pool p(1);
+  task_graph g;
+  std::atomic<bool> started(false);
+  std::atomic<int> c(0);
+
+  auto a = g.add([&started](task_token& t) {
+    started = true;
+    while (!t.canceled())
+      std::this_thread::yield();
+  });
+  auto b = g.add([&c](task_token&) { ++c; });
+  g.add_dependency(b, a);
+  g.start(p);
+  while (!started)
+    std::this_thread::yield();
+  g.cancel();
+  p.wait_all();
+
+  EXPECT_TRUE(g.completed());
+  EXPECT_EQ(0, c);
+  EXPECT_TRUE(g.canceled(a));
+  EXPECT_TRUE(g.canceled(b));
+}
+
+TEST(TaskGraph, DestroyOnCancel)
+{
+  for (int i = 0; i < 100; ++i) {
+    thread_pool p(1);
+    auto g = std::make_unique<task_graph>();
+    std::atomic<bool> started(false);
+    std::atomic<bool> destroyed(false);
+
+    g->add([&started](task_token& t) {
+      started = true;
+      while (!t.canceled())
+        std::this_thread::yield();
+    });
+    g->add([](task_token&) {});
+    g->add([](task_token&) {});
+    g->on_finished([&g, &destroyed](const task_token&) {
+      // Destroying the graph inside the callback must be safe even
+      // when it's called from cancel().
+      g.reset();
+      destroyed = true;
+    });
+    g->start(p);
+    while (!started)
+      std::this_thread::yield();
+    g->cancel();
+    p.wait_all();
+
+    EXPECT_TRUE(destroyed);
+  }
+}
+
+TEST(TaskGraph, ProgressRange)
+{
+  thread_pool p(2);
+  task_graph g;
+  std::atomic<float> middle(0.0f);
+  std::atomic<float> finished(0.0f);
+
+  auto a = g.add([](task_token& t) { t.set_progress(1.0f); }, 3.0f);
+  auto b = g.add([&g, &middle](task_token&) { middle = g.progress(); }, 1.0f);
+  g.add_dependency(b, a);
+  g.on_finished([&finished](const task_token& t) { finished = t.progress(); });
+
+  g.token().set_progress_range(0.5f, 1.0f);
+  g.start(p);
+  p.wait_all();
+
+  EXPECT_FLOAT_EQ(0.875f, middle);
+  EXPECT_FLOAT_EQ(1.0f, finished);
+  EXPECT_FLOAT_EQ(1.0f, g.progress());
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
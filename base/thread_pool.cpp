@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -11,14 +11,75 @@
 #include "base/debug.h"
 #include "base/log.h"
 #include "base/thread_pool.h"
+#include "base/trace.h"
+
+#include <algorithm>
 
 namespace base {
 
-thread_pool::thread_pool(const size_t n) : m_running(true), m_threads(n), m_doingWork(0)
+namespace {
+
+// Pool and index of the worker running in the current thread (only
+// for WORK_STEALING pools). Used to push new work directly in the
+// local queue of the worker when a work enqueues more work.
+thread_local const thread_pool* t_pool = nullptr;
+thread_local size_t t_index = 0;
+
+// Maximum number of works that a worker takes from the global queue
+// at once.
+constexpr size_t kMaxBatch = 32;
+
+// Each how many works a worker checks the global queue before its
+// local queue.
+constexpr int kGlobalCheck = 16;
+
+// Default value for set_max_wait() (in milliseconds).
+constexpr tick_t kDefaultMaxWait = 250;
+
+void run_work(const std::function<void()>& func)
+{
+  TRACE_SCOPE("base", "thread_pool::work");
+  try {
+    if (func)
+      func();
+  }
+  // TODO handle exceptions in a better way
+  catch (const std::exception& e) {
+    LOG(FATAL, "Exception from worker: %s", e.what());
+    ASSERT(false);
+  }
+  catch (...) {
+    LOG(FATAL, "Exception from worker\n");
+    ASSERT(false);
+  }
+}
+
+} // anonymous namespace
+
+thread_pool::thread_pool(const size_t n, const mode m)
+  : m_mode(m)
+  , m_running(true)
+  , m_threads(n)
+  , m_doingWork(0)
+  , m_maxWait(kDefaultMaxWait)
+  , m_stop(false)
+  , m_queued(0)
+  , m_pending(0)
+  , m_sleeping(0)
 {
+  if (m_mode == mode::WORK_STEALING) {
+    m_local.resize(n);
+    for (auto& q : m_local)
+      q = std::make_unique<local_queue>();
+  }
+
   const std::unique_lock lock(m_mutex);
-  for (size_t i = 0; i < n; ++i)
-    m_threads[i] = std::thread([this] { worker(); });
+  for (size_t i = 0; i < n; ++i) {
+    if (m_mode == mode::WORK_STEALING)
+      m_threads[i] = std::thread([this, i] { stealing_worker(i); });
+    else
+      m_threads[i] = std::thread([this] { worker(); });
+  }
 }
 
 thread_pool::~thread_pool()
@@ -26,34 +87,105 @@ thread_pool::~thread_pool()
   join_all();
 }
 
-const thread_pool::work* thread_pool::execute(std::function<void()>&& func)
+const thread_pool::work* thread_pool::execute(std::function<void()>&& func,
+                                              const priority p,
+                                              const tick_t deadline)
 {
   thread_pool::work_ptr work = std::make_unique<thread_pool::work>(std::move(func));
   const thread_pool::work* result = work.get();
+  work->m_priority = p;
+  work->m_enqueued = current_tick();
+  work->m_deadline = deadline;
+  ++m_stats[int(p)].queued;
+
+  if (m_mode == mode::WORK_STEALING) {
+    ++m_pending;
+
+    // Normal work enqueued from one of our workers goes to its local
+    // queue.
+    if (t_pool == this && p == priority::NORMAL && deadline == 0) {
+      {
+        local_queue& q = *m_local[t_index];
+        const std::unique_lock lock(q.mutex);
+        q.work.push_back(std::move(work));
+      }
+      ++m_queued;
+      if (m_sleeping > 0) {
+        const std::unique_lock lock(m_mutex);
+        m_cv.notify_one();
+      }
+      return result;
+    }
+  }
+
   const std::unique_lock lock(m_mutex);
   ASSERT(m_running);
-  m_work.push_back(std::move(work));
+  push_global(std::move(work));
+  ++m_queued;
   m_cv.notify_one();
   return result;
 }
 
 bool thread_pool::try_pop(const work* w)
 {
-  std::unique_lock<std::mutex> lock(m_mutex);
-  for (auto it = m_work.begin(); it != m_work.end(); ++it) {
-    if (w == it->get()) {
-      m_work.erase(it);
-      return true;
+  auto erase_from = [this, w](std::deque<work_ptr>& work) -> bool {
+    for (auto it = work.begin(); it != work.end(); ++it) {
+      if (w == it->get()) {
+        --m_stats[int((*it)->m_priority)].queued;
+        work.erase(it);
+        return true;
+      }
+    }
+    return false;
+  };
+
+  bool popped = false;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (auto& lane : m_work) {
+      if (erase_from(lane)) {
+        popped = true;
+        break;
+      }
+    }
+    if (popped && m_mode == mode::SHARED_QUEUE) {
+      --m_queued;
+      m_cvWait.notify_all();
     }
   }
-  return false;
+  if (m_mode == mode::WORK_STEALING) {
+    for (size_t i = 0; i < m_local.size() && !popped; ++i) {
+      local_queue& q = *m_local[i];
+      const std::unique_lock lock(q.mutex);
+      popped = erase_from(q.work);
+    }
+    if (popped) {
+      --m_queued;
+      done_work();
+    }
+  }
+  return popped;
 }
 
 void thread_pool::wait_all()
 {
   std::unique_lock<std::mutex> lock(m_mutex);
-  m_cvWait.wait(lock,
-                [this]() -> bool { return !m_running || (m_work.empty() && m_doingWork == 0); });
+  if (m_mode == mode::WORK_STEALING)
+    m_cvWait.wait(lock, [this]() -> bool { return !m_running || m_pending == 0; });
+  else
+    m_cvWait.wait(lock,
+                  [this]() -> bool { return !m_running || (m_queued == 0 && m_doingWork == 0); });
+}
+
+thread_pool::lane_stats thread_pool::stats(const priority p) const
+{
+  const atomic_lane_stats& s = m_stats[int(p)];
+  lane_stats result;
+  result.queued = s.queued;
+  result.executed = s.executed;
+  result.max_wait = s.max_wait;
+  result.total_wait = s.total_wait;
+  return result;
 }
 
 void thread_pool::join_all()
@@ -61,8 +193,10 @@ void thread_pool::join_all()
   {
     const std::unique_lock lock(m_mutex);
     m_running = false;
+    m_stop = true;
   }
   m_cv.notify_all();
+  m_cvWait.notify_all();
 
   for (auto& j : m_threads) {
     try {
@@ -91,27 +225,17 @@ void thread_pool::worker()
     std::function<void()> func;
     {
       std::unique_lock<std::mutex> lock(m_mutex);
-      m_cv.wait(lock, [this]() -> bool { return !m_running || !m_work.empty(); });
+      m_cv.wait(lock, [this]() -> bool { return !m_running || m_queued > 0; });
       running = m_running;
-      if (m_running && !m_work.empty()) {
-        func = std::move(m_work.front()->m_func);
+      if (m_running && m_queued > 0) {
+        work_ptr work = pop_next();
+        ASSERT(work);
+        func = std::move(work->m_func);
         ++m_doingWork;
-        m_work.pop_front();
+        --m_queued;
       }
     }
-    try {
-      if (func)
-        func();
-    }
-    // TODO handle exceptions in a better way
-    catch (const std::exception& e) {
-      LOG(FATAL, "Exception from worker: %s", e.what());
-      ASSERT(false);
-    }
-    catch (...) {
-      LOG(FATAL, "Exception from worker\n");
-      ASSERT(false);
-    }
+    run_work(func);
 
     // Decrement m_doingWork only if we've incremented it
     if (func) {
@@ -122,4 +246,195 @@ void thread_pool::worker()
   }
 }
 
+void thread_pool::stealing_worker(const size_t index)
+{
+  t_pool = this;
+  t_index = index;
+
+  int count = 0;
+  while (!m_stop) {
+    // Global work is checked first when there is high priority work
+    // or each kGlobalCheck iterations (so works with deadlines or
+    // that have waited too much are not starved by local work).
+    work_ptr work;
+    if (m_stats[int(priority::HIGH)].queued > 0 || (++count % kGlobalCheck) == 0)
+      work = pop_global();
+    if (!work)
+      work = pop_local(index);
+    if (!work)
+      work = pop_global();
+    if (!work)
+      work = steal(index);
+
+    if (work) {
+      --m_queued;
+      run_work(work->m_func);
+      work.reset();
+      done_work();
+      continue;
+    }
+
+    // Nothing to do, wait for new work
+    std::unique_lock<std::mutex> lock(m_mutex);
+    ++m_sleeping;
+    m_cv.wait(lock, [this]() -> bool { return m_stop || m_queued > 0; });
+    --m_sleeping;
+  }
+
+  t_pool = nullptr;
+}
+
+thread_pool::work_ptr thread_pool::pop_local(const size_t index)
+{
+  local_queue& q = *m_local[index];
+  const std::unique_lock lock(q.mutex);
+  if (q.work.empty())
+    return nullptr;
+
+  // The owner takes the most recent work (LIFO) as it's probably
+  // hot in the cache.
+  work_ptr work = std::move(q.work.back());
+  q.work.pop_back();
+  on_dequeue(*work);
+  return work;
+}
+
+thread_pool::work_ptr thread_pool::pop_global()
+{
+  work_ptr work;
+  std::vector<work_ptr> batch;
+  {
+    const std::unique_lock lock(m_mutex);
+    work = pop_next();
+    if (!work)
+      return nullptr;
+
+    // Take a fair share of the remaining normal priority works to our
+    // local queue so we don't need to lock m_mutex for each work.
+    // High priority works stay in the global queue to be taken by
+    // the first available worker, and low priority ones so they
+    // don't run before global normal works. Works with deadlines
+    // (sorted at the beginning of the lane) stay in the global queue
+    // too, so they keep their EDF order and max_wait guarantee.
+    if (work->m_priority == priority::NORMAL) {
+      auto& lane = m_work[int(priority::NORMAL)];
+      auto begin = lane.begin();
+      while (begin != lane.end() && (*begin)->m_deadline != 0)
+        ++begin;
+
+      const size_t n = std::min(size_t(lane.end() - begin) / m_threads.size(), kMaxBatch);
+      auto end = begin + n;
+      for (auto it = begin; it != end; ++it)
+        batch.push_back(std::move(*it));
+      lane.erase(begin, end);
+    }
+  }
+
+  if (!batch.empty()) {
+    local_queue& q = *m_local[t_index];
+    const std::unique_lock lock(q.mutex);
+    // Reversed so the owner pops them in FIFO order
+    for (auto it = batch.rbegin(); it != batch.rend(); ++it)
+      q.work.push_back(std::move(*it));
+  }
+  return work;
+}
+
+thread_pool::work_ptr thread_pool::steal(const size_t index)
+{
+  const size_t n = m_local.size();
+  for (size_t i = 1; i < n; ++i) {
+    local_queue& q = *m_local[(index + i) % n];
+    const std::unique_lock lock(q.mutex);
+    if (!q.work.empty()) {
+      // Thieves take the oldest work (FIFO)
+      work_ptr work = std::move(q.work.front());
+      q.work.pop_front();
+      on_dequeue(*work);
+      return work;
+    }
+  }
+  return nullptr;
+}
+
+void thread_pool::push_global(work_ptr&& work)
+{
+  auto& lane = m_work[int(work->m_priority)];
+  if (work->m_deadline == 0) {
+    lane.push_back(std::move(work));
+    return;
+  }
+
+  // Works with deadlines are sorted by deadline at the beginning of
+  // the lane (earliest deadline first).
+  auto it = lane.begin();
+  while (it != lane.end() && (*it)->m_deadline != 0 && (*it)->m_deadline <= work->m_deadline)
+    ++it;
+  lane.insert(it, std::move(work));
+}
+
+thread_pool::work_ptr thread_pool::pop_next()
+{
+  // Each lane has a "due" time for its first work: its deadline, or
+  // the time it was enqueued plus m_maxWait (to avoid starving low
+  // priority lanes). Overdue works are executed first (the earliest
+  // one), in other case we take the work from the lane with highest
+  // priority.
+  const tick_t now = current_tick();
+  const tick_t maxWait = m_maxWait;
+  int best = -1;
+  tick_t bestDue = 0;
+  for (int i = 0; i < kPriorities; ++i) {
+    if (m_work[i].empty())
+      continue;
+
+    const work& w = *m_work[i].front();
+    tick_t due = w.m_enqueued + maxWait;
+    if (w.m_deadline != 0)
+      due = std::min(due, w.m_deadline);
+
+    if (due <= now && (best < 0 || due < bestDue)) {
+      best = i;
+      bestDue = due;
+    }
+  }
+  if (best < 0) {
+    for (int i = 0; i < kPriorities; ++i) {
+      if (!m_work[i].empty()) {
+        best = i;
+        break;
+      }
+    }
+    if (best < 0)
+      return nullptr;
+  }
+
+  work_ptr work = std::move(m_work[best].front());
+  m_work[best].pop_front();
+  on_dequeue(*work);
+  return work;
+}
+
+void thread_pool::on_dequeue(const work& work)
+{
+  atomic_lane_stats& s = m_stats[int(work.m_priority)];
+  const tick_t now = current_tick();
+  const tick_t wait = (now > work.m_enqueued ? now - work.m_enqueued : 0);
+  --s.queued;
+  ++s.executed;
+  s.total_wait += wait;
+
+  tick_t maxWait = s.max_wait;
+  while (wait > maxWait && !s.max_wait.compare_exchange_weak(maxWait, wait))
+    ;
+}
+
+void thread_pool::done_work()
+{
+  if (--m_pending == 0) {
+    const std::unique_lock lock(m_mutex);
+    m_cvWait.notify_all();
+  }
+}
+
 } // namespace base
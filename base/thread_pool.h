@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -8,9 +8,14 @@
 #define BASE_THREAD_POOL_H_INCLUDED
 #pragma once
 
+#include "base/fixed_pool.h"
+#include "base/time.h"
+
+#include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -19,7 +24,20 @@ namespace base {
 
 class thread_pool {
 public:
-  class work {
+  // Priority lanes. Works in a lane are executed only when the lanes
+  // with higher priority are empty, except when a work waited too
+  // much time in the queue (see set_max_wait()) or its deadline was
+  // reached.
+  enum class priority {
+    HIGH,   // Interactive work (e.g. thumbnails of the visible viewport)
+    NORMAL, // Default priority
+    LOW,    // Background work (e.g. backups)
+  };
+  static constexpr int kPriorities = 3;
+
+  // Works are allocated from the base::fixed_pool as they are
+  // created/destroyed at a high rate.
+  class work : public pooled_object<work> {
     friend class thread_pool;
 
   public:
@@ -27,14 +45,45 @@ public:
 
   private:
     std::function<void()> m_func = nullptr;
+    priority m_priority = priority::NORMAL;
+    tick_t m_enqueued = 0;
+    tick_t m_deadline = 0; // Zero if it doesn't have a deadline
+  };
+
+  // Statistics of one priority lane.
+  struct lane_stats {
+    int queued = 0;          // Works waiting in the queue right now
+    uint64_t executed = 0;   // Total number of works executed
+    tick_t max_wait = 0;     // Max time (msecs) a work waited in the queue
+    uint64_t total_wait = 0; // Sum of wait times (msecs) of all executed works
   };
 
   typedef std::unique_ptr<work> work_ptr;
 
-  thread_pool(const size_t n);
+  enum class mode {
+    // All workers take work from one FIFO queue protected by one
+    // mutex.
+    SHARED_QUEUE,
+
+    // Each worker has its own deque (LIFO for the owner) and steals
+    // from the other workers when it runs out of work. Work added
+    // from outside the pool goes to a global injection queue. Scales
+    // better when lots of small jobs are executed, and when jobs
+    // enqueue more jobs.
+    WORK_STEALING,
+  };
+
+  thread_pool(const size_t n, const mode m = mode::SHARED_QUEUE);
   ~thread_pool();
 
-  const work* execute(std::function<void()>&& func);
+  size_t size() const { return m_threads.size(); }
+
+  // Enqueues the given function to be executed in a worker thread.
+  // The deadline is an absolute base::current_tick() value, when it's
+  // reached the work is executed before works with higher priority.
+  const work* execute(std::function<void()>&& func,
+                      const priority p = priority::NORMAL,
+                      const tick_t deadline = 0);
 
   // Removes the specified work from the queue if possible. Returns true if it
   // was able to do so, or false otherwise.
@@ -43,20 +92,70 @@ public:
   // Waits until the queue is empty.
   void wait_all();
 
+  // Works that waited more than "msecs" in the queue are executed
+  // before works with higher priority to avoid starvation.
+  void set_max_wait(const tick_t msecs) { m_maxWait = msecs; }
+
+  lane_stats stats(const priority p) const;
+
 private:
+  // Local queue of a worker in WORK_STEALING mode.
+  struct local_queue {
+    std::mutex mutex;
+    std::deque<work_ptr> work;
+  };
+
   // Joins all threads without waiting the queue to be processed.
   void join_all();
 
   // Called for each worker thread.
   void worker();
+  void stealing_worker(const size_t index);
+
+  // Adds the work to its lane (m_mutex must be locked).
+  void push_global(work_ptr&& work);
+
+  // Gets the next work from the priority lanes (m_mutex must be
+  // locked).
+  work_ptr pop_next();
+
+  // Updates statistics of a work that is going to be executed.
+  void on_dequeue(const work& work);
 
+  // Functions to get work in WORK_STEALING mode.
+  work_ptr pop_local(const size_t index);
+  work_ptr pop_global();
+  work_ptr steal(const size_t index);
+
+  // Called when a work is finished (or removed from the queue) in
+  // WORK_STEALING mode.
+  void done_work();
+
+  const mode m_mode;
   bool m_running;
   std::vector<std::thread> m_threads;
   std::mutex m_mutex;
   std::condition_variable m_cv;
   std::condition_variable m_cvWait;
-  std::deque<work_ptr> m_work;
+  std::deque<work_ptr> m_work[kPriorities];
   int m_doingWork;
+  std::atomic<tick_t> m_maxWait;
+
+  struct atomic_lane_stats {
+    std::atomic<int> queued = 0;
+    std::atomic<uint64_t> executed = 0;
+    std::atomic<tick_t> max_wait = 0;
+    std::atomic<uint64_t> total_wait = 0;
+  };
+  atomic_lane_stats m_stats[kPriorities];
+
+  // Fields used in WORK_STEALING mode, in this case m_work is the
+  // global injection queue.
+  std::vector<std::unique_ptr<local_queue>> m_local;
+  std::atomic<bool> m_stop;
+  std::atomic<int> m_queued;   // Works waiting in some queue
+  std::atomic<int> m_pending;  // Works queued or running
+  std::atomic<int> m_sleeping; // Workers waiting in m_cv
 };
 
 } // namespace base
@@ -1,14 +1,19 @@
 // LAF Base Library
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
 
 #include <gtest/gtest.h>
 
+#include "base/chrono.h"
 #include "base/thread_pool.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <vector>
 
 using namespace base;
 
@@ -23,6 +28,162 @@ TEST(ThreadPool, Basic)
   EXPECT_EQ(10000, c);
 }
 
+TEST(ThreadPool, WorkStealing)
+{
+  thread_pool p(10, thread_pool::mode::WORK_STEALING);
+  std::atomic<int> c(0);
+  for (int i = 0; i < 10000; ++i)
+    p.execute([&c] { ++c; });
+  p.wait_all();
+
+  EXPECT_EQ(10000, c);
+}
+
+TEST(ThreadPool, WorkStealingNested)
+{
+  thread_pool p(4, thread_pool::mode::WORK_STEALING);
+  std::atomic<int> c(0);
+  for (int i = 0; i < 100; ++i) {
+    p.execute([&p, &c] {
+      for (int j = 0; j < 100; ++j)
+        p.execute([&c] { ++c; });
+    });
+  }
+  p.wait_all();
+
+  EXPECT_EQ(10000, c);
+}
+
+TEST(ThreadPool, WorkStealingTryPop)
+{
+  thread_pool p(1, thread_pool::mode::WORK_STEALING);
+  std::atomic<bool> go(false);
+  std::atomic<int> c(0);
+  p.execute([&go] {
+    while (!go)
+      std::this_thread::yield();
+  });
+  const thread_pool::work* w = p.execute([&c] { ++c; });
+  EXPECT_TRUE(p.try_pop(w));
+  go = true;
+  p.wait_all();
+
+  EXPECT_EQ(0, c);
+}
+
+TEST(ThreadPool, Priorities)
+{
+  for (auto mode : { thread_pool::mode::SHARED_QUEUE, thread_pool::mode::WORK_STEALING }) {
+    thread_pool p(1, mode);
+    p.set_max_wait(60000);
+
+    // Block the only worker until all works are enqueued
+    std::atomic<bool> started(false);
+    std::atomic<bool> go(false);
+    p.execute([&started, &go] {
+      started = true;
+      while (!go)
+        std::this_thread::yield();
+    });
+    while (!started)
+      std::this_thread::yield();
+
+    std::mutex m;
+    std::vector<int> order;
+    auto push = [&m, &order](int i) {
+      const std::lock_guard lock(m);
+      order.push_back(i);
+    };
+    p.execute([&] { push(0); }, thread_pool::priority::LOW);
+    p.execute([&] { push(1); }, thread_pool::priority::NORMAL);
+    p.execute([&] { push(2); }, thread_pool::priority::HIGH);
+    p.execute([&] { push(3); }, thread_pool::priority::NORMAL, current_tick() + 1000);
+    p.execute([&] { push(4); }, thread_pool::priority::HIGH);
+
+    EXPECT_EQ(2, p.stats(thread_pool::priority::HIGH).queued);
+    EXPECT_EQ(2, p.stats(thread_pool::priority::NORMAL).queued);
+    EXPECT_EQ(1, p.stats(thread_pool::priority::LOW).queued);
+
+    go = true;
+    p.wait_all();
+
+    EXPECT_EQ((std::vector<int>{ 2, 4, 3, 1, 0 }), order);
+    EXPECT_EQ(0, p.stats(thread_pool::priority::HIGH).queued);
+    EXPECT_EQ(2, p.stats(thread_pool::priority::HIGH).executed);
+    EXPECT_EQ(3, p.stats(thread_pool::priority::NORMAL).executed);
+    EXPECT_EQ(1, p.stats(thread_pool::priority::LOW).executed);
+  }
+}
+
+TEST(ThreadPool, Starvation)
+{
+  thread_pool p(1);
+  p.set_max_wait(0);
+
+  std::atomic<bool> go(false);
+  p.execute([&go] {
+    while (!go)
+      std::this_thread::yield();
+  });
+
+  std::vector<int> order;
+  p.execute([&order] { order.push_back(0); }, thread_pool::priority::LOW);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  p.execute([&order] { order.push_back(1); }, thread_pool::priority::HIGH);
+  go = true;
+  p.wait_all();
+
+  // With max wait = 0, the oldest work is always overdue
+  EXPECT_EQ((std::vector<int>{ 0, 1 }), order);
+}
+
+TEST(ThreadPool, DeadlineReached)
+{
+  thread_pool p(1);
+  p.set_max_wait(60000);
+
+  std::atomic<bool> go(false);
+  p.execute([&go] {
+    while (!go)
+      std::this_thread::yield();
+  });
+
+  std::vector<int> order;
+  p.execute([&order] { order.push_back(0); }, thread_pool::priority::HIGH);
+  p.execute([&order] { order.push_back(1); }, thread_pool::priority::LOW, current_tick());
+  go = true;
+  p.wait_all();
+
+  EXPECT_EQ((std::vector<int>{ 1, 0 }), order);
+}
+
+// Throughput of small jobs from 1 to N threads in both modes. It's a
+// benchmark, so it's disabled by default (use the
+// --gtest_also_run_disabled_tests flag to run it).
+TEST(ThreadPool, DISABLED_Scaling)
+{
+  const int kJobs = 100000;
+  const int maxThreads = std::max(1, int(std::thread::hardware_concurrency()));
+
+  for (auto mode : { thread_pool::mode::SHARED_QUEUE, thread_pool::mode::WORK_STEALING }) {
+    for (int n = 1; n <= maxThreads; n *= 2) {
+      thread_pool p(n, mode);
+      std::atomic<int> c(0);
+      Chrono chrono;
+      for (int i = 0; i < kJobs; ++i)
+        p.execute([&c] { ++c; });
+      p.wait_all();
+      const double t = chrono.elapsed();
+      EXPECT_EQ(kJobs, c);
+
+      std::printf("%s %2d threads: %.0f jobs/sec\n",
+                  (mode == thread_pool::mode::SHARED_QUEUE ? "shared  " : "stealing"),
+                  n,
+                  kJobs / t);
+    }
+  }
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
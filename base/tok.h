@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2024 Igara Studio S.A.
+// Copyright (c) 2024-2025 Igara Studio S.A.
 // Copyright (c) 2020 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -13,6 +13,8 @@
 
 #include <iterator>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
 namespace base { namespace tok {
 
@@ -23,72 +25,90 @@ struct include_empties {
   enum { allow_empty = true };
 };
 
+// Tokens are located in a std::basic_string_view of the original
+// string, and then assigned to a value of type T. If T is a
+// std::string_view no memory is allocated, e.g.
+//
+//   for (std::string_view tok : base::tok::split_tokens(std::string_view(str), ' '))
+//     ...
+//
 template<typename T, typename EmptyPolicy>
 class token_iterator {
 public:
   using iterator_category = std::forward_iterator_tag;
-  using internal_iterator = typename T::const_iterator;
   using char_type = typename T::value_type;
+  using view_type = std::basic_string_view<char_type>;
   using value_type = typename std::remove_const<T>::type;
-  using difference_type = typename T::difference_type;
-  using pointer = T*;
-  using reference = T&;
-  using const_reference = const T&;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const value_type*;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
 
   token_iterator() = delete;
   token_iterator(const token_iterator&) = default;
-  token_iterator(const internal_iterator& begin, const internal_iterator& end, char_type chr)
-    : begin_(begin)
-    , inter_(begin)
-    , end_(end)
+  token_iterator(const view_type& str, const size_t pos, char_type chr)
+    : str_(str)
+    , begin_(pos)
+    , inter_(pos)
     , chr_(chr)
   {
-    operator++(); // Find first word to fill "str_" field
+    operator++(); // Find first word to fill "tok_" field
   }
 
   token_iterator& operator++()
   {
+    const size_t end = str_.size();
     if constexpr (EmptyPolicy::allow_empty) {
-      if (inter_ != end_ && *inter_ == chr_) {
+      if (inter_ != end && str_[inter_] == chr_) {
         ++inter_;
       }
     }
     else {
-      while (inter_ != end_ && *inter_ == chr_) {
+      while (inter_ != end && str_[inter_] == chr_) {
         ++inter_;
       }
     }
     begin_ = inter_;
-    while (inter_ != end_ && *inter_ != chr_) {
-      ++inter_;
-    }
-    str_.assign(begin_, inter_);
+    // Uses std::char_traits::find(), i.e. memchr() for char strings
+    inter_ = str_.find(chr_, inter_);
+    if (inter_ == view_type::npos)
+      inter_ = end;
+
+    if constexpr (std::is_same_v<value_type, view_type>)
+      tok_ = view();
+    else
+      tok_.assign(str_.data() + begin_, inter_ - begin_);
     return *this;
   }
 
-  const_reference operator*() { return str_; }
+  const_reference operator*() const { return tok_; }
+
+  // Returns the current token without copying it.
+  view_type view() const { return str_.substr(begin_, inter_ - begin_); }
 
-  bool operator!=(const token_iterator& that) const { return (begin_ != that.end_); }
+  bool operator!=(const token_iterator& that) const { return (begin_ != that.str_.size()); }
 
 private:
-  internal_iterator begin_, inter_, end_;
+  view_type str_;
+  size_t begin_, inter_;
   char_type chr_;
-  value_type str_;
+  value_type tok_;
 };
 
 template<typename T, typename Empties>
 class token_range {
 public:
   using char_type = typename T::value_type;
+  using view_type = std::basic_string_view<char_type>;
   using iterator = token_iterator<T, Empties>;
 
   token_range(const T& str, char_type chr) : str_(str), chr_(chr) {}
 
-  iterator begin() const { return iterator(str_.begin(), str_.end(), chr_); }
-  iterator end() const { return iterator(str_.end(), str_.end(), chr_); }
+  iterator begin() const { return iterator(str_, 0, chr_); }
+  iterator end() const { return iterator(str_, str_.size(), chr_); }
 
 private:
-  const T& str_;
+  view_type str_;
   char_type chr_;
 };
 
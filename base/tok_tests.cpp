@@ -1,5 +1,5 @@
 // LAF Base Library
-// Copyright (c) 2024 Igara Studio S.A.
+// Copyright (c) 2024-2025 Igara Studio S.A.
 // Copyright (c) 2020 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,6 +11,7 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "base/tok.h"
@@ -39,6 +40,31 @@ TEST(Tok, Csv)
   }
 }
 
+TEST(Tok, StringView)
+{
+  const std::string str = " a,,bc,  ,def, ";
+  std::vector<std::string_view> result;
+  for (std::string_view tok : base::tok::csv(std::string_view(str), ','))
+    result.push_back(tok);
+  ASSERT_EQ(6, result.size());
+  EXPECT_EQ(" a", result[0]);
+  EXPECT_EQ("", result[1]);
+  EXPECT_EQ("bc", result[2]);
+  EXPECT_EQ("  ", result[3]);
+  EXPECT_EQ("def", result[4]);
+  EXPECT_EQ(" ", result[5]);
+
+  // Tokens point to the original string
+  EXPECT_EQ(str.data(), result[0].data());
+
+  result.clear();
+  for (std::string_view tok : base::tok::split_tokens(std::string_view(str), ' '))
+    result.push_back(tok);
+  ASSERT_EQ(2, result.size());
+  EXPECT_EQ("a,,bc,", result[0]);
+  EXPECT_EQ(",def,", result[1]);
+}
+
 int main(int argc, char** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,237 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "base/trace.h"
+
+#include "base/fstream_path.h"
+#include "base/thread.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace base {
+
+namespace details {
+std::atomic<bool> trace_enabled(false);
+}
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+// Each thread has up to kMaxChunks*kChunkSize events (~1M events).
+constexpr size_t kChunkSize = 4096;
+constexpr size_t kMaxChunks = 256;
+
+struct event {
+  const char* category;
+  const char* name;
+  int64_t ts;
+  int64_t dur;
+};
+
+// Events of one thread. Only the owner thread adds events, so we
+// don't need locks: the number of events is published with a
+// release store and trace_write() reads it with an acquire load.
+// Chunks are never freed/moved while the thread is alive, so the
+// events already recorded don't move.
+struct trace_buffer {
+  int tid;
+  std::string thread_name;
+  std::atomic<int> generation;
+  std::atomic<size_t> count;
+  std::atomic<size_t> dropped;
+  std::atomic<bool> dead;
+  std::unique_ptr<event[]> chunks[kMaxChunks];
+
+  trace_buffer(int tid, int generation)
+    : tid(tid)
+    , thread_name(this_thread::get_name())
+    , generation(generation)
+    , count(0)
+    , dropped(0)
+    , dead(false)
+  {
+  }
+};
+
+struct buffer_holder {
+  std::shared_ptr<trace_buffer> buffer;
+  ~buffer_holder()
+  {
+    if (buffer)
+      buffer->dead = true;
+  }
+};
+
+std::atomic<int64_t> g_start(0); // clock::now() at trace_start() in nanoseconds
+std::atomic<int> g_generation(0);
+std::atomic<int> g_nextTid(1);
+std::mutex g_mutex;
+std::vector<std::shared_ptr<trace_buffer>> g_buffers;
+
+trace_buffer& thread_buffer()
+{
+  thread_local buffer_holder holder;
+  if (!holder.buffer) {
+    holder.buffer = std::make_shared<trace_buffer>(g_nextTid++, g_generation.load());
+    const std::lock_guard lock(g_mutex);
+    g_buffers.push_back(holder.buffer);
+  }
+  return *holder.buffer;
+}
+
+void write_string(std::ostream& os, const char* s)
+{
+  os << '"';
+  for (; *s; ++s) {
+    if (*s == '"' || *s == '\\')
+      os << '\\' << *s;
+    else if (uint8_t(*s) >= 0x20)
+      os << *s;
+  }
+  os << '"';
+}
+
+} // anonymous namespace
+
+void trace_start()
+{
+  const std::lock_guard lock(g_mutex);
+
+  // Buffers of finished threads can be deleted, and the rest are
+  // cleared by their owners when they add a new event.
+  g_buffers.erase(std::remove_if(g_buffers.begin(),
+                                 g_buffers.end(),
+                                 [](const auto& buffer) { return buffer->dead.load(); }),
+                  g_buffers.end());
+
+  g_start = std::chrono::duration_cast<std::chrono::nanoseconds>(
+              clock::now().time_since_epoch())
+              .count();
+  ++g_generation;
+  details::trace_enabled = true;
+}
+
+void trace_stop()
+{
+  details::trace_enabled = false;
+}
+
+int64_t trace_now()
+{
+  const int64_t now =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+  return (now - g_start.load(std::memory_order_relaxed)) / 1000;
+}
+
+void trace_event(const char* category, const char* name, int64_t ts)
+{
+  const int64_t now = trace_now();
+  trace_buffer& buffer = thread_buffer();
+
+  const int generation = g_generation.load(std::memory_order_relaxed);
+  if (buffer.generation.load(std::memory_order_relaxed) != generation) {
+    buffer.count.store(0, std::memory_order_release);
+    buffer.dropped = 0;
+    buffer.generation = generation;
+  }
+
+  const size_t i = buffer.count.load(std::memory_order_relaxed);
+  if (i >= kChunkSize * kMaxChunks) {
+    ++buffer.dropped;
+    return;
+  }
+
+  auto& chunk = buffer.chunks[i / kChunkSize];
+  if (!chunk)
+    chunk.reset(new event[kChunkSize]);
+
+  event& ev = chunk[i % kChunkSize];
+  ev.category = category;
+  ev.name = name;
+  ev.ts = ts;
+  ev.dur = now - ts;
+  buffer.count.store(i + 1, std::memory_order_release);
+}
+
+void trace_write(std::ostream& os)
+{
+  const std::lock_guard lock(g_mutex);
+  const int generation = g_generation;
+  bool first = true;
+
+  auto separator = [&os, &first] {
+    if (first)
+      first = false;
+    else
+      os << ",\n";
+  };
+
+  os << "{\"traceEvents\":[\n";
+  for (const auto& buffer : g_buffers) {
+    if (buffer->generation != generation)
+      continue;
+
+    if (!buffer->thread_name.empty()) {
+      separator();
+      os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+         << ",\"args\":{\"name\":";
+      write_string(os, buffer->thread_name.c_str());
+      os << "}}";
+    }
+
+    const size_t n = buffer->count.load(std::memory_order_acquire);
+    for (size_t i = 0; i < n; ++i) {
+      const event& ev = buffer->chunks[i / kChunkSize][i % kChunkSize];
+      separator();
+      os << "{\"cat\":";
+      write_string(os, ev.category);
+      os << ",\"name\":";
+      write_string(os, ev.name);
+      os << ",\"ph\":\"X\",\"ts\":" << ev.ts << ",\"dur\":" << ev.dur
+         << ",\"pid\":1,\"tid\":" << buffer->tid << "}";
+    }
+  }
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+bool trace_save(const std::string& filename)
+{
+  std::ofstream f(FSTREAM_PATH(filename), std::ios::binary);
+  if (!f)
+    return false;
+  trace_write(f);
+  return f.good();
+}
+
+size_t trace_event_count(size_t* dropped)
+{
+  const std::lock_guard lock(g_mutex);
+  const int generation = g_generation;
+  size_t count = 0;
+  if (dropped)
+    *dropped = 0;
+  for (const auto& buffer : g_buffers) {
+    if (buffer->generation != generation)
+      continue;
+    count += buffer->count.load(std::memory_order_acquire);
+    if (dropped)
+      *dropped += buffer->dropped;
+  }
+  return count;
+}
+
+} // namespace base
@@ -0,0 +1,98 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef BASE_TRACE_H_INCLUDED
+#define BASE_TRACE_H_INCLUDED
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Scoped trace events that can be exported in the Chrome trace event
+// JSON format (to be opened with chrome://tracing or
+// https://ui.perfetto.dev/). E.g.
+//
+//   void Window::onPaint()
+//   {
+//     TRACE_SCOPE("os", "onPaint");
+//     ...
+//   }
+//
+// The category and name must be string literals (only the pointers
+// are stored). When tracing is not started, a TRACE_SCOPE() costs
+// only one relaxed atomic load. Define LAF_DISABLE_TRACE to remove
+// all trace scopes at compile time.
+
+namespace base {
+
+namespace details {
+extern std::atomic<bool> trace_enabled;
+}
+
+// Starts recording events (discarding previous events).
+void trace_start();
+
+// Stops recording events.
+void trace_stop();
+
+inline bool trace_running()
+{
+  return details::trace_enabled.load(std::memory_order_relaxed);
+}
+
+// Microseconds since trace_start().
+int64_t trace_now();
+
+// Adds an event that started at "ts" and ended now (in
+// microseconds from trace_now()).
+void trace_event(const char* category, const char* name, int64_t ts);
+
+// Writes recorded events in JSON format. It should be called after
+// trace_stop() (or when no thread is adding events).
+void trace_write(std::ostream& os);
+bool trace_save(const std::string& filename);
+
+// Number of recorded events (and events that were discarded
+// because a thread buffer was full).
+size_t trace_event_count(size_t* dropped = nullptr);
+
+class trace_scope {
+public:
+  trace_scope(const char* category, const char* name)
+  {
+    if (trace_running()) {
+      m_category = category;
+      m_name = name;
+      m_ts = trace_now();
+    }
+  }
+
+  ~trace_scope()
+  {
+    if (m_name)
+      trace_event(m_category, m_name, m_ts);
+  }
+
+private:
+  const char* m_category = nullptr;
+  const char* m_name = nullptr;
+  int64_t m_ts = 0;
+};
+
+} // namespace base
+
+#ifdef LAF_DISABLE_TRACE
+  #define TRACE_SCOPE(category, name)
+#else
+  #define TRACE_SCOPE_VAR2(line) trace_scope_##line
+  #define TRACE_SCOPE_VAR(line)  TRACE_SCOPE_VAR2(line)
+  #define TRACE_SCOPE(category, name)                                                              \
+    base::trace_scope TRACE_SCOPE_VAR(__LINE__)(category, name)
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+// LAF Base Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#include <gtest/gtest.h>
+
+#include "base/thread_pool.h"
+#include "base/trace.h"
+
+#include <sstream>
+#include <string>
+
+using namespace base;
+
+static void traced_function()
+{
+  TRACE_SCOPE("test", "traced_function");
+}
+
+TEST(Trace, Disabled)
+{
+  trace_stop();
+  traced_function();
+  trace_start();
+  trace_stop();
+  traced_function();
+  EXPECT_EQ(0, trace_event_count());
+}
+
+TEST(Trace, Events)
+{
+  trace_start();
+  {
+    TRACE_SCOPE("test", "outer");
+    traced_function();
+    traced_function();
+  }
+  trace_stop();
+  EXPECT_EQ(3, trace_event_count());
+
+  std::stringstream s;
+  trace_write(s);
+  const std::string json = s.str();
+  EXPECT_EQ(0, json.find("{\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, json.find("\"cat\":\"test\",\"name\":\"outer\",\"ph\":\"X\""));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"traced_function\""));
+
+  // Restarting the trace discards old events
+  trace_start();
+  traced_function();
+  trace_stop();
+  EXPECT_EQ(1, trace_event_count());
+}
+
+TEST(Trace, Threads)
+{
+  thread_pool p(4);
+  trace_start();
+  for (int i = 0; i < 1000; ++i)
+    p.execute([] { traced_function(); });
+  p.wait_all();
+  trace_stop();
+
+  // Each work adds the "thread_pool::work" event too
+  size_t dropped;
+  EXPECT_EQ(2000, trace_event_count(&dropped));
+  EXPECT_EQ(0, dropped);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,16 +1,58 @@
 // LAF Library
-// Copyright (c) 2022-2024  Igara Studio S.A.
+// Copyright (c) 2022-2025  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
 
 #include "base/base64.h"
 #include "base/buffer.h"
+#include "base/chrono.h"
 #include "base/file_content.h"
 #include "os/os.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <cstring>
 
+// Encodes/decodes the input several times and prints the throughput
+// in MB/s. If there is no input file, random data is used.
+static void benchmark(const base::buffer& input)
+{
+  const int kIterations = 20;
+  const double mb = double(input.size()) * kIterations / (1024.0 * 1024.0);
+
+  std::string encoded;
+  base::Chrono chrono;
+  for (int i = 0; i < kIterations; ++i)
+    base::encode_base64(input, encoded);
+  const double encodeSecs = chrono.elapsed();
+
+  base::buffer decoded;
+  chrono.reset();
+  for (int i = 0; i < kIterations; ++i)
+    base::decode_base64(encoded, decoded);
+  const double decodeSecs = chrono.elapsed();
+
+  // Streaming encoder with 64KB chunks
+  const size_t kChunkSize = 64 * 1024;
+  chrono.reset();
+  for (int i = 0; i < kIterations; ++i) {
+    base::base64_encoder encoder;
+    encoded.clear();
+    for (size_t j = 0; j < input.size(); j += kChunkSize)
+      encoder.update((const char*)&input[j], std::min(kChunkSize, input.size() - j), encoded);
+    encoder.finish(encoded);
+  }
+  const double streamSecs = chrono.elapsed();
+
+  std::printf("Input size: %zu bytes\n", input.size());
+  std::printf("encode: %.1f MB/s\n", mb / encodeSecs);
+  std::printf("decode: %.1f MB/s\n", mb / decodeSecs);
+  std::printf("encode (64KB chunks): %.1f MB/s\n", mb / streamSecs);
+  if (decoded != input)
+    std::printf("ERROR: decoded data is different\n");
+}
+
 int app_main(int argc, char* argv[])
 {
   os::SystemRef system = os::System::make();
@@ -18,10 +60,13 @@ int app_main(int argc, char* argv[])
 
   std::string fn;
   bool decode = false;
+  bool bench = false;
 
   for (int i = 1; i < argc; ++i) {
     if (std::strcmp(argv[i], "-d") == 0)
       decode = true;
+    else if (std::strcmp(argv[i], "-b") == 0)
+      bench = true;
     else
       fn = argv[i];
   }
@@ -29,9 +74,22 @@ int app_main(int argc, char* argv[])
   base::buffer input;
   if (!fn.empty())
     input = base::read_file_content(fn);
+  else if (bench) {
+    input.resize(32 * 1024 * 1024);
+    uint32_t seed = 1;
+    for (auto& b : input) {
+      seed = seed * 1103515245 + 12345;
+      b = uint8_t(seed >> 16);
+    }
+  }
   else
     input = base::read_file_content(stdin);
 
+  if (bench) {
+    benchmark(input);
+    return 0;
+  }
+
   base::buffer output;
   if (decode) {
     output = base::decode_base64(input);
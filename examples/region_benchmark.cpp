@@ -0,0 +1,160 @@
+// LAF Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+// Benchmark of the native gfx::BandRegion engine and the gfx::Region
+// implementation of the current configuration. To compare the native
+// engine with each backend, build laf in these configurations:
+//
+// * SkRegion: -DLAF_BACKEND=skia
+// * pixman:   -DLAF_BACKEND=none with pixman installed (or
+//             PIXMAN_LIBRARY/PIXMAN_INCLUDE_DIR pointing to it)
+// * HRGN:     -DLAF_BACKEND=none on Windows without pixman
+//
+// With -DLAF_WITH_NATIVE_REGION=ON (or LAF_BACKEND=none without
+// pixman on Linux/macOS) gfx::Region is gfx::BandRegion itself, so
+// only the native engine is measured.
+
+#include "base/chrono.h"
+#include "gfx/band_region.h"
+#include "os/os.h"
+
+#if LAF_WITH_REGION
+  #include "gfx/region.h"
+#endif
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using namespace gfx;
+
+namespace {
+
+class Random {
+public:
+  explicit Random(uint32_t seed) : m_seed(seed) {}
+  int operator()(int max)
+  {
+    m_seed = m_seed * 1103515245 + 12345;
+    return int((m_seed >> 16) % max);
+  }
+
+private:
+  uint32_t m_seed;
+};
+
+// Runs region operations that are common in UI code (accumulating
+// invalidated rectangles, clipping, excluding opaque windows, and
+// hit-testing), returns a checksum (of bounds and areas, which don't
+// depend on how each implementation splits the rectangles) so the
+// results can be compared between implementations.
+template<typename R>
+int64_t benchmark(const char* name)
+{
+  int64_t checksum = 0;
+  base::Chrono chrono;
+  auto report = [name, &chrono](const char* op) {
+    std::printf("%-8s %-12s %8.2f ms\n", name, op, chrono.elapsed() * 1000.0);
+  };
+
+  std::vector<Rect> rects;
+  Random rand(2);
+  for (int i = 0; i < 2000; ++i)
+    rects.push_back(Rect(rand(1024), rand(768), 4 + rand(60), 4 + rand(60)));
+
+  chrono.reset();
+  R dirty;
+  for (int j = 0; j < 10; ++j) {
+    dirty.clear();
+    for (const Rect& rc : rects)
+      dirty |= R(rc);
+  }
+  checksum += dirty.bounds().w + dirty.bounds().h;
+  report("union");
+
+  chrono.reset();
+  for (int j = 0; j < 100; ++j) {
+    for (int i = 0; i < 100; ++i) {
+      R clip(Rect(i * 8, i * 6, 256, 192));
+      clip &= dirty;
+      checksum += clip.bounds().w;
+    }
+  }
+  report("intersect");
+
+  chrono.reset();
+  for (int j = 0; j < 10; ++j) {
+    R visible(Rect(0, 0, 1024, 768));
+    for (int i = 0; i < 200; ++i)
+      visible -= R(rects[i]);
+    checksum += visible.bounds().h;
+  }
+  report("subtract");
+
+  chrono.reset();
+  for (int i = 0; i < 1000000; ++i)
+    checksum += dirty.contains(Point(i % 1024, (i / 1024) % 768));
+  report("contains");
+
+  // Small regions (the most common case)
+  chrono.reset();
+  for (int i = 0; i < 200000; ++i) {
+    const Rect& rc = rects[i % rects.size()];
+    R small(rc);
+    small |= R(Rect(rc.x + 2, rc.y + 2, rc.w, rc.h));
+    checksum += small.bounds().w;
+  }
+  report("small");
+
+  int64_t area = 0;
+  for (const Rect& rc : dirty)
+    area += rc.w * rc.h;
+
+  // The region is accessed through a volatile pointer, so the
+  // compiler cannot calculate the sum only once for all iterations.
+  const R* volatile region = &dirty;
+  int64_t total = 0;
+  chrono.reset();
+  for (int j = 0; j < 100; ++j) {
+    for (const Rect& rc : *region)
+      total += rc.w * rc.h;
+  }
+  report("iterate");
+  if (total != 100 * area)
+    std::printf("ERROR: invalid area iterating the region\n");
+  checksum += area;
+
+  return checksum;
+}
+
+} // anonymous namespace
+
+// Compares the native engine with the gfx::Region backend (if it's
+// not the native engine itself).
+int app_main(int argc, char* argv[])
+{
+  os::SystemRef system = os::System::make();
+  system->setAppMode(os::AppMode::CLI);
+
+  const int64_t checksum = benchmark<BandRegion>("native");
+
+#if LAF_WITH_REGION && !LAF_NATIVE_REGION
+  #if LAF_SKIA
+  const char* backend = "skia";
+  #elif LAF_PIXMAN
+  const char* backend = "pixman";
+  #else
+  const char* backend = "win";
+  #endif
+  if (checksum != benchmark<Region>(backend))
+    std::printf("ERROR: different results between native and %s\n", backend);
+#else
+  (void)checksum;
+  std::printf("gfx::Region uses the native engine in this configuration, "
+              "there is no other backend to compare\n");
+#endif
+  return 0;
+}
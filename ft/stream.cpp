@@ -7,36 +7,26 @@
 
 #include "ft/stream.h"
 
-#include "base/file_handle.h"
+#include "base/file_view.h"
 #include "base/log.h"
 
 #include <ft2build.h>
 
-#define STREAM_FILE(stream) ((FILE*)(stream)->descriptor.pointer)
+#include <memory>
+
+#define STREAM_VIEW(stream) ((base::file_view*)(stream)->descriptor.pointer)
 
 namespace ft {
 
 static void ft_stream_close(FT_Stream stream)
 {
-  fclose(STREAM_FILE(stream));
+  delete STREAM_VIEW(stream);
   free(stream);
 }
 
-static unsigned long ft_stream_io(FT_Stream stream,
-                                  unsigned long offset,
-                                  unsigned char* buffer,
-                                  unsigned long count)
-{
-  if (!count && offset > stream->size)
-    return 1;
-
-  FILE* file = STREAM_FILE(stream);
-  if (stream->pos != offset)
-    fseek(file, (long)offset, SEEK_SET);
-
-  return (unsigned long)fread(buffer, 1, count, file);
-}
-
+// The whole font file is mapped in memory (or read if it cannot be
+// mapped), so FreeType can access it directly as a memory-based
+// stream (read=nullptr) without copying the data.
 FT_Stream open_stream(const std::string& utf8Filename)
 {
   FT_Stream stream = nullptr;
@@ -47,28 +37,19 @@ FT_Stream open_stream(const std::string& utf8Filename)
 
   LOG(VERBOSE, "FT: Loading font '%s'...", utf8Filename.c_str());
 
-  FILE* file = base::open_file_raw(utf8Filename, "rb");
-  if (!file) {
-    free(stream);
-    LOG(VERBOSE, "FAIL\n");
-    return nullptr;
-  }
-
-  fseek(file, 0, SEEK_END);
-  stream->size = (unsigned long)ftell(file);
-  if (!stream->size) {
-    fclose(file);
+  auto view = std::make_unique<base::file_view>(utf8Filename);
+  if (!view->is_open() || view->empty()) {
     free(stream);
     LOG(VERBOSE, "FAIL\n");
     return nullptr;
   }
-  fseek(file, 0, SEEK_SET);
 
-  stream->descriptor.pointer = file;
-  stream->base = nullptr;
+  stream->size = (unsigned long)view->size();
+  stream->base = (unsigned char*)view->data();
   stream->pos = 0;
-  stream->read = ft_stream_io;
+  stream->read = nullptr;
   stream->close = ft_stream_close;
+  stream->descriptor.pointer = view.release();
 
   LOG(VERBOSE, "OK\n");
   return stream;
@@ -0,0 +1,164 @@
+// LAF Gfx Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "gfx/atlas_allocator.h"
+
+#include <algorithm>
+
+namespace gfx {
+
+// The padding is added to the right/bottom of each rectangle and to
+// the bin, so rectangles touching the atlas right/bottom edges don't
+// need it (the same as PackingRects shape padding).
+
+AtlasAllocator::AtlasAllocator(const Size& size,
+                               const int padding,
+                               const PackingRects::Heuristic heuristic)
+  : m_size(size)
+  , m_padding(padding)
+  , m_heuristic(heuristic)
+  , m_packer(size.w + padding, size.h + padding, heuristic)
+{
+  updateRebuildThreshold();
+}
+
+Rect AtlasAllocator::allocate(const Size& size)
+{
+  if (size.w <= 0 || size.h <= 0)
+    return Rect();
+
+  Point pos;
+  if (!m_packer.insert(size.w + m_padding, size.h + m_padding, pos))
+    return Rect();
+
+  const Rect rc(pos, size);
+  m_used[key(rc)] = rc;
+  m_usedArea += int64_t(rc.w) * rc.h;
+  return rc;
+}
+
+bool AtlasAllocator::free(const Rect& rc)
+{
+  auto it = m_used.find(key(rc));
+  if (it == m_used.end() || it->second != rc)
+    return false;
+
+  m_used.erase(it);
+  m_usedArea -= int64_t(rc.w) * rc.h;
+  if (m_used.empty())
+    m_packer.reset(m_size.w + m_padding, m_size.h + m_padding);
+  else {
+    m_packer.release(Rect(rc.x, rc.y, rc.w + m_padding, rc.h + m_padding));
+
+    // The free rectangles are not maximal after release(), the free
+    // space gets fragmented in more (and smaller) rectangles with
+    // each free() and allocate() gets slower. So from time to time
+    // we create them again from the allocated rectangles.
+    if (++m_freesSinceRebuild > m_rebuildThreshold)
+      rebuild();
+  }
+  return true;
+}
+
+void AtlasAllocator::clear()
+{
+  m_used.clear();
+  m_usedArea = 0;
+  m_packer.reset(m_size.w + m_padding, m_size.h + m_padding);
+}
+
+void AtlasAllocator::grow(const Size& size)
+{
+  const Size newSize = m_size.createUnion(size);
+  if (newSize == m_size)
+    return;
+
+  m_size = newSize;
+  rebuild();
+}
+
+AtlasAllocator::Moves AtlasAllocator::defragment()
+{
+  // Pack from the biggest rectangle to the smallest one (sorted by
+  // position too, so the result is deterministic).
+  std::vector<Rect> rects;
+  rects.reserve(m_used.size());
+  for (const auto& it : m_used)
+    rects.push_back(it.second);
+  std::sort(rects.begin(), rects.end(), [](const Rect& a, const Rect& b) {
+    const int64_t areaA = int64_t(a.w) * a.h;
+    const int64_t areaB = int64_t(b.w) * b.h;
+    if (areaA != areaB)
+      return areaA > areaB;
+    return (a.y < b.y || (a.y == b.y && a.x < b.x));
+  });
+
+  MaxRectsPacker packer(m_size.w + m_padding, m_size.h + m_padding, m_heuristic);
+  Moves moves;
+  std::unordered_map<uint64_t, Rect> used;
+  for (const Rect& rc : rects) {
+    Point pos;
+    if (!packer.insert(rc.w + m_padding, rc.h + m_padding, pos)) {
+      rebuild();
+      return Moves();
+    }
+    const Rect newRc(pos, rc.size());
+    if (newRc != rc)
+      moves.push_back(Move{ rc, newRc });
+    used[key(newRc)] = newRc;
+  }
+
+  m_packer = std::move(packer);
+  m_used = std::move(used);
+  updateRebuildThreshold();
+  return moves;
+}
+
+AtlasAllocator::Stats AtlasAllocator::stats() const
+{
+  Stats stats;
+  stats.allocations = int(m_used.size());
+  stats.usedArea = m_usedArea;
+  stats.totalArea = int64_t(m_size.w) * m_size.h;
+  stats.freeRects = int(m_packer.freeRects().size());
+  for (const Rect& fr : m_packer.freeRects()) {
+    const Rect rc = fr.createIntersection(Rect(m_size));
+    stats.largestFree = std::max(stats.largestFree, int64_t(rc.w) * rc.h);
+  }
+  return stats;
+}
+
+// Creates the list of maximal free rectangles from the allocated
+// rectangles.
+void AtlasAllocator::rebuild()
+{
+  std::vector<Rect> rects;
+  rects.reserve(m_used.size());
+  for (const auto& it : m_used) {
+    const Rect& rc = it.second;
+    rects.push_back(Rect(rc.x, rc.y, rc.w + m_padding, rc.h + m_padding));
+  }
+  std::sort(rects.begin(), rects.end(), [](const Rect& a, const Rect& b) {
+    return (a.y < b.y || (a.y == b.y && a.x < b.x));
+  });
+  m_packer.reset(m_size.w + m_padding, m_size.h + m_padding, rects);
+  updateRebuildThreshold();
+}
+
+// Rebuilding the free rectangles costs about the same as placing each
+// allocated rectangle, so we wait a number of free() calls similar to
+// the number of free rectangles to amortize the cost.
+void AtlasAllocator::updateRebuildThreshold()
+{
+  m_rebuildThreshold = std::max<size_t>(64, m_packer.freeRects().size());
+  m_freesSinceRebuild = 0;
+}
+
+} // namespace gfx
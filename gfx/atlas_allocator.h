@@ -0,0 +1,105 @@
+// LAF Gfx Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef GFX_ATLAS_ALLOCATOR_H_INCLUDED
+#define GFX_ATLAS_ALLOCATOR_H_INCLUDED
+#pragma once
+
+#include "gfx/max_rects_packer.h"
+#include "gfx/rect.h"
+#include "gfx/size.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace gfx {
+
+// Allocates rectangles in a texture atlas one by one (e.g. glyphs or
+// icons as they are needed), instead of packing all rectangles at
+// once like PackingRects. Allocated rectangles can be freed, and the
+// atlas can grow when it's full.
+//
+//   gfx::AtlasAllocator atlas(gfx::Size(512, 512), 1);
+//   gfx::Rect rc = atlas.allocate(glyphSize);
+//   if (rc.isEmpty()) {
+//     atlas.grow(gfx::Size(1024, 1024));
+//     rc = atlas.allocate(glyphSize);
+//   }
+//
+class AtlasAllocator {
+public:
+  struct Stats {
+    int allocations = 0;     // Number of allocated rectangles
+    int64_t usedArea = 0;    // Area of allocated rectangles (without padding)
+    int64_t totalArea = 0;   // Area of the atlas
+    int64_t largestFree = 0; // Area of the biggest free rectangle
+    int freeRects = 0;       // Number of free rectangles tracked
+
+    double occupancy() const { return totalArea > 0 ? double(usedArea) / totalArea : 0.0; }
+  };
+
+  // A rectangle moved by defragment().
+  struct Move {
+    Rect from;
+    Rect to;
+  };
+  using Moves = std::vector<Move>;
+
+  // "padding" is the space kept between allocated rectangles (but
+  // not between rectangles and the atlas edges).
+  AtlasAllocator(const Size& size,
+                 int padding = 0,
+                 PackingRects::Heuristic heuristic = PackingRects::Heuristic::BestShortSideFit);
+
+  const Size& size() const { return m_size; }
+  int padding() const { return m_padding; }
+  bool empty() const { return m_used.empty(); }
+
+  // Returns the allocated rectangle, or an empty rectangle if there
+  // is no space for the given size.
+  Rect allocate(const Size& size);
+
+  // Frees a rectangle returned by allocate(). Returns false if it
+  // wasn't allocated.
+  bool free(const Rect& rc);
+
+  // Frees all rectangles.
+  void clear();
+
+  // Makes the atlas bigger (it cannot shrink), the allocated
+  // rectangles keep their position.
+  void grow(const Size& size);
+
+  // Packs all allocated rectangles again to join the free space
+  // fragmented by free() calls. Returns the rectangles that were
+  // moved, the caller must copy their content from the previous
+  // atlas (moves can overlap, so the content must be copied to a new
+  // texture or from a copy of the old one). If all rectangles cannot
+  // be packed again, nothing is moved and the free space is only
+  // rebuilt.
+  Moves defragment();
+
+  Stats stats() const;
+
+private:
+  static uint64_t key(const Rect& rc) { return (uint64_t(uint32_t(rc.x)) << 32) | uint32_t(rc.y); }
+  void rebuild();
+  void updateRebuildThreshold();
+
+  Size m_size;
+  int m_padding;
+  PackingRects::Heuristic m_heuristic;
+  MaxRectsPacker m_packer;
+  std::unordered_map<uint64_t, Rect> m_used; // Allocated rectangles by position
+  int64_t m_usedArea = 0;
+  size_t m_rebuildThreshold = 0; // Number of free() calls to rebuild the free rectangles
+  size_t m_freesSinceRebuild = 0;
+};
+
+} // namespace gfx
+
+#endif
@@ -0,0 +1,188 @@
+// LAF Gfx Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "gfx/atlas_allocator.h"
+#include "gfx/rect_io.h"
+
+#include <algorithm>
+
+using namespace gfx;
+
+// Checks that rectangles are inside the atlas and don't overlap
+// (including the padding).
+static void expect_valid(const AtlasAllocator& atlas, const std::vector<Rect>& rects)
+{
+  const int pad = atlas.padding();
+  for (size_t i = 0; i < rects.size(); ++i) {
+    const Rect& a = rects[i];
+    EXPECT_TRUE(Rect(atlas.size()).contains(a)) << a;
+    for (size_t j = i + 1; j < rects.size(); ++j) {
+      const Rect& b = rects[j];
+      EXPECT_FALSE(Rect(a.x, a.y, a.w + pad, a.h + pad).intersects(b) ||
+                   Rect(b.x, b.y, b.w + pad, b.h + pad).intersects(a))
+        << a << " and " << b << " overlap";
+    }
+  }
+}
+
+TEST(AtlasAllocator, AllocateAndFree)
+{
+  AtlasAllocator atlas(Size(64, 64));
+  EXPECT_TRUE(atlas.empty());
+  EXPECT_EQ(Rect(0, 0, 64, 32), atlas.allocate(Size(64, 32)));
+  const Rect a = atlas.allocate(Size(32, 32));
+  const Rect b = atlas.allocate(Size(32, 32));
+  EXPECT_EQ(32, a.y);
+  EXPECT_EQ(32, b.y);
+  EXPECT_TRUE(atlas.allocate(Size(1, 1)).isEmpty()); // Full
+  EXPECT_TRUE(atlas.allocate(Size(0, 0)).isEmpty());
+
+  AtlasAllocator::Stats stats = atlas.stats();
+  EXPECT_EQ(3, stats.allocations);
+  EXPECT_EQ(64 * 64, stats.usedArea);
+  EXPECT_EQ(1.0, stats.occupancy());
+
+  EXPECT_TRUE(atlas.free(a));
+  EXPECT_FALSE(atlas.free(a));
+  EXPECT_FALSE(atlas.free(Rect(b.x, b.y, 1, 1)));
+  EXPECT_EQ(a, atlas.allocate(Size(32, 32)));
+
+  // Freed neighbors are merged
+  EXPECT_TRUE(atlas.free(a));
+  EXPECT_TRUE(atlas.free(b));
+  EXPECT_EQ(Rect(0, 32, 64, 32), atlas.allocate(Size(64, 32)));
+
+  atlas.clear();
+  EXPECT_TRUE(atlas.empty());
+  EXPECT_EQ(Rect(0, 0, 64, 64), atlas.allocate(Size(64, 64)));
+}
+
+TEST(AtlasAllocator, Padding)
+{
+  AtlasAllocator atlas(Size(63, 31), 1);
+  std::vector<Rect> rects;
+  for (int i = 0; i < 8; ++i) {
+    rects.push_back(atlas.allocate(Size(15, 15)));
+    EXPECT_FALSE(rects.back().isEmpty());
+  }
+  EXPECT_TRUE(atlas.allocate(Size(1, 1)).isEmpty());
+  expect_valid(atlas, rects);
+}
+
+TEST(AtlasAllocator, Grow)
+{
+  AtlasAllocator atlas(Size(34, 34), 2);
+  std::vector<Rect> rects;
+  for (Rect rc; !(rc = atlas.allocate(Size(10, 10))).isEmpty();)
+    rects.push_back(rc);
+  EXPECT_EQ(9, rects.size());
+
+  atlas.grow(Size(70, 70));
+  EXPECT_EQ(Size(70, 70), atlas.size());
+  for (Rect rc; !(rc = atlas.allocate(Size(10, 10))).isEmpty();)
+    rects.push_back(rc);
+  EXPECT_EQ(36, rects.size());
+  expect_valid(atlas, rects);
+}
+
+TEST(AtlasAllocator, Defragment)
+{
+  AtlasAllocator atlas(Size(256, 256), 1);
+  std::vector<Rect> rects;
+  uint32_t seed = 1;
+  auto rand = [&seed](int max) {
+    seed = seed * 1103515245 + 12345;
+    return int((seed >> 16) % max);
+  };
+
+  // Allocate random glyphs until the atlas is full, then free half
+  // of them (fragmenting the free space)
+  for (Rect rc; !(rc = atlas.allocate(Size(4 + rand(12), 8 + rand(8)))).isEmpty();)
+    rects.push_back(rc);
+  EXPECT_GT(atlas.stats().occupancy(), 0.7);
+  std::vector<Rect> kept;
+  for (size_t i = 0; i < rects.size(); ++i) {
+    if (i & 1) {
+      EXPECT_TRUE(atlas.free(rects[i]));
+    }
+    else
+      kept.push_back(rects[i]);
+  }
+  rects = kept;
+  expect_valid(atlas, rects);
+
+  const AtlasAllocator::Stats before = atlas.stats();
+  EXPECT_TRUE(atlas.allocate(Size(64, 64)).isEmpty());
+
+  const AtlasAllocator::Moves moves = atlas.defragment();
+  EXPECT_FALSE(moves.empty());
+  for (const auto& move : moves) {
+    auto it = std::find(rects.begin(), rects.end(), move.from);
+    ASSERT_TRUE(it != rects.end());
+    EXPECT_EQ(move.from.size(), move.to.size());
+    *it = move.to;
+  }
+  expect_valid(atlas, rects);
+
+  const AtlasAllocator::Stats after = atlas.stats();
+  EXPECT_EQ(before.allocations, after.allocations);
+  EXPECT_EQ(before.usedArea, after.usedArea);
+  EXPECT_GT(after.largestFree, before.largestFree);
+  rects.push_back(atlas.allocate(Size(64, 64)));
+  EXPECT_FALSE(rects.back().isEmpty());
+  expect_valid(atlas, rects);
+
+  for (const Rect& rc : rects)
+    EXPECT_TRUE(atlas.free(rc));
+  EXPECT_TRUE(atlas.empty());
+}
+
+// Allocating and freeing rectangles for a long time must not
+// fragment the free space in more and more free rectangles (each
+// allocation checks all of them).
+TEST(AtlasAllocator, Churn)
+{
+  AtlasAllocator atlas(Size(512, 512), 1);
+  std::vector<Rect> rects;
+  uint32_t seed = 1;
+  auto rand = [&seed](int max) {
+    seed = seed * 1103515245 + 12345;
+    return int((seed >> 16) % max);
+  };
+
+  for (int i = 0; i < 20000; ++i) {
+    if (rects.size() < 400 && rand(3) > 0) {
+      const Rect rc = atlas.allocate(Size(4 + rand(12), 8 + rand(8)));
+      if (!rc.isEmpty())
+        rects.push_back(rc);
+    }
+    else if (!rects.empty()) {
+      const size_t j = rand(int(rects.size()));
+      EXPECT_TRUE(atlas.free(rects[j]));
+      rects[j] = rects.back();
+      rects.pop_back();
+    }
+  }
+  expect_valid(atlas, rects);
+
+  const AtlasAllocator::Stats stats = atlas.stats();
+  EXPECT_EQ(rects.size(), stats.allocations);
+  // Without rebuilding the free rectangles there are about 2 free
+  // rectangles for each allocation at this point (and growing).
+  EXPECT_LT(double(stats.freeRects) / stats.allocations, 1.75);
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
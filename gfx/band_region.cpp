@@ -0,0 +1,410 @@
+// LAF Gfx Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "gfx/band_region.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace gfx {
+
+BandRegion& BandRegion::operator=(const Rect& rect)
+{
+  clear();
+  if (!rect.isEmpty()) {
+    m_y1.push_back(rect.y);
+    m_y2.push_back(rect.y2());
+    m_spanEnd.push_back(1);
+    m_x1.push_back(rect.x);
+    m_x2.push_back(rect.x2());
+    m_bounds = rect;
+  }
+  return *this;
+}
+
+void BandRegion::clear()
+{
+  m_y1.clear();
+  m_y2.clear();
+  m_spanEnd.clear();
+  m_x1.clear();
+  m_x2.clear();
+  m_bounds = Rect();
+}
+
+void BandRegion::offset(int dx, int dy)
+{
+  if (dy != 0) {
+    for (int i = 0, n = m_y1.size(); i < n; ++i) {
+      m_y1[i] += dy;
+      m_y2[i] += dy;
+    }
+  }
+  if (dx != 0) {
+    for (int i = 0, n = m_x1.size(); i < n; ++i) {
+      m_x1[i] += dx;
+      m_x2[i] += dx;
+    }
+  }
+  if (!isEmpty())
+    m_bounds.offset(dx, dy);
+}
+
+BandRegion& BandRegion::createIntersection(const BandRegion& a, const BandRegion& b)
+{
+  if (a.isEmpty() || b.isEmpty() || !a.m_bounds.intersects(b.m_bounds))
+    clear();
+  else if (a.isRect() && b.isRect())
+    *this = a.m_bounds.createIntersection(b.m_bounds);
+  else if (a.isRect() && a.m_bounds.contains(b.m_bounds))
+    *this = b;
+  else if (b.isRect() && b.m_bounds.contains(a.m_bounds))
+    *this = a;
+  else
+    combine(Op::Intersection, a, b);
+  return *this;
+}
+
+BandRegion& BandRegion::createUnion(const BandRegion& a, const BandRegion& b)
+{
+  if (b.isEmpty() || (a.isRect() && a.m_bounds.contains(b.m_bounds)))
+    *this = a;
+  else if (a.isEmpty() || (b.isRect() && b.m_bounds.contains(a.m_bounds)))
+    *this = b;
+  else
+    combine(Op::Union, a, b);
+  return *this;
+}
+
+BandRegion& BandRegion::createSubtraction(const BandRegion& a, const BandRegion& b)
+{
+  if (a.isEmpty() || b.isEmpty() || !a.m_bounds.intersects(b.m_bounds))
+    *this = a;
+  else if (b.isRect() && b.m_bounds.contains(a.m_bounds))
+    clear();
+  else
+    combine(Op::Subtraction, a, b);
+  return *this;
+}
+
+bool BandRegion::contains(const PointT<int>& pt) const
+{
+  if (!m_bounds.contains(pt))
+    return false;
+
+  const int band = findBand(pt.y);
+  if (band == bands() || m_y1[band] > pt.y)
+    return false;
+
+  const int end = m_spanEnd[band];
+  const int span = findSpan(pt.x, bandBegin(band), end);
+  return (span < end && m_x1[span] <= pt.x);
+}
+
+BandRegion::Overlap BandRegion::contains(const Rect& rect) const
+{
+  if (!m_bounds.intersects(rect))
+    return Out;
+
+  const int rx2 = rect.x2();
+  const int ry2 = rect.y2();
+  bool partIn = false;
+  bool partOut = false;
+  int y = rect.y;
+
+  for (int band = findBand(rect.y), n = bands(); band < n && m_y1[band] < ry2; ++band) {
+    // Rows between bands are outside
+    if (m_y1[band] > y)
+      partOut = true;
+
+    int x = rect.x;
+    const int end = m_spanEnd[band];
+    for (int span = findSpan(rect.x, bandBegin(band), end); span < end && m_x1[span] < rx2;
+         ++span) {
+      if (m_x1[span] > x)
+        partOut = true;
+      partIn = true;
+      x = m_x2[span];
+      if (x >= rx2)
+        break;
+    }
+    if (x < rx2)
+      partOut = true;
+
+    if (partIn && partOut)
+      return Part;
+    y = m_y2[band];
+  }
+  if (y < ry2)
+    partOut = true;
+
+  return (partIn ? (partOut ? Part : In) : Out);
+}
+
+bool BandRegion::operator==(const BandRegion& b) const
+{
+  const int nb = bands();
+  const int ns = int(size());
+  return (nb == b.bands() && ns == int(b.size()) &&
+          std::equal(m_y1.data(), m_y1.data() + nb, b.m_y1.data()) &&
+          std::equal(m_y2.data(), m_y2.data() + nb, b.m_y2.data()) &&
+          std::equal(m_spanEnd.data(), m_spanEnd.data() + nb, b.m_spanEnd.data()) &&
+          std::equal(m_x1.data(), m_x1.data() + ns, b.m_x1.data()) &&
+          std::equal(m_x2.data(), m_x2.data() + ns, b.m_x2.data()));
+}
+
+// Returns the first band that ends after "y".
+int BandRegion::findBand(int y) const
+{
+  const int* y2 = m_y2.data();
+  return int(std::upper_bound(y2, y2 + bands(), y) - y2);
+}
+
+// Returns the first span in [begin, end) that ends after "x".
+int BandRegion::findSpan(int x, int begin, int end) const
+{
+  const int* x2 = m_x2.data();
+  return int(std::upper_bound(x2 + begin, x2 + end, x) - x2);
+}
+
+BandRegion& BandRegion::combine(const Op op, const BandRegion& a, const BandRegion& b)
+{
+  // The result is created in a temporary region if "this" is one of
+  // the operands, in other case we can reuse our own arrays.
+  if (this == &a || this == &b) {
+    BandRegion result;
+    result.sweep(op, a, b);
+    *this = std::move(result);
+  }
+  else {
+    clear();
+    sweep(op, a, b);
+  }
+  return *this;
+}
+
+// Walks the bands of both regions from top to bottom splitting them
+// in horizontal strips where the bands of each region don't change,
+// and combines the spans of both regions in each strip.
+void BandRegion::sweep(const Op op, const BandRegion& a, const BandRegion& b)
+{
+  const bool keepA = (op != Op::Intersection);
+  const bool keepB = (op == Op::Union);
+  const int na = a.bands();
+  const int nb = b.bands();
+  int ybot = INT_MIN;
+
+  // Bands that are above the other region are copied directly (or
+  // skipped), only one of the regions can have these bands.
+  int ia = a.findBand(b.m_bounds.y);
+  int ib = b.findBand(a.m_bounds.y);
+  if (keepA)
+    addBands(a, 0, ia);
+  if (keepB)
+    addBands(b, 0, ib);
+
+  while (ia < na && ib < nb) {
+    const int aTop = std::max(a.m_y1[ia], ybot);
+    const int bTop = std::max(b.m_y1[ib], ybot);
+
+    // Strip with only the "a" band
+    if (aTop < bTop) {
+      ybot = std::min(a.m_y2[ia], bTop);
+      if (keepA)
+        addBand(aTop, ybot, a, ia);
+    }
+    // Strip with only the "b" band
+    else if (bTop < aTop) {
+      ybot = std::min(b.m_y2[ib], aTop);
+      if (keepB)
+        addBand(bTop, ybot, b, ib);
+    }
+    // Strip with both bands
+    else {
+      ybot = std::min(a.m_y2[ia], b.m_y2[ib]);
+
+      const int* ax1 = a.m_x1.data();
+      const int* ax2 = a.m_x2.data();
+      const int* bx1 = b.m_x1.data();
+      const int* bx2 = b.m_x2.data();
+      const int aEnd = a.m_spanEnd[ia];
+      const int bEnd = b.m_spanEnd[ib];
+      int i = a.bandBegin(ia);
+      int j = b.bandBegin(ib);
+      const int first = int(size());
+
+      switch (op) {
+        case Op::Union: {
+          int x1 = 0, x2 = 0;
+          bool open = false;
+          while (i < aEnd || j < bEnd) {
+            int u1, u2;
+            if (j == bEnd || (i < aEnd && ax1[i] < bx1[j])) {
+              u1 = ax1[i];
+              u2 = ax2[i++];
+            }
+            else {
+              u1 = bx1[j];
+              u2 = bx2[j++];
+            }
+            if (open && u1 <= x2) {
+              x2 = std::max(x2, u2);
+            }
+            else {
+              if (open)
+                addSpan(x1, x2);
+              x1 = u1;
+              x2 = u2;
+              open = true;
+            }
+          }
+          if (open)
+            addSpan(x1, x2);
+          break;
+        }
+
+        case Op::Intersection:
+          while (i < aEnd && j < bEnd) {
+            const int x1 = std::max(ax1[i], bx1[j]);
+            const int x2 = std::min(ax2[i], bx2[j]);
+            if (x1 < x2)
+              addSpan(x1, x2);
+            if (ax2[i] < bx2[j])
+              ++i;
+            else
+              ++j;
+          }
+          break;
+
+        case Op::Subtraction:
+          for (; i < aEnd; ++i) {
+            int x1 = ax1[i];
+            const int x2 = ax2[i];
+            while (j < bEnd && bx2[j] <= x1)
+              ++j;
+            for (int k = j; k < bEnd && bx1[k] < x2 && x1 < x2; ++k) {
+              if (bx1[k] > x1)
+                addSpan(x1, bx1[k]);
+              x1 = bx2[k];
+            }
+            if (x1 < x2)
+              addSpan(x1, x2);
+          }
+          break;
+      }
+      closeBand(aTop, ybot, first);
+    }
+
+    if (a.m_y2[ia] <= ybot)
+      ++ia;
+    if (b.m_y2[ib] <= ybot)
+      ++ib;
+  }
+
+  // Remaining bands of one region, the first one can be coalesced
+  // with the last added band, and the rest are copied directly.
+  if (keepA && ia < na) {
+    addBand(std::max(a.m_y1[ia], ybot), a.m_y2[ia], a, ia);
+    addBands(a, ia + 1, na);
+  }
+  if (keepB && ib < nb) {
+    addBand(std::max(b.m_y1[ib], ybot), b.m_y2[ib], b, ib);
+    addBands(b, ib + 1, nb);
+  }
+
+  updateBounds();
+}
+
+// Adds a band with the spans of the given "band" of "src".
+void BandRegion::addBand(int y1, int y2, const BandRegion& src, int band)
+{
+  const int begin = src.bandBegin(band);
+  const int n = src.m_spanEnd[band] - begin;
+  const int first = int(size());
+  m_x1.resize(first + n);
+  m_x2.resize(first + n);
+  std::copy(src.m_x1.data() + begin, src.m_x1.data() + begin + n, m_x1.data() + first);
+  std::copy(src.m_x2.data() + begin, src.m_x2.data() + begin + n, m_x2.data() + first);
+  closeBand(y1, y2, first);
+}
+
+// Copies the bands [begin, end) of "src" (they cannot be coalesced
+// with the last band of this region).
+void BandRegion::addBands(const BandRegion& src, int begin, int end)
+{
+  if (begin >= end)
+    return;
+
+  const int nb = bands();
+  const int n = end - begin;
+  m_y1.resize(nb + n);
+  m_y2.resize(nb + n);
+  m_spanEnd.resize(nb + n);
+  std::copy(src.m_y1.data() + begin, src.m_y1.data() + end, m_y1.data() + nb);
+  std::copy(src.m_y2.data() + begin, src.m_y2.data() + end, m_y2.data() + nb);
+
+  const int spanBegin = src.bandBegin(begin);
+  const int spanEnd = src.m_spanEnd[end - 1];
+  const int first = int(size());
+  for (int i = 0; i < n; ++i)
+    m_spanEnd[nb + i] = src.m_spanEnd[begin + i] - spanBegin + first;
+
+  m_x1.resize(first + spanEnd - spanBegin);
+  m_x2.resize(first + spanEnd - spanBegin);
+  std::copy(src.m_x1.data() + spanBegin, src.m_x1.data() + spanEnd, m_x1.data() + first);
+  std::copy(src.m_x2.data() + spanBegin, src.m_x2.data() + spanEnd, m_x2.data() + first);
+}
+
+// Creates a band [y1, y2) with the spans added from "firstSpan", or
+// extends the previous band if it has the same spans (so the region
+// keeps its canonical form).
+void BandRegion::closeBand(int y1, int y2, int firstSpan)
+{
+  const int end = int(size());
+  if (firstSpan == end)
+    return;
+
+  const int nb = bands();
+  if (nb > 0 && m_y2[nb - 1] == y1) {
+    const int prevBegin = bandBegin(nb - 1);
+    const int n = end - firstSpan;
+    if (firstSpan - prevBegin == n &&
+        std::equal(m_x1.data() + prevBegin, m_x1.data() + firstSpan, m_x1.data() + firstSpan) &&
+        std::equal(m_x2.data() + prevBegin, m_x2.data() + firstSpan, m_x2.data() + firstSpan)) {
+      m_y2[nb - 1] = y2;
+      m_x1.resize(firstSpan);
+      m_x2.resize(firstSpan);
+      return;
+    }
+  }
+
+  m_y1.push_back(y1);
+  m_y2.push_back(y2);
+  m_spanEnd.push_back(end);
+}
+
+void BandRegion::updateBounds()
+{
+  const int nb = bands();
+  if (nb == 0) {
+    m_bounds = Rect();
+    return;
+  }
+
+  int x1 = INT_MAX;
+  int x2 = INT_MIN;
+  for (int band = 0; band < nb; ++band) {
+    x1 = std::min(x1, m_x1[bandBegin(band)]);
+    x2 = std::max(x2, m_x2[m_spanEnd[band] - 1]);
+  }
+  m_bounds = Rect(x1, m_y1[0], x2 - x1, m_y2[nb - 1] - m_y1[0]);
+}
+
+} // namespace gfx
@@ -0,0 +1,276 @@
+// LAF Gfx Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef GFX_BAND_REGION_H_INCLUDED
+#define GFX_BAND_REGION_H_INCLUDED
+#pragma once
+
+#include "gfx/point.h"
+#include "gfx/rect.h"
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+
+namespace gfx {
+
+namespace details {
+
+// Vector of trivially copyable items that stores the first N items
+// inside the object, so small vectors don't allocate memory.
+template<typename T, int N>
+class InlineVector {
+public:
+  InlineVector() {}
+  InlineVector(const InlineVector& o) { assign(o); }
+  InlineVector(InlineVector&& o) noexcept { steal(o); }
+  ~InlineVector()
+  {
+    if (m_data != m_inline)
+      delete[] m_data;
+  }
+
+  InlineVector& operator=(const InlineVector& o)
+  {
+    if (this != &o) {
+      m_size = 0;
+      assign(o);
+    }
+    return *this;
+  }
+
+  InlineVector& operator=(InlineVector&& o) noexcept
+  {
+    if (this != &o) {
+      if (m_data != m_inline)
+        delete[] m_data;
+      steal(o);
+    }
+    return *this;
+  }
+
+  T* data() { return m_data; }
+  const T* data() const { return m_data; }
+  int size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  bool isInline() const { return m_data == m_inline; }
+
+  T& operator[](int i) { return m_data[i]; }
+  const T& operator[](int i) const { return m_data[i]; }
+  T& back() { return m_data[m_size - 1]; }
+  const T& back() const { return m_data[m_size - 1]; }
+
+  void clear() { m_size = 0; }
+
+  void resize(int n)
+  {
+    reserve(n);
+    m_size = n;
+  }
+
+  void reserve(int n)
+  {
+    if (n > m_capacity)
+      grow(n);
+  }
+
+  void push_back(const T& value)
+  {
+    if (m_size == m_capacity)
+      grow(m_size + 1);
+    m_data[m_size++] = value;
+  }
+
+private:
+  void assign(const InlineVector& o)
+  {
+    reserve(o.m_size);
+    std::memcpy(m_data, o.m_data, sizeof(T) * o.m_size);
+    m_size = o.m_size;
+  }
+
+  void steal(InlineVector& o)
+  {
+    if (o.m_data == o.m_inline) {
+      m_data = m_inline;
+      m_capacity = N;
+      std::memcpy(m_inline, o.m_inline, sizeof(T) * o.m_size);
+    }
+    else {
+      m_data = o.m_data;
+      m_capacity = o.m_capacity;
+      o.m_data = o.m_inline;
+      o.m_capacity = N;
+    }
+    m_size = o.m_size;
+    o.m_size = 0;
+  }
+
+  void grow(int n)
+  {
+    const int capacity = (n > 2 * m_capacity ? n : 2 * m_capacity);
+    T* data = new T[capacity];
+    std::memcpy(data, m_data, sizeof(T) * m_size);
+    if (m_data != m_inline)
+      delete[] m_data;
+    m_data = data;
+    m_capacity = capacity;
+  }
+
+  T* m_data = m_inline;
+  int m_size = 0;
+  int m_capacity = N;
+  T m_inline[N];
+};
+
+} // namespace details
+
+// Native region engine (used by gfx::Region when there is no other
+// backend, see region_laf.h). The region is stored as a list of
+// y-bands from top to bottom, where each band contains a list of
+// x-spans from left to right (the same canonical form used by
+// pixman/X11 regions: spans don't overlap or touch each other, and
+// vertically adjacent bands with the same spans are coalesced).
+//
+// Bands and spans are kept in flat arrays (y1/y2/spanEnd for bands,
+// x1/x2 for spans), and regions of up to kInlineRects rectangles
+// don't allocate memory.
+class BandRegion {
+public:
+  enum Overlap { Out, In, Part };
+
+  static constexpr int kInlineRects = 4;
+
+  // Iterates the region rectangles (one for each span of each band),
+  // rectangles are returned by value.
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Rect;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Rect*;
+    using reference = Rect;
+
+    const_iterator() {}
+
+    Rect operator*() const
+    {
+      const int x1 = m_rgn->m_x1[m_span];
+      const int y1 = m_rgn->m_y1[m_band];
+      return Rect(x1, y1, m_rgn->m_x2[m_span] - x1, m_rgn->m_y2[m_band] - y1);
+    }
+
+    const_iterator& operator++()
+    {
+      if (++m_span == m_rgn->m_spanEnd[m_band])
+        ++m_band;
+      return *this;
+    }
+
+    const_iterator operator++(int)
+    {
+      const_iterator o(*this);
+      ++(*this);
+      return o;
+    }
+
+    bool operator==(const const_iterator& o) const { return m_span == o.m_span; }
+    bool operator!=(const const_iterator& o) const { return m_span != o.m_span; }
+
+  private:
+    const_iterator(const BandRegion* rgn, int band, int span)
+      : m_rgn(rgn)
+      , m_band(band)
+      , m_span(span)
+    {
+    }
+
+    const BandRegion* m_rgn = nullptr;
+    int m_band = 0;
+    int m_span = 0;
+    friend class BandRegion;
+  };
+
+  using iterator = const_iterator;
+
+  BandRegion() {}
+  explicit BandRegion(const Rect& rect) { *this = rect; }
+  BandRegion& operator=(const Rect& rect);
+
+  const_iterator begin() const { return const_iterator(this, 0, 0); }
+  const_iterator end() const { return const_iterator(this, bands(), int(size())); }
+
+  bool isEmpty() const { return m_x1.empty(); }
+  bool isRect() const { return m_x1.size() == 1; }
+  bool isComplex() const { return m_x1.size() > 1; }
+
+  // Number of rectangles (spans) and number of bands.
+  std::size_t size() const { return m_x1.size(); }
+  int bands() const { return m_y1.size(); }
+
+  // True if the region doesn't use heap memory.
+  bool isInline() const
+  {
+    return m_y1.isInline() && m_y2.isInline() && m_spanEnd.isInline() && m_x1.isInline() &&
+           m_x2.isInline();
+  }
+
+  const Rect& bounds() const { return m_bounds; }
+
+  void clear();
+
+  void offset(int dx, int dy);
+  void offset(const PointT<int>& delta) { offset(delta.x, delta.y); }
+
+  BandRegion& createIntersection(const BandRegion& a, const BandRegion& b);
+  BandRegion& createUnion(const BandRegion& a, const BandRegion& b);
+  BandRegion& createSubtraction(const BandRegion& a, const BandRegion& b);
+
+  bool contains(const PointT<int>& pt) const;
+  Overlap contains(const Rect& rect) const;
+
+  BandRegion& operator+=(const BandRegion& b) { return createUnion(*this, b); }
+  BandRegion& operator|=(const BandRegion& b) { return createUnion(*this, b); }
+  BandRegion& operator&=(const BandRegion& b) { return createIntersection(*this, b); }
+  BandRegion& operator-=(const BandRegion& b) { return createSubtraction(*this, b); }
+
+  // Two regions are equal if they contain the same pixels (the
+  // canonical form makes this a comparison of arrays).
+  bool operator==(const BandRegion& b) const;
+  bool operator!=(const BandRegion& b) const { return !operator==(b); }
+
+private:
+  enum class Op { Union, Intersection, Subtraction };
+
+  int bandBegin(int band) const { return band > 0 ? m_spanEnd[band - 1] : 0; }
+  int findBand(int y) const;
+  int findSpan(int x, int begin, int end) const;
+
+  BandRegion& combine(Op op, const BandRegion& a, const BandRegion& b);
+  void sweep(Op op, const BandRegion& a, const BandRegion& b);
+  void addBand(int y1, int y2, const BandRegion& src, int band);
+  void addBands(const BandRegion& src, int begin, int end);
+  void addSpan(int x1, int x2)
+  {
+    m_x1.push_back(x1);
+    m_x2.push_back(x2);
+  }
+  void closeBand(int y1, int y2, int firstSpan);
+  void updateBounds();
+
+  // Bands
+  details::InlineVector<int, kInlineRects> m_y1;
+  details::InlineVector<int, kInlineRects> m_y2;
+  details::InlineVector<int, kInlineRects> m_spanEnd; // Index of the last span + 1
+  // Spans
+  details::InlineVector<int, kInlineRects> m_x1;
+  details::InlineVector<int, kInlineRects> m_x2;
+  Rect m_bounds;
+};
+
+} // namespace gfx
+
+#endif
@@ -0,0 +1,258 @@
+// LAF Gfx Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "gfx/band_region.h"
+#include "gfx/point_io.h"
+#include "gfx/rect_io.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace gfx;
+
+// Pixels in [-kMargin, kSize-kMargin) are checked with a bitmap
+static constexpr int kSize = 64;
+static constexpr int kMargin = 8;
+
+namespace {
+
+class Random {
+public:
+  explicit Random(uint32_t seed) : m_seed(seed) {}
+  int operator()(int max)
+  {
+    m_seed = m_seed * 1103515245 + 12345;
+    return int((m_seed >> 16) % max);
+  }
+
+private:
+  uint32_t m_seed;
+};
+
+using Bitmap = std::vector<bool>;
+
+Bitmap to_bitmap(const BandRegion& rgn)
+{
+  Bitmap bitmap(kSize * kSize, false);
+  for (const Rect& rc : rgn) {
+    for (int y = rc.y; y < rc.y2(); ++y)
+      for (int x = rc.x; x < rc.x2(); ++x)
+        bitmap[(y + kMargin) * kSize + x + kMargin] = true;
+  }
+  return bitmap;
+}
+
+Rect random_rect(Random& rand)
+{
+  return Rect(rand(kSize - 4 * kMargin) - kMargin / 2,
+              rand(kSize - 4 * kMargin) - kMargin / 2,
+              rand(kMargin * 3),
+              rand(kMargin * 3));
+}
+
+BandRegion random_region(Random& rand)
+{
+  BandRegion rgn;
+  for (int i = 0, n = rand(8); i < n; ++i)
+    rgn |= BandRegion(random_rect(rand));
+  return rgn;
+}
+
+// Checks that the region is in its canonical form: bands don't
+// overlap, spans don't overlap/touch, and adjacent bands are
+// different.
+void expect_canonical(const BandRegion& rgn)
+{
+  struct Band {
+    int y1, y2;
+    std::vector<std::pair<int, int>> spans;
+  };
+  std::vector<Band> bands;
+  for (const Rect& rc : rgn) {
+    ASSERT_FALSE(rc.isEmpty());
+    if (bands.empty() || bands.back().y1 != rc.y) {
+      if (!bands.empty()) {
+        ASSERT_LE(bands.back().y2, rc.y);
+      }
+      bands.push_back(Band{ rc.y, rc.y2(), {} });
+    }
+    Band& band = bands.back();
+    ASSERT_EQ(band.y2, rc.y2());
+    if (!band.spans.empty()) {
+      ASSERT_LT(band.spans.back().second, rc.x);
+    }
+    band.spans.push_back(std::make_pair(rc.x, rc.x2()));
+  }
+  for (size_t i = 1; i < bands.size(); ++i) {
+    if (bands[i - 1].y2 == bands[i].y1) {
+      EXPECT_NE(bands[i - 1].spans, bands[i].spans) << "Bands are not coalesced";
+    }
+  }
+  EXPECT_EQ(bands.size(), rgn.bands());
+
+  Rect bounds;
+  for (const Rect& rc : rgn)
+    bounds |= rc;
+  EXPECT_EQ(bounds, rgn.bounds());
+}
+
+} // anonymous namespace
+
+TEST(BandRegion, Basic)
+{
+  BandRegion a;
+  EXPECT_TRUE(a.isEmpty());
+  EXPECT_EQ(0, a.size());
+  EXPECT_TRUE(a.begin() == a.end());
+
+  a = Rect(2, 3, 4, 5);
+  EXPECT_TRUE(a.isRect());
+  EXPECT_FALSE(a.isComplex());
+  EXPECT_EQ(Rect(2, 3, 4, 5), *a.begin());
+  EXPECT_EQ(Rect(2, 3, 4, 5), a.bounds());
+
+  a = Rect(2, 3, 0, 5);
+  EXPECT_TRUE(a.isEmpty());
+
+  // Two rectangles in the same band
+  a = Rect(0, 0, 4, 4);
+  a |= BandRegion(Rect(8, 0, 4, 4));
+  EXPECT_EQ(2, a.size());
+  EXPECT_EQ(1, a.bands());
+  EXPECT_EQ(Rect(0, 0, 12, 4), a.bounds());
+
+  // Touching spans are merged, and then bands are coalesced
+  a |= BandRegion(Rect(4, 0, 4, 4));
+  EXPECT_TRUE(a.isRect());
+  a |= BandRegion(Rect(0, 4, 12, 4));
+  EXPECT_TRUE(a.isRect());
+  EXPECT_EQ(Rect(0, 0, 12, 8), a.bounds());
+
+  a.offset(-1, 2);
+  EXPECT_EQ(Rect(-1, 2, 12, 8), a.bounds());
+  EXPECT_EQ(Rect(-1, 2, 12, 8), *a.begin());
+}
+
+TEST(BandRegion, Operations)
+{
+  BandRegion a(Rect(0, 0, 10, 10));
+  BandRegion b(Rect(5, 5, 10, 10));
+
+  BandRegion c;
+  c.createIntersection(a, b);
+  EXPECT_EQ(BandRegion(Rect(5, 5, 5, 5)), c);
+
+  c.createUnion(a, b);
+  EXPECT_EQ(3, c.size());
+  EXPECT_EQ(Rect(0, 0, 15, 15), c.bounds());
+
+  c.createSubtraction(a, b);
+  EXPECT_EQ(2, c.size());
+  EXPECT_EQ(Rect(0, 0, 10, 5), *c.begin());
+  EXPECT_EQ(Rect(0, 5, 5, 5), *(++c.begin()));
+
+  // A hole in the middle
+  c.createSubtraction(a, BandRegion(Rect(3, 3, 4, 4)));
+  EXPECT_EQ(4, c.size());
+  EXPECT_FALSE(c.contains(Point(5, 5)));
+  EXPECT_TRUE(c.contains(Point(2, 5)));
+  EXPECT_TRUE(c.contains(Point(7, 5)));
+  EXPECT_EQ(BandRegion::In, c.contains(Rect(0, 0, 10, 3)));
+  EXPECT_EQ(BandRegion::In, c.contains(Rect(7, 0, 3, 10)));
+  EXPECT_EQ(BandRegion::Part, c.contains(Rect(2, 2, 2, 2)));
+  EXPECT_EQ(BandRegion::Out, c.contains(Rect(3, 3, 4, 4)));
+  EXPECT_EQ(BandRegion::Out, c.contains(Rect(10, 0, 4, 4)));
+
+  // Operations where the result is one of the operands
+  c = a;
+  c -= b;
+  c |= b;
+  c -= a;
+  c &= b;
+  EXPECT_EQ(2, c.size());
+  EXPECT_EQ(BandRegion().createSubtraction(b, a), c);
+}
+
+TEST(BandRegion, InlineStorage)
+{
+  BandRegion a;
+  for (int i = 0; i < BandRegion::kInlineRects; ++i) {
+    a |= BandRegion(Rect(i * 4, i * 4, 2, 2));
+    EXPECT_TRUE(a.isInline());
+  }
+  EXPECT_EQ(BandRegion::kInlineRects, a.size());
+
+  BandRegion b(a);
+  EXPECT_TRUE(b.isInline());
+  EXPECT_EQ(a, b);
+
+  a |= BandRegion(Rect(100, 100, 2, 2));
+  EXPECT_FALSE(a.isInline());
+  EXPECT_NE(a, b);
+
+  a -= BandRegion(Rect(100, 100, 2, 2));
+  EXPECT_EQ(a, b);
+
+  BandRegion c(std::move(a));
+  EXPECT_EQ(c, b);
+  EXPECT_TRUE(a.isEmpty());
+}
+
+TEST(BandRegion, RandomOperations)
+{
+  Random rand(1);
+  for (int i = 0; i < 2000; ++i) {
+    const BandRegion a = random_region(rand);
+    const BandRegion b = random_region(rand);
+    const Bitmap bitmapA = to_bitmap(a);
+    const Bitmap bitmapB = to_bitmap(b);
+
+    BandRegion u, n, s;
+    u.createUnion(a, b);
+    n.createIntersection(a, b);
+    s.createSubtraction(a, b);
+    expect_canonical(u);
+    expect_canonical(n);
+    expect_canonical(s);
+
+    const Bitmap bitmapU = to_bitmap(u);
+    const Bitmap bitmapN = to_bitmap(n);
+    const Bitmap bitmapS = to_bitmap(s);
+    for (int j = 0; j < kSize * kSize; ++j) {
+      ASSERT_EQ(bitmapA[j] || bitmapB[j], bitmapU[j]);
+      ASSERT_EQ(bitmapA[j] && bitmapB[j], bitmapN[j]);
+      ASSERT_EQ(bitmapA[j] && !bitmapB[j], bitmapS[j]);
+
+      const Point pt(j % kSize - kMargin, j / kSize - kMargin);
+      ASSERT_EQ(bitmapU[j], u.contains(pt)) << pt;
+    }
+
+    // Check contains(Rect) with the bitmap
+    const Rect rc = random_rect(rand);
+    int in = 0;
+    for (int y = rc.y; y < rc.y2(); ++y)
+      for (int x = rc.x; x < rc.x2(); ++x)
+        in += bitmapU[(y + kMargin) * kSize + x + kMargin];
+    BandRegion::Overlap overlap = BandRegion::Part;
+    if (in == 0)
+      overlap = BandRegion::Out;
+    else if (in == rc.w * rc.h)
+      overlap = BandRegion::In;
+    ASSERT_EQ(overlap, u.contains(rc)) << rc << " in " << u.bounds();
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,217 @@
+// LAF Gfx Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "gfx/max_rects_packer.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace gfx {
+
+static int common_interval(const int a1, const int a2, const int b1, const int b2)
+{
+  return std::max(0, std::min(a2, b2) - std::max(a1, b1));
+}
+
+MaxRectsPacker::MaxRectsPacker(const int width, const int height, const Heuristic heuristic)
+  : m_width(width)
+  , m_height(height)
+  , m_heuristic(heuristic)
+{
+  m_free.push_back(Rect(0, 0, width, height));
+}
+
+bool MaxRectsPacker::insert(const int w, const int h, Point& pos)
+{
+  const Rect* best = nullptr;
+  int64_t bestScore1 = INT64_MAX;
+  int64_t bestScore2 = INT64_MAX;
+  for (const Rect& fr : m_free) {
+    if (w > fr.w || h > fr.h)
+      continue;
+
+    const int leftoverH = fr.w - w;
+    const int leftoverV = fr.h - h;
+    const int shortSide = std::min(leftoverH, leftoverV);
+    const int longSide = std::max(leftoverH, leftoverV);
+    int64_t score1, score2;
+    switch (m_heuristic) {
+      case Heuristic::BottomLeft:
+        score1 = fr.y + h;
+        score2 = fr.x;
+        break;
+      case Heuristic::BestLongSideFit:
+        score1 = longSide;
+        score2 = shortSide;
+        break;
+      case Heuristic::BestAreaFit:
+        score1 = int64_t(fr.w) * fr.h - int64_t(w) * h;
+        score2 = shortSide;
+        break;
+      case Heuristic::ContactPoint:
+        score1 = -contactScore(Rect(fr.x, fr.y, w, h));
+        score2 = 0;
+        break;
+      case Heuristic::BestShortSideFit:
+      default:
+        score1 = shortSide;
+        score2 = longSide;
+        break;
+    }
+    if (score1 < bestScore1 || (score1 == bestScore1 && score2 < bestScore2)) {
+      best = &fr;
+      bestScore1 = score1;
+      bestScore2 = score2;
+    }
+  }
+  if (!best)
+    return false;
+
+  pos = best->origin();
+  place(Rect(pos.x, pos.y, w, h));
+  return true;
+}
+
+void MaxRectsPacker::release(const Rect& rc)
+{
+  if (m_heuristic == Heuristic::ContactPoint) {
+    auto it = std::find(m_used.begin(), m_used.end(), rc);
+    if (it != m_used.end())
+      m_used.erase(it);
+  }
+
+  // Merge with free rectangles that share a whole edge
+  Rect freed = rc;
+  for (bool merged = true; merged;) {
+    merged = false;
+    for (const Rect& fr : m_free) {
+      if ((fr.y == freed.y && fr.h == freed.h && (fr.x2() == freed.x || freed.x2() == fr.x)) ||
+          (fr.x == freed.x && fr.w == freed.w && (fr.y2() == freed.y || freed.y2() == fr.y))) {
+        freed |= fr;
+        merged = true;
+        break;
+      }
+    }
+  }
+
+  // Remove the free rectangles inside the new one
+  for (size_t i = 0; i < m_free.size();) {
+    if (freed.contains(m_free[i])) {
+      m_free[i] = m_free.back();
+      m_free.pop_back();
+    }
+    else
+      ++i;
+  }
+  m_free.push_back(freed);
+}
+
+void MaxRectsPacker::reset(const int width, const int height, const std::vector<Rect>& used)
+{
+  m_width = width;
+  m_height = height;
+  m_free.clear();
+  m_free.push_back(Rect(0, 0, width, height));
+  m_used.clear();
+  for (const Rect& rc : used)
+    place(rc);
+}
+
+int MaxRectsPacker::contactScore(const Rect& rc) const
+{
+  int score = 0;
+  if (rc.x == 0 || rc.x2() == m_width)
+    score += rc.h;
+  if (rc.y == 0 || rc.y2() == m_height)
+    score += rc.w;
+  for (const Rect& used : m_used) {
+    if (used.x == rc.x2() || used.x2() == rc.x)
+      score += common_interval(used.y, used.y2(), rc.y, rc.y2());
+    if (used.y == rc.y2() || used.y2() == rc.y)
+      score += common_interval(used.x, used.x2(), rc.x, rc.x2());
+  }
+  return score;
+}
+
+void MaxRectsPacker::place(const Rect& used)
+{
+  for (size_t i = 0; i < m_free.size();) {
+    if (split(m_free[i], used)) {
+      m_free[i] = m_free.back();
+      m_free.pop_back();
+    }
+    else
+      ++i;
+  }
+  prune();
+
+  if (m_heuristic == Heuristic::ContactPoint)
+    m_used.push_back(used);
+}
+
+// Adds to m_new the free parts of "fr" that are not covered by
+// "used", returns false if they don't intersect.
+bool MaxRectsPacker::split(const Rect& fr, const Rect& used)
+{
+  if (!fr.intersects(used))
+    return false;
+
+  m_newChecked = m_new.size();
+  if (used.y > fr.y)
+    addNew(Rect(fr.x, fr.y, fr.w, used.y - fr.y));
+  if (used.y2() < fr.y2())
+    addNew(Rect(fr.x, used.y2(), fr.w, fr.y2() - used.y2()));
+  if (used.x > fr.x)
+    addNew(Rect(fr.x, fr.y, used.x - fr.x, fr.h));
+  if (used.x2() < fr.x2())
+    addNew(Rect(used.x2(), fr.y, fr.x2() - used.x2(), fr.h));
+  return true;
+}
+
+// Adds a new free rectangle if it's not contained in a new free
+// rectangle from a previous split(), removing the ones that it
+// contains.
+void MaxRectsPacker::addNew(const Rect& rc)
+{
+  for (size_t i = 0; i < m_newChecked;) {
+    if (m_new[i].contains(rc))
+      return;
+    if (rc.contains(m_new[i])) {
+      // Keep the rectangles added in the current split() at the end
+      m_new[i] = m_new[--m_newChecked];
+      m_new[m_newChecked] = m_new.back();
+      m_new.pop_back();
+    }
+    else
+      ++i;
+  }
+  m_new.push_back(rc);
+}
+
+// Removes the new free rectangles that are inside old ones (old
+// free rectangles cannot be inside new ones as they are always
+// smaller).
+void MaxRectsPacker::prune()
+{
+  for (const Rect& fr : m_free) {
+    for (size_t j = 0; j < m_new.size();) {
+      if (fr.contains(m_new[j])) {
+        m_new[j] = m_new.back();
+        m_new.pop_back();
+      }
+      else
+        ++j;
+    }
+  }
+  m_free.insert(m_free.end(), m_new.begin(), m_new.end());
+  m_new.clear();
+}
+
+} // namespace gfx
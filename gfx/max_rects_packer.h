@@ -0,0 +1,63 @@
+// LAF Gfx Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef GFX_MAX_RECTS_PACKER_H_INCLUDED
+#define GFX_MAX_RECTS_PACKER_H_INCLUDED
+#pragma once
+
+#include "gfx/packing_rects.h"
+#include "gfx/point.h"
+#include "gfx/rect.h"
+
+#include <vector>
+
+namespace gfx {
+
+// MaxRects bin packer used by PackingRects and AtlasAllocator. Keeps
+// the list of maximal free rectangles (they can overlap each other),
+// each placed rectangle splits the free rectangles that it
+// intersects. Based on "A Thousand Ways to Pack the Bin" by Jukka
+// Jylanki.
+class MaxRectsPacker {
+public:
+  using Heuristic = PackingRects::Heuristic;
+
+  MaxRectsPacker(int width, int height, Heuristic heuristic);
+
+  // Finds a place for a rectangle of the given size, returns false if
+  // there is no space.
+  bool insert(int w, int h, Point& pos);
+
+  // Marks a rectangle returned by insert() as free space again. The
+  // free rectangles that share an edge with it are merged, but the
+  // free list is not maximal anymore (see reset()).
+  void release(const Rect& rc);
+
+  // Restarts with an empty bin of the given size, and places the
+  // given rectangles (which must be inside the bin).
+  void reset(int width, int height, const std::vector<Rect>& used = {});
+
+  const std::vector<Rect>& freeRects() const { return m_free; }
+
+private:
+  int contactScore(const Rect& rc) const;
+  void place(const Rect& used);
+  bool split(const Rect& fr, const Rect& used);
+  void addNew(const Rect& rc);
+  void prune();
+
+  int m_width;
+  int m_height;
+  Heuristic m_heuristic;
+  std::vector<Rect> m_free;
+  std::vector<Rect> m_new;
+  std::vector<Rect> m_used; // Only for Heuristic::ContactPoint
+  size_t m_newChecked = 0;
+};
+
+} // namespace gfx
+
+#endif
@@ -1,5 +1,5 @@
 // LAF Gfx Library
-// Copyright (C) 2019-2023  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 // Copyright (C) 2001-2014 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -11,11 +11,321 @@
 
 #include "gfx/packing_rects.h"
 
+#include "gfx/max_rects_packer.h"
+#include "gfx/point.h"
 #include "gfx/region.h"
 #include "gfx/size.h"
 
+#include "base/thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+
 namespace gfx {
 
+namespace {
+
+// Skyline bin packer. All coordinates are relative to the bin
+// origin. Based on "A Thousand Ways to Pack the Bin" by Jukka
+// Jylanki.
+class SkylinePacker {
+public:
+  SkylinePacker(const int width, const int height, const bool minWaste)
+    : m_width(width)
+    , m_height(height)
+    , m_minWaste(minWaste)
+  {
+    m_skyline.push_back(Segment{ 0, 0, width });
+  }
+
+  bool insert(const int w, const int h, Point& pos)
+  {
+    int bestIndex = -1;
+    int64_t bestScore1 = INT64_MAX;
+    int64_t bestScore2 = INT64_MAX;
+    for (int i = 0; i < int(m_skyline.size()); ++i) {
+      int y;
+      if (!fits(i, w, h, y))
+        continue;
+
+      int64_t score1, score2;
+      if (m_minWaste) {
+        score1 = wastedArea(i, w, y);
+        score2 = y + h;
+      }
+      else {
+        score1 = y + h;
+        score2 = m_skyline[i].w;
+      }
+      if (score1 < bestScore1 || (score1 == bestScore1 && score2 < bestScore2)) {
+        bestIndex = i;
+        bestScore1 = score1;
+        bestScore2 = score2;
+        pos = Point(m_skyline[i].x, y);
+      }
+    }
+    if (bestIndex < 0)
+      return false;
+
+    addLevel(bestIndex, Segment{ pos.x, pos.y + h, w });
+    return true;
+  }
+
+private:
+  struct Segment {
+    int x, y, w;
+  };
+
+  // Returns true if a rectangle of the given size can be placed at
+  // the left side of the i-th segment, "y" is the position where it
+  // should be placed to be above the skyline.
+  bool fits(int i, const int w, const int h, int& y) const
+  {
+    if (m_skyline[i].x + w > m_width)
+      return false;
+
+    y = 0;
+    int widthLeft = w;
+    while (widthLeft > 0) {
+      y = std::max(y, m_skyline[i].y);
+      if (y + h > m_height)
+        return false;
+      widthLeft -= m_skyline[i].w;
+      ++i;
+    }
+    return true;
+  }
+
+  int64_t wastedArea(int i, const int w, const int y) const
+  {
+    const int x2 = m_skyline[i].x + w;
+    int64_t area = 0;
+    for (; i < int(m_skyline.size()) && m_skyline[i].x < x2; ++i) {
+      const Segment& seg = m_skyline[i];
+      area += int64_t(std::min(x2, seg.x + seg.w) - seg.x) * (y - seg.y);
+    }
+    return area;
+  }
+
+  void addLevel(const int index, const Segment& segment)
+  {
+    m_skyline.insert(m_skyline.begin() + index, segment);
+
+    // Shrink/remove the segments below the new one
+    for (int i = index + 1; i < int(m_skyline.size());) {
+      const Segment& prev = m_skyline[i - 1];
+      Segment& seg = m_skyline[i];
+      const int overlap = prev.x + prev.w - seg.x;
+      if (overlap <= 0)
+        break;
+      seg.x += overlap;
+      seg.w -= overlap;
+      if (seg.w > 0)
+        break;
+      m_skyline.erase(m_skyline.begin() + i);
+    }
+
+    // Merge segments at the same height
+    for (int i = std::max(index - 1, 0); i + 1 < int(m_skyline.size()) && i <= index + 1;) {
+      if (m_skyline[i].y == m_skyline[i + 1].y) {
+        m_skyline[i].w += m_skyline[i + 1].w;
+        m_skyline.erase(m_skyline.begin() + i + 1);
+      }
+      else
+        ++i;
+    }
+  }
+
+  int m_width;
+  int m_height;
+  bool m_minWaste;
+  std::vector<Segment> m_skyline;
+};
+
+// Generates the texture sizes to try in bestFit() in order.
+class SizeCandidates {
+public:
+  using Objective = PackingRects::Objective;
+
+  // "minSize" is the size of the biggest rectangle (or the fixed
+  // width/height), "neededArea" the area of all rectangles.
+  SizeCandidates(const Objective objective,
+                 const Size& minSize,
+                 const int64_t neededArea,
+                 const bool fixedWidth,
+                 const bool fixedHeight,
+                 const int borderPadding)
+    : m_objective(objective)
+    , m_w0(minSize.w)
+    , m_h0(minSize.h)
+    , m_w(minSize.w)
+    , m_h(minSize.h)
+    , m_neededArea(std::max<int64_t>(neededArea, 1))
+    , m_fixedWidth(fixedWidth)
+    , m_fixedHeight(fixedHeight)
+    , m_border(2 * borderPadding)
+  {
+    // Only the Default objective makes sense when one side is fixed
+    // (except for PowerOfTwo on the other side).
+    if ((m_fixedWidth || m_fixedHeight) && m_objective != Objective::PowerOfTwo)
+      m_objective = Objective::Default;
+
+    switch (m_objective) {
+      case Objective::MinArea: m_areaLimit = m_neededArea - 1; break;
+      case Objective::PowerOfTwo:
+        m_w = pot(m_w0 + m_border);
+        m_h = pot(m_h0 + m_border);
+        m_areaLimit = log2(pot(m_neededArea)) - 1;
+        break;
+      case Objective::Square:
+        m_w = std::max({ m_w0, m_h0, int(std::ceil(std::sqrt(double(m_neededArea)))) });
+        m_step = std::max(1, std::min(m_w0, m_h0) / 4);
+        break;
+      default: break;
+    }
+  }
+
+  // Returns the next texture size (including the border padding).
+  Size next()
+  {
+    switch (m_objective) {
+      case Objective::MinArea:    return nextFromLevels();
+      case Objective::PowerOfTwo: return nextPowerOfTwo();
+      case Objective::Square:     {
+        const Size size(m_w + m_border, m_w + m_border);
+        m_w += m_step;
+        return size;
+      }
+      default: {
+        const Size size(m_w + m_border, m_h + m_border);
+        if (!m_fixedWidth && !m_fixedHeight) {
+          if ((++m_z) & 1)
+            m_w += m_w0;
+          else
+            m_h += m_h0;
+        }
+        else if (!m_fixedWidth) {
+          m_w += m_w0;
+        }
+        else {
+          m_h += m_h0;
+        }
+        return size;
+      }
+    }
+  }
+
+private:
+  static int64_t pot(const int64_t v)
+  {
+    int64_t p = 1;
+    while (p < v)
+      p <<= 1;
+    return p;
+  }
+
+  static int log2(int64_t v)
+  {
+    int n = 0;
+    while (v > 1) {
+      v >>= 1;
+      ++n;
+    }
+    return n;
+  }
+
+  // Avoids very long textures (unless the rectangles are long)
+  bool validRatio(const int64_t w, const int64_t h) const
+  {
+    return (w <= 4 * std::max<int64_t>(h, m_w0 + m_border) &&
+            h <= 4 * std::max<int64_t>(w, m_h0 + m_border));
+  }
+
+  Size nextPowerOfTwo()
+  {
+    if (m_fixedWidth || m_fixedHeight) {
+      const Size size = (m_fixedWidth ? Size(m_w0 + m_border, m_h) : Size(m_w, m_h0 + m_border));
+      if (m_fixedWidth)
+        m_h *= 2;
+      else
+        m_w *= 2;
+      return size;
+    }
+
+    // Each level has all sizes with the same area (2^level)
+    while (m_level.empty()) {
+      const int e = ++m_areaLimit;
+      const int minA = log2(m_w);
+      const int minB = log2(m_h);
+      for (int a = minA; a <= e - minB; ++a) {
+        const int b = e - a;
+        if (a < 31 && b < 31 && validRatio(int64_t(1) << a, int64_t(1) << b))
+          m_level.push_back(Size(1 << a, 1 << b));
+      }
+      sortLevel();
+    }
+    const Size size = m_level.front();
+    m_level.pop_front();
+    return size;
+  }
+
+  // Sizes with area in the range (m_areaLimit, m_areaLimit*5/4] are
+  // generated at the same time and tried from the smallest area.
+  Size nextFromLevels()
+  {
+    while (m_level.empty()) {
+      const int64_t lo = m_areaLimit;
+      const int64_t hi = lo + lo / 4 + 1;
+      for (int64_t w = m_w0; w * m_h0 <= hi; w += m_w0) {
+        for (int64_t h = std::max<int64_t>(lo / w / m_h0, 1) * m_h0; w * h <= hi; h += m_h0) {
+          if (w * h > lo && validRatio(w, h))
+            m_level.push_back(Size(int(w) + m_border, int(h) + m_border));
+        }
+      }
+      m_areaLimit = hi;
+      sortLevel();
+    }
+    const Size size = m_level.front();
+    m_level.pop_front();
+    return size;
+  }
+
+  // Sorts by area, then squarer sizes first, then wider first.
+  void sortLevel()
+  {
+    std::sort(m_level.begin(), m_level.end(), [](const Size& a, const Size& b) {
+      const int64_t areaA = int64_t(a.w) * a.h;
+      const int64_t areaB = int64_t(b.w) * b.h;
+      if (areaA != areaB)
+        return areaA < areaB;
+      if (std::abs(a.w - a.h) != std::abs(b.w - b.h))
+        return std::abs(a.w - a.h) < std::abs(b.w - b.h);
+      return a.w > b.w;
+    });
+  }
+
+  Objective m_objective;
+  int m_w0, m_h0;
+  int m_w, m_h;
+  int m_z = 0;
+  int m_step = 1;
+  int64_t m_neededArea;
+  int64_t m_areaLimit = 0;
+  bool m_fixedWidth;
+  bool m_fixedHeight;
+  int m_border;
+  std::deque<Size> m_level;
+};
+
+} // anonymous namespace
+
 void PackingRects::add(const Size& sz)
 {
   m_rects.push_back(Rect(sz));
@@ -26,7 +336,10 @@ void PackingRects::add(const Rect& rc)
   m_rects.push_back(rc);
 }
 
-Size PackingRects::bestFit(base::task_token& token, const int fixedWidth, const int fixedHeight)
+Size PackingRects::bestFit(base::task_token& token,
+                           const int fixedWidth,
+                           const int fixedHeight,
+                           base::thread_pool* pool)
 {
   Size size(fixedWidth, fixedHeight);
 
@@ -36,43 +349,117 @@ Size PackingRects::bestFit(base::task_token& token, const int fixedWidth, const
 
   // Calculate the amount of pixels that we need, the texture cannot
   // be smaller than that.
-  int neededArea = 0;
+  int64_t neededArea = 0;
   for (const auto& rc : m_rects) {
-    neededArea += rc.w * rc.h;
+    neededArea += int64_t(rc.w) * rc.h;
     size |= rc.size();
   }
 
-  const int w0 = std::max(size.w, 1);
-  const int h0 = std::max(size.h, 1);
-  int w = w0;
-  int h = h0;
-  int z = 0;
-  bool fit = false;
-  while (!token.canceled()) {
-    if (w * h >= neededArea) {
-      const Size sizeCandidate = Size(w + 2 * m_borderPadding, h + 2 * m_borderPadding);
-      fit = pack(sizeCandidate, token);
-      if (fit) {
-        size = sizeCandidate;
-        break;
-      }
+  SizeCandidates candidates(m_objective,
+                            Size(std::max(size.w, 1), std::max(size.h, 1)),
+                            neededArea,
+                            fixedWidth > 0,
+                            fixedHeight > 0,
+                            m_borderPadding);
+  auto nextCandidate = [&]() {
+    while (true) {
+      const Size candidate = candidates.next();
+      const int64_t w = candidate.w - 2 * m_borderPadding;
+      const int64_t h = candidate.h - 2 * m_borderPadding;
+      if (w * h >= neededArea)
+        return candidate;
     }
+  };
 
-    if (fixedWidth == 0 && fixedHeight == 0) {
-      if ((++z) & 1)
-        w += w0;
-      else
-        h += h0;
+  if (!pool || pool->size() < 2) {
+    while (!token.canceled()) {
+      const Size sizeCandidate = nextCandidate();
+      if (pack(sizeCandidate, token))
+        return sizeCandidate;
     }
-    else if (fixedWidth == 0) {
-      w += w0;
+    return size;
+  }
+
+  // Pack several candidates in parallel (each one in a copy of this
+  // PackingRects). The result is the first candidate (in the
+  // sequential order) that fits, so when a candidate fits, the next
+  // ones are canceled, and we wait the previous ones.
+  struct Try {
+    Size size;
+    PackingRects packer;
+    base::task_token token;
+    bool finished = false;
+    bool fit = false;
+  };
+  std::deque<std::unique_ptr<Try>> tries;
+  std::mutex mutex;
+  std::condition_variable cv;
+  int finishedCount = 0;
+  int seenCount = 0;
+  bool found = false;
+
+  auto cancelFrom = [&tries](size_t i) {
+    for (; i < tries.size(); ++i)
+      tries[i]->token.cancel();
+  };
+
+  while (true) {
+    while (!found && !token.canceled() && tries.size() < pool->size()) {
+      auto t = std::make_unique<Try>();
+      t->size = nextCandidate();
+      t->packer = *this;
+      Try* ptr = t.get();
+      tries.push_back(std::move(t));
+      pool->execute([ptr, &mutex, &cv, &finishedCount] {
+        const bool fit = ptr->packer.pack(ptr->size, ptr->token);
+        const std::lock_guard lock(mutex);
+        ptr->fit = fit;
+        ptr->finished = true;
+        ++finishedCount;
+        cv.notify_all();
+      });
+    }
+
+    std::unique_lock lock(mutex);
+    cv.wait_for(lock, std::chrono::milliseconds(50), [&] { return finishedCount != seenCount; });
+    seenCount = finishedCount;
+
+    if (token.canceled()) {
+      cancelFrom(0);
+      found = true;
     }
     else {
-      h += h0;
+      for (size_t i = 0; i < tries.size(); ++i) {
+        if (tries[i]->finished && tries[i]->fit) {
+          cancelFrom(i + 1);
+          found = true;
+          break;
+        }
+      }
     }
-  }
 
-  return size;
+    // Discard candidates that didn't fit
+    while (!tries.empty() && tries.front()->finished &&
+           (!tries.front()->fit || token.canceled())) {
+      tries.pop_front();
+    }
+    if (tries.empty() && found)
+      return size; // Canceled
+
+    if (!tries.empty()) {
+      Try& front = *tries.front();
+      if (front.finished && front.fit) {
+        // Wait the canceled candidates
+        cv.wait(lock, [&tries] {
+          return std::all_of(tries.begin(), tries.end(), [](const auto& t) { return t->finished; });
+        });
+        m_bounds = front.packer.m_bounds;
+        m_rects = front.packer.m_rects;
+        return front.size;
+      }
+      token.set_progress(front.token.progress());
+    }
+  }
 }
 
 static bool by_area(const Rect* a, const Rect* b)
@@ -80,6 +467,11 @@ static bool by_area(const Rect* a, const Rect* b)
   return a->w * a->h > b->w * b->h;
 }
 
+static bool by_height(const Rect* a, const Rect* b)
+{
+  return (a->h > b->h || (a->h == b->h && a->w > b->w));
+}
+
 bool PackingRects::pack(const Size& size, base::task_token& token)
 {
   m_bounds = Rect(size).shrink(m_borderPadding);
@@ -89,14 +481,80 @@ bool PackingRects::pack(const Size& size, base::task_token& token)
   int i = 0;
   for (auto& rc : m_rects)
     rectPtrs[i++] = &rc;
-  std::stable_sort(rectPtrs.begin(), rectPtrs.end(), by_area);
+  std::stable_sort(rectPtrs.begin(),
+                   rectPtrs.end(),
+                   m_algorithm == Algorithm::Skyline ? by_height : by_area);
 
+  // Fast rejection when the rectangles (with their shape padding)
+  // need more area than the available one.
+  if (m_bounds.w >= 0 && m_bounds.h >= 0) {
+    int64_t neededArea = 0;
+    for (const auto& rc : m_rects)
+      neededArea += int64_t(rc.w + m_shapePadding) * (rc.h + m_shapePadding);
+    if (neededArea > int64_t(m_bounds.w + m_shapePadding) * (m_bounds.h + m_shapePadding))
+      return false;
+  }
+
+  switch (m_algorithm) {
+    case Algorithm::Skyline:  return packSkyline(rectPtrs, token);
+    case Algorithm::MaxRects: return packMaxRects(rectPtrs, token);
+    default:                  return packBruteForce(rectPtrs, token);
+  }
+}
+
+// Packs the rectangles with the given packer. The shape padding is
+// added to the right/bottom of each rectangle, and the bin is
+// extended with the same padding, so rectangles touching the
+// right/bottom edges don't need padding (the same as the brute force
+// algorithm).
+template<typename Packer>
+static bool pack_with(Packer& packer,
+                      const Rect& bounds,
+                      const int shapePadding,
+                      const std::vector<Rect*>& rects,
+                      base::task_token& token)
+{
+  int i = 0;
+  for (auto* rcPtr : rects) {
+    if (token.canceled())
+      return false;
+    token.set_progress(float(i++) / int(rects.size()));
+
+    Rect& rc = *rcPtr;
+    const int w = rc.w + shapePadding;
+    const int h = rc.h + shapePadding;
+    Point pos;
+    if (w <= 0 || h <= 0)
+      pos = Point(0, 0);
+    else if (!packer.insert(w, h, pos))
+      return false; // There is not enough room for "rc"
+    rc = Rect(bounds.x + pos.x, bounds.y + pos.y, rc.w, rc.h);
+  }
+  return true;
+}
+
+bool PackingRects::packSkyline(const std::vector<Rect*>& rects, base::task_token& token)
+{
+  SkylinePacker packer(m_bounds.w + m_shapePadding,
+                       m_bounds.h + m_shapePadding,
+                       m_heuristic != Heuristic::BottomLeft);
+  return pack_with(packer, m_bounds, m_shapePadding, rects, token);
+}
+
+bool PackingRects::packMaxRects(const std::vector<Rect*>& rects, base::task_token& token)
+{
+  MaxRectsPacker packer(m_bounds.w + m_shapePadding, m_bounds.h + m_shapePadding, m_heuristic);
+  return pack_with(packer, m_bounds, m_shapePadding, rects, token);
+}
+
+bool PackingRects::packBruteForce(const std::vector<Rect*>& rects, base::task_token& token)
+{
   gfx::Region rgn(m_bounds);
-  i = 0;
-  for (auto* rcPtr : rectPtrs) {
+  int i = 0;
+  for (auto* rcPtr : rects) {
     if (token.canceled())
       return false;
-    token.set_progress(float(i) / int(rectPtrs.size()));
+    token.set_progress(float(i) / int(rects.size()));
 
     gfx::Rect& rc = *rcPtr;
 
@@ -1,5 +1,5 @@
 // LAF Gfx Library
-// Copyright (C) 2019  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 // Copyright (C) 2001-2015  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -14,17 +14,76 @@
 #include "gfx/rect.h"
 #include <vector>
 
+namespace base {
+class thread_pool;
+}
+
 namespace gfx {
 
 // TODO add support for rotations
 class PackingRects {
 public:
+  enum class Algorithm {
+    // Tries all pixel positions for each rectangle (from top-left to
+    // bottom-right) using a gfx::Region of the free space. It's slow
+    // for hundreds of rectangles, but it's the default one to keep
+    // the same results of previous versions.
+    BruteForce,
+
+    // Keeps the top edge of the placed rectangles (the "skyline") as
+    // a list of horizontal segments. It's the fastest algorithm, but
+    // it cannot use the space below the skyline.
+    Skyline,
+
+    // Keeps a list of all maximal free rectangles. It's slower than
+    // Skyline but gives the tightest results.
+    MaxRects,
+  };
+
+  // Heuristic to choose the position of each rectangle in Skyline
+  // and MaxRects algorithms. The Skyline algorithm only supports
+  // BottomLeft, any other value minimizes the wasted area below the
+  // placed rectangle.
+  enum class Heuristic {
+    BottomLeft,       // Lowest position, then the leftmost one
+    BestShortSideFit, // Free rectangle with the smallest leftover on its shorter side
+    BestLongSideFit,  // Free rectangle with the smallest leftover on its longer side
+    BestAreaFit,      // Smallest free rectangle (or less wasted area for Skyline)
+    ContactPoint,     // Maximize the perimeter touching other rectangles/borders
+  };
+
+  // Texture sizes tried by bestFit() (the first size where all
+  // rectangles fit is used).
+  enum class Objective {
+    // Grows the width and the height alternately by the size of the
+    // biggest rectangle (the same results of previous versions).
+    Default,
+
+    // Sizes in steps of the biggest rectangle size, from the
+    // smallest area to the biggest one.
+    MinArea,
+
+    // Power of two width and height (including the border padding).
+    PowerOfTwo,
+
+    // Same width and height.
+    Square,
+  };
+
   PackingRects(int borderPadding = 0, int shapePadding = 0)
     : m_borderPadding(borderPadding)
     , m_shapePadding(shapePadding)
   {
   }
 
+  Algorithm algorithm() const { return m_algorithm; }
+  Heuristic heuristic() const { return m_heuristic; }
+  void setAlgorithm(Algorithm algorithm) { m_algorithm = algorithm; }
+  void setHeuristic(Heuristic heuristic) { m_heuristic = heuristic; }
+
+  Objective objective() const { return m_objective; }
+  void setObjective(Objective objective) { m_objective = objective; }
+
   typedef std::vector<Rect> Rects;
   typedef Rects::const_iterator const_iterator;
 
@@ -40,8 +99,13 @@ public:
   void add(const Size& sz);
   void add(const Rect& rc);
 
-  // Returns the best size for the texture.
-  Size bestFit(base::task_token& token, const int fixedWidth = 0, const int fixedHeight = 0);
+  // Returns the best size for the texture. If a thread pool is given,
+  // several sizes are packed at the same time, the result is the same
+  // as packing them one after another.
+  Size bestFit(base::task_token& token,
+               const int fixedWidth = 0,
+               const int fixedHeight = 0,
+               base::thread_pool* pool = nullptr);
 
   // Rearrange all given rectangles to best fit a texture size.
   // Returns true if all rectangles were correctly arranged or false
@@ -52,8 +116,15 @@ public:
   const Rect& bounds() const { return m_bounds; }
 
 private:
+  bool packBruteForce(const std::vector<Rect*>& rects, base::task_token& token);
+  bool packSkyline(const std::vector<Rect*>& rects, base::task_token& token);
+  bool packMaxRects(const std::vector<Rect*>& rects, base::task_token& token);
+
   int m_borderPadding;
   int m_shapePadding;
+  Algorithm m_algorithm = Algorithm::BruteForce;
+  Heuristic m_heuristic = Heuristic::BestShortSideFit;
+  Objective m_objective = Objective::Default;
 
   Rect m_bounds;
   Rects m_rects;
@@ -1,5 +1,5 @@
 // LAF Gfx Library
-// Copyright (C) 2019-2021  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 // Copyright (C) 2001-2014 David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -13,11 +13,64 @@
 
 #if LAF_WITH_REGION
 
+  #include "base/thread_pool.h"
   #include "gfx/packing_rects.h"
   #include "gfx/rect_io.h"
   #include "gfx/size.h"
+  #include "gfx/size_io.h"
+
+  #include <chrono>
+  #include <cstdio>
 
 using namespace gfx;
+using Algorithm = PackingRects::Algorithm;
+using Heuristic = PackingRects::Heuristic;
+using Objective = PackingRects::Objective;
+
+static const Algorithm kFastAlgorithms[] = { Algorithm::Skyline, Algorithm::MaxRects };
+static const Heuristic kHeuristics[] = { Heuristic::BottomLeft,
+                                         Heuristic::BestShortSideFit,
+                                         Heuristic::BestLongSideFit,
+                                         Heuristic::BestAreaFit,
+                                         Heuristic::ContactPoint };
+
+// Sprite sizes of a typical sprite sheet: trimmed frames of a few
+// characters (similar sizes), plus some small items and big tiles.
+static std::vector<Size> sprite_sizes(const int n)
+{
+  std::vector<Size> sizes;
+  uint32_t seed = 12345;
+  auto rand = [&seed](int max) {
+    seed = seed * 1103515245 + 12345;
+    return int((seed >> 16) % max);
+  };
+  for (int i = 0; i < n; ++i) {
+    switch (rand(10)) {
+      case 0:  sizes.push_back(Size(8 + rand(16), 8 + rand(16))); break;
+      case 1:  sizes.push_back(Size(64 + rand(64), 64 + rand(64))); break;
+      default: sizes.push_back(Size(24 + rand(24), 32 + rand(32))); break;
+    }
+  }
+  return sizes;
+}
+
+// Checks that all rectangles are inside the packed area and that the
+// shape padding is respected between them.
+static void expect_valid_packing(const PackingRects& pr, const int shapePadding)
+{
+  const Rect bounds = pr.bounds();
+  for (int i = 0; i < int(pr.size()); ++i) {
+    const Rect& a = pr[i];
+    EXPECT_TRUE(bounds.contains(a)) << "Rect " << a << " outside " << bounds;
+    for (int j = i + 1; j < int(pr.size()); ++j) {
+      Rect b = pr[j];
+      const Rect paddedA(a.x, a.y, a.w + shapePadding, a.h + shapePadding);
+      const Rect paddedB(b.x, b.y, b.w + shapePadding, b.h + shapePadding);
+      EXPECT_FALSE(paddedA.intersects(b) || paddedB.intersects(a))
+        << "Rects " << a << " and " << b << " overlap";
+    }
+  }
+}
 
 TEST(PackingRects, Simple)
 {
@@ -120,6 +173,207 @@ TEST(PackingRects, BorderAndShapePadding)
   EXPECT_EQ(Rect(10, 216, 200, 100), pr[2]);
 }
 
+TEST(PackingRects, FastAlgorithms)
+{
+  base::task_token token;
+  for (auto algorithm : kFastAlgorithms) {
+    for (auto heuristic : kHeuristics) {
+      PackingRects pr;
+      pr.setAlgorithm(algorithm);
+      pr.setHeuristic(heuristic);
+      pr.add(Size(256, 128));
+      pr.add(Size(256, 120));
+      EXPECT_FALSE(pr.pack(Size(256, 247), token));
+      EXPECT_TRUE(pr.pack(Size(256, 256), token));
+      EXPECT_EQ(Rect(0, 0, 256, 256), pr.bounds());
+      EXPECT_EQ(Rect(0, 0, 256, 128), pr[0]);
+      EXPECT_EQ(Rect(0, 128, 256, 120), pr[1]);
+
+      for (const Size& sz : sprite_sizes(200))
+        pr.add(sz);
+      pr.bestFit(token);
+      expect_valid_packing(pr, 0);
+    }
+  }
+}
+
+TEST(PackingRects, FastAlgorithmsBorderAndShapePadding)
+{
+  base::task_token token;
+  for (auto algorithm : kFastAlgorithms) {
+    for (auto heuristic : kHeuristics) {
+      PackingRects pr(10, 3);
+      pr.setAlgorithm(algorithm);
+      pr.setHeuristic(heuristic);
+      pr.add(Size(200, 100));
+      pr.add(Size(200, 100));
+      pr.add(Size(200, 100));
+
+      EXPECT_FALSE(pr.pack(Size(220, 325), token));
+      EXPECT_FALSE(pr.pack(Size(219, 326), token));
+      EXPECT_TRUE(pr.pack(Size(220, 326), token));
+      expect_valid_packing(pr, 3);
+
+      for (const Size& sz : sprite_sizes(100))
+        pr.add(sz);
+      pr.bestFit(token);
+      expect_valid_packing(pr, 3);
+      EXPECT_EQ(10, pr.bounds().x);
+      EXPECT_EQ(10, pr.bounds().y);
+    }
+  }
+}
+
+TEST(PackingRects, Canceled)
+{
+  base::task_token token;
+  PackingRects pr;
+  pr.setAlgorithm(Algorithm::MaxRects);
+  for (const Size& sz : sprite_sizes(10))
+    pr.add(sz);
+  token.cancel();
+  EXPECT_FALSE(pr.pack(Size(4096, 4096), token));
+}
+
+static bool is_pot(const int v)
+{
+  return v > 0 && (v & (v - 1)) == 0;
+}
+
+TEST(PackingRects, Objectives)
+{
+  base::task_token token;
+  for (auto algorithm : kFastAlgorithms) {
+    Size sizes[4];
+    for (auto objective :
+         { Objective::Default, Objective::MinArea, Objective::PowerOfTwo, Objective::Square }) {
+      PackingRects pr(2, 1);
+      pr.setAlgorithm(algorithm);
+      pr.setObjective(objective);
+      for (const Size& sz : sprite_sizes(150))
+        pr.add(sz);
+
+      const Size size = pr.bestFit(token);
+      expect_valid_packing(pr, 1);
+      EXPECT_EQ(Rect(size).shrink(2), pr.bounds());
+      sizes[int(objective)] = size;
+      switch (objective) {
+        case Objective::PowerOfTwo:
+          EXPECT_TRUE(is_pot(size.w) && is_pot(size.h)) << size;
+          break;
+        case Objective::Square: EXPECT_EQ(size.w, size.h); break;
+        default:                break;
+      }
+
+      // Fixed width
+      const Size fixed = pr.bestFit(token, 400, 0);
+      EXPECT_EQ(400 + 4, fixed.w);
+      if (objective == Objective::PowerOfTwo) {
+        EXPECT_TRUE(is_pot(fixed.h)) << fixed;
+      }
+      expect_valid_packing(pr, 1);
+    }
+    EXPECT_LE(sizes[int(Objective::MinArea)].w * sizes[int(Objective::MinArea)].h,
+              sizes[int(Objective::Default)].w * sizes[int(Objective::Default)].h);
+  }
+}
+
+TEST(PackingRects, ParallelBestFit)
+{
+  base::thread_pool pool(4);
+  for (auto algorithm : { Algorithm::BruteForce, Algorithm::Skyline, Algorithm::MaxRects }) {
+    for (auto objective :
+         { Objective::Default, Objective::MinArea, Objective::PowerOfTwo, Objective::Square }) {
+      const int n = (algorithm == Algorithm::BruteForce ? 8 : 300);
+      base::task_token token;
+      PackingRects seq(1, 1);
+      seq.setAlgorithm(algorithm);
+      seq.setObjective(objective);
+      for (const Size& sz : sprite_sizes(n))
+        seq.add(sz);
+      PackingRects par = seq;
+
+      const Size seqSize = seq.bestFit(token);
+      const Size parSize = par.bestFit(token, 0, 0, &pool);
+      EXPECT_EQ(seqSize, parSize);
+      EXPECT_EQ(seq.bounds(), par.bounds());
+      for (int i = 0; i < n; ++i)
+        EXPECT_EQ(seq[i], par[i]);
+    }
+  }
+
+  // Canceled
+  base::task_token token;
+  PackingRects pr;
+  for (const Size& sz : sprite_sizes(10))
+    pr.add(sz);
+  token.cancel();
+  pr.bestFit(token, 0, 0, &pool);
+}
+
+// Time and used area of each algorithm/heuristic. As it doesn't check
+// anything new, it's disabled by default (use
+// --gtest_also_run_disabled_tests to run it).
+TEST(PackingRects, DISABLED_Benchmark)
+{
+  struct Config {
+    const char* name;
+    Algorithm algorithm;
+    Heuristic heuristic;
+    Objective objective = Objective::Default;
+    bool parallel = false;
+  };
+  const Config configs[] = {
+    { "BruteForce", Algorithm::BruteForce, Heuristic::BottomLeft },
+    { "Skyline/BottomLeft", Algorithm::Skyline, Heuristic::BottomLeft },
+    { "Skyline/MinWaste", Algorithm::Skyline, Heuristic::BestAreaFit },
+    { "MaxRects/BSSF", Algorithm::MaxRects, Heuristic::BestShortSideFit },
+    { "MaxRects/BAF", Algorithm::MaxRects, Heuristic::BestAreaFit },
+    { "MaxRects/Contact", Algorithm::MaxRects, Heuristic::ContactPoint },
+    { "MaxRects/MinArea", Algorithm::MaxRects, Heuristic::BestShortSideFit, Objective::MinArea },
+    { "MaxRects/MinArea x4",
+      Algorithm::MaxRects, Heuristic::BestShortSideFit,
+      Objective::MinArea, true },
+    { "MaxRects/POT", Algorithm::MaxRects, Heuristic::BestShortSideFit, Objective::PowerOfTwo },
+    { "MaxRects/Square", Algorithm::MaxRects, Heuristic::BestShortSideFit, Objective::Square },
+  };
+  base::thread_pool pool(4);
+
+  for (int n : { 30, 1000 }) {
+    const std::vector<Size> sizes = sprite_sizes(n);
+    int64_t spritesArea = 0;
+    for (const Size& sz : sizes)
+      spritesArea += sz.w * sz.h;
+
+    for (const Config& config : configs) {
+      // The brute force algorithm is too slow for big sheets
+      if (config.algorithm == Algorithm::BruteForce && n > 30)
+        continue;
+
+      base::task_token token;
+      PackingRects pr(0, 1);
+      pr.setAlgorithm(config.algorithm);
+      pr.setHeuristic(config.heuristic);
+      pr.setObjective(config.objective);
+      for (const Size& sz : sizes)
+        pr.add(sz);
+
+      auto t0 = std::chrono::steady_clock::now();
+      const Size size = pr.bestFit(token, 0, 0, config.parallel ? &pool : nullptr);
+      auto t1 = std::chrono::steady_clock::now();
+      expect_valid_packing(pr, 1);
+
+      std::printf("%5d sprites %-22s %5dx%-5d %5.1f%% used %10.2f ms\n",
+                  n,
+                  config.name,
+                  size.w,
+                  size.h,
+                  100.0 * spritesArea / (int64_t(size.w) * size.h),
+                  std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+  }
+}
+
 #endif // LAF_WITH_REGION
 
 int main(int argc, char** argv)
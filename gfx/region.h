@@ -1,5 +1,5 @@
 // LAF Gfx Library
-// Copyright (C) 2019-2021  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -21,6 +21,8 @@
   #endif
 
   #include "gfx/region_skia.h"
+#elif LAF_NATIVE_REGION
+  #include "gfx/region_laf.h"
 #elif LAF_PIXMAN
   #include "gfx/region_pixman.h"
 #elif LAF_WINDOWS
@@ -0,0 +1,107 @@
+// LAF Gfx Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef GFX_REGION_LAF_H_INCLUDED
+#define GFX_REGION_LAF_H_INCLUDED
+#pragma once
+
+#include "gfx/band_region.h"
+#include "gfx/point.h"
+#include "gfx/rect.h"
+
+#include <utility>
+
+namespace gfx {
+
+namespace details {
+
+using Region = BandRegion;
+
+} // namespace details
+
+// gfx::Region implemented with the native laf region engine
+// (BandRegion), it doesn't depend on Skia/pixman/Win32.
+class Region {
+public:
+  enum Overlap { Out, In, Part };
+
+  using iterator = details::Region::const_iterator;
+  using const_iterator = details::Region::const_iterator;
+
+  Region() {}
+  Region(const Region& copy) : m_region(copy.m_region) {}
+  Region(Region&& other) noexcept : m_region(std::move(other.m_region)) {}
+  explicit Region(const Rect& rect) : m_region(rect) {}
+  Region& operator=(const Rect& rect)
+  {
+    m_region = rect;
+    return *this;
+  }
+  Region& operator=(const Region& copy)
+  {
+    m_region = copy.m_region;
+    return *this;
+  }
+  Region& operator=(Region&& other) noexcept
+  {
+    m_region = std::move(other.m_region);
+    return *this;
+  }
+
+  iterator begin() { return m_region.begin(); }
+  iterator end() { return m_region.end(); }
+  const_iterator begin() const { return m_region.begin(); }
+  const_iterator end() const { return m_region.end(); }
+
+  bool isEmpty() const { return m_region.isEmpty(); }
+  bool isRect() const { return m_region.isRect(); }
+  bool isComplex() const { return m_region.isComplex(); }
+
+  std::size_t size() const { return m_region.size(); }
+
+  Rect bounds() const { return m_region.bounds(); }
+
+  void clear() { m_region.clear(); }
+
+  void offset(int dx, int dy) { m_region.offset(dx, dy); }
+  void offset(const PointT<int>& delta) { m_region.offset(delta); }
+
+  Region& createIntersection(const Region& a, const Region& b)
+  {
+    m_region.createIntersection(a.m_region, b.m_region);
+    return *this;
+  }
+
+  Region& createUnion(const Region& a, const Region& b)
+  {
+    m_region.createUnion(a.m_region, b.m_region);
+    return *this;
+  }
+
+  Region& createSubtraction(const Region& a, const Region& b)
+  {
+    m_region.createSubtraction(a.m_region, b.m_region);
+    return *this;
+  }
+
+  bool contains(const PointT<int>& pt) const { return m_region.contains(pt); }
+  Overlap contains(const Rect& rect) const { return Overlap(m_region.contains(rect)); }
+
+  Region& operator+=(const Region& b) { return createUnion(*this, b); }
+  Region& operator|=(const Region& b) { return createUnion(*this, b); }
+  Region& operator&=(const Region& b) { return createIntersection(*this, b); }
+  Region& operator-=(const Region& b) { return createSubtraction(*this, b); }
+
+  const details::Region& bandRegion() const { return m_region; }
+  details::Region& bandRegion() { return m_region; }
+
+private:
+  details::Region m_region;
+};
+
+} // namespace gfx
+
+#endif
@@ -0,0 +1,134 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/common/damage_accumulator.h"
+
+namespace os {
+
+namespace {
+
+// Regions with more rectangles than this are painted as their
+// bounding box directly (merging rectangles is O(n^2)).
+constexpr int kMaxRectsToMerge = 256;
+
+int64_t area(const gfx::Rect& rc)
+{
+  return int64_t(rc.w) * rc.h;
+}
+
+} // anonymous namespace
+
+DamageAccumulator::DamageAccumulator(const int rectCost, const int maxRects)
+  : m_rectCost(rectCost)
+  , m_maxRects(maxRects)
+{
+}
+
+void DamageAccumulator::add(const gfx::Region& rgn)
+{
+  if (rgn.isEmpty())
+    return;
+
+  m_region |= rgn;
+  ++m_invalidations;
+}
+
+void DamageAccumulator::add(const gfx::Rect& rc)
+{
+  if (rc.isEmpty())
+    return;
+
+  m_region |= gfx::Region(rc);
+  ++m_invalidations;
+}
+
+bool DamageAccumulator::flush(std::vector<gfx::Rect>& rects)
+{
+  rects.clear();
+  if (m_region.isEmpty())
+    return false;
+
+  int64_t pixels = 0;
+  for (const gfx::Rect& rc : m_region) {
+    rects.push_back(rc);
+    pixels += area(rc);
+  }
+
+  DamageStats::Frame frame;
+  frame.invalidations = m_invalidations;
+  frame.rects = int(rects.size());
+  frame.pixels = pixels;
+
+  simplify(rects, pixels);
+
+  frame.paintedRects = int(rects.size());
+  for (const gfx::Rect& rc : rects)
+    frame.paintedPixels += area(rc);
+
+  ++m_stats.frames;
+  m_stats.lastFrame = frame;
+  m_stats.total.invalidations += frame.invalidations;
+  m_stats.total.rects += frame.rects;
+  m_stats.total.paintedRects += frame.paintedRects;
+  m_stats.total.pixels += frame.pixels;
+  m_stats.total.paintedPixels += frame.paintedPixels;
+
+  clear();
+  return true;
+}
+
+void DamageAccumulator::clear()
+{
+  m_region.clear();
+  m_invalidations = 0;
+}
+
+// The rectangles of the region don't overlap, but merged rectangles
+// can overlap other rectangles (in that case the overlapped area is
+// painted twice, which is considered in the cost).
+void DamageAccumulator::simplify(std::vector<gfx::Rect>& rects, const int64_t pixels) const
+{
+  const int n = int(rects.size());
+  if (n <= 1)
+    return;
+
+  // Paint just the bounding box if it's cheaper than painting each
+  // rectangle, or if there are too many rectangles.
+  const gfx::Rect bounds = m_region.bounds();
+  if (n > kMaxRectsToMerge || area(bounds) <= pixels + int64_t(m_rectCost) * (n - 1)) {
+    rects.assign(1, bounds);
+    return;
+  }
+
+  // Merge pairs of rectangles while painting their bounding box is
+  // cheaper than painting them separately.
+  bool merged;
+  do {
+    merged = false;
+    for (size_t i = 0; i < rects.size(); ++i) {
+      for (size_t j = i + 1; j < rects.size();) {
+        const gfx::Rect u = rects[i].createUnion(rects[j]);
+        if (area(u) - area(rects[i]) - area(rects[j]) <= m_rectCost) {
+          rects[i] = u;
+          rects[j] = rects.back();
+          rects.pop_back();
+          merged = true;
+        }
+        else
+          ++j;
+      }
+    }
+  } while (merged);
+
+  if (int(rects.size()) > m_maxRects)
+    rects.assign(1, bounds);
+}
+
+} // namespace os
@@ -0,0 +1,63 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_COMMON_DAMAGE_ACCUMULATOR_H_INCLUDED
+#define OS_COMMON_DAMAGE_ACCUMULATOR_H_INCLUDED
+#pragma once
+
+#include "gfx/rect.h"
+#include "gfx/region.h"
+#include "os/damage_stats.h"
+
+#include <vector>
+
+namespace os {
+
+// Accumulates the invalidated regions of a window during a frame, so
+// they can be painted all together (once per frame) instead of
+// painting each invalidated region as soon as it's invalidated.
+//
+// When the damage is flushed, the region is simplified: each painted
+// rectangle is supposed to cost like painting "rectCost" pixels, so
+// near rectangles are merged in their bounding box when painting the
+// extra area is cheaper than painting one more rectangle.
+class DamageAccumulator {
+public:
+  static constexpr int kDefaultRectCost = 64 * 64;
+  static constexpr int kDefaultMaxRects = 32;
+
+  DamageAccumulator(int rectCost = kDefaultRectCost, int maxRects = kDefaultMaxRects);
+
+  bool isEmpty() const { return m_region.isEmpty(); }
+  const gfx::Region& region() const { return m_region; }
+
+  void add(const gfx::Region& rgn);
+  void add(const gfx::Rect& rc);
+
+  // Returns in "rects" the rectangles to paint (simplified from the
+  // accumulated region), and starts a new frame. Returns false if
+  // there is nothing to paint.
+  bool flush(std::vector<gfx::Rect>& rects);
+
+  // Discards the accumulated damage (e.g. when the window is hidden).
+  void clear();
+
+  const DamageStats& stats() const { return m_stats; }
+  void resetStats() { m_stats = DamageStats(); }
+
+private:
+  void simplify(std::vector<gfx::Rect>& rects, int64_t pixels) const;
+
+  gfx::Region m_region;
+  int m_invalidations = 0;
+  int m_rectCost;
+  int m_maxRects;
+  DamageStats m_stats;
+};
+
+} // namespace os
+
+#endif
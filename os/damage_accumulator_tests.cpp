@@ -0,0 +1,112 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <gtest/gtest.h>
+
+#include "gfx/rect_io.h"
+#include "os/common/damage_accumulator.h"
+
+#include <algorithm>
+
+using namespace os;
+using gfx::Rect;
+using gfx::Region;
+
+TEST(DamageAccumulator, MergeFrame)
+{
+  DamageAccumulator damage;
+  std::vector<Rect> rects;
+  EXPECT_TRUE(damage.isEmpty());
+  EXPECT_FALSE(damage.flush(rects));
+  EXPECT_TRUE(rects.empty());
+
+  // Several invalidations of the same area are painted once
+  damage.add(Rect(0, 0, 100, 100));
+  damage.add(Region(Rect(10, 10, 20, 20)));
+  damage.add(Rect(50, 0, 50, 100));
+  damage.add(Rect(5, 5, 0, 0)); // Ignored
+  EXPECT_TRUE(damage.flush(rects));
+  ASSERT_EQ(1, rects.size());
+  EXPECT_EQ(Rect(0, 0, 100, 100), rects[0]);
+  EXPECT_TRUE(damage.isEmpty());
+
+  const DamageStats& stats = damage.stats();
+  EXPECT_EQ(1, stats.frames);
+  EXPECT_EQ(3, stats.lastFrame.invalidations);
+  EXPECT_EQ(1, stats.lastFrame.rects);
+  EXPECT_EQ(100 * 100, stats.lastFrame.pixels);
+  EXPECT_EQ(100 * 100, stats.lastFrame.paintedPixels);
+  EXPECT_EQ(1.0, stats.efficiency());
+}
+
+TEST(DamageAccumulator, Simplify)
+{
+  DamageAccumulator damage(64 * 64);
+  std::vector<Rect> rects;
+
+  // Small rectangles near each other are painted as one rectangle
+  damage.add(Rect(0, 0, 8, 8));
+  damage.add(Rect(16, 4, 8, 8));
+  damage.add(Rect(4, 20, 8, 8));
+  EXPECT_TRUE(damage.flush(rects));
+  ASSERT_EQ(1, rects.size());
+  EXPECT_EQ(Rect(0, 0, 24, 28), rects[0]);
+
+  DamageStats stats = damage.stats();
+  EXPECT_EQ(5, stats.lastFrame.rects); // Split in bands
+  EXPECT_EQ(1, stats.lastFrame.paintedRects);
+  EXPECT_EQ(3 * 8 * 8, stats.lastFrame.pixels);
+  EXPECT_EQ(24 * 28, stats.lastFrame.paintedPixels);
+
+  // Big rectangles far from each other are painted separately, and
+  // the small ones near them are merged
+  damage.add(Rect(0, 0, 200, 200));
+  damage.add(Rect(1000, 1000, 200, 200));
+  damage.add(Rect(1200, 1200, 4, 4));
+  EXPECT_TRUE(damage.flush(rects));
+  ASSERT_EQ(2, rects.size());
+  std::sort(rects.begin(), rects.end(), [](const Rect& a, const Rect& b) { return a.x < b.x; });
+  EXPECT_EQ(Rect(0, 0, 200, 200), rects[0]);
+  EXPECT_EQ(Rect(1000, 1000, 204, 204), rects[1]);
+
+  stats = damage.stats();
+  EXPECT_EQ(2, stats.frames);
+  EXPECT_EQ(3, stats.lastFrame.rects);
+  EXPECT_EQ(2, stats.lastFrame.paintedRects);
+  EXPECT_EQ(6, stats.total.invalidations);
+  EXPECT_LT(stats.efficiency(), 1.0);
+
+  damage.resetStats();
+  EXPECT_EQ(0, damage.stats().frames);
+}
+
+TEST(DamageAccumulator, MaxRects)
+{
+  DamageAccumulator damage(1, 4);
+  std::vector<Rect> rects;
+
+  // A grid of rectangles that cannot be merged with a low cost
+  for (int i = 0; i < 5; ++i)
+    damage.add(Rect(i * 100, i * 100, 10, 10));
+  EXPECT_TRUE(damage.flush(rects));
+  ASSERT_EQ(1, rects.size());
+  EXPECT_EQ(Rect(0, 0, 410, 410), rects[0]);
+
+  for (int i = 0; i < 4; ++i)
+    damage.add(Rect(i * 100, i * 100, 10, 10));
+  EXPECT_TRUE(damage.flush(rects));
+  EXPECT_EQ(4, rects.size());
+}
+
+int app_main(int argc, char* argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
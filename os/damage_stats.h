@@ -0,0 +1,41 @@
+// LAF OS Library
+// Copyright (C) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifndef OS_DAMAGE_STATS_H_INCLUDED
+#define OS_DAMAGE_STATS_H_INCLUDED
+#pragma once
+
+#include <cstdint>
+
+namespace os {
+
+// Statistics about the invalidated areas of a window (see
+// Window::invalidateRegion() and Window::damageStats()), useful to
+// tune the painting code. Areas are in non-scaled coordinates.
+struct DamageStats {
+  struct Frame {
+    int invalidations = 0;     // Number of invalidated regions
+    int rects = 0;             // Rectangles of the merged damaged region
+    int paintedRects = 0;      // Rectangles painted after simplifying the region
+    int64_t pixels = 0;        // Area of the damaged region
+    int64_t paintedPixels = 0; // Painted area (includes the non-damaged area of merged rects)
+  };
+
+  int frames = 0;  // Number of painted frames
+  Frame lastFrame; // Stats of the last painted frame
+  Frame total;     // Sum of all painted frames
+
+  // Ratio of painted pixels that were really damaged (1.0 means that
+  // nothing was painted twice or without being invalidated).
+  double efficiency() const
+  {
+    return (total.paintedPixels > 0 ? double(total.pixels) / total.paintedPixels : 1.0);
+  }
+};
+
+} // namespace os
+
+#endif
@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2024  Igara Studio S.A.
+// Copyright (C) 2024-2025  Igara Studio S.A.
 //
 // This file is released under the terms of the MIT license.
 // Read LICENSE.txt for more information.
@@ -9,6 +9,7 @@
 #endif
 
 #include "os/event.h"
+#include "os/event_queue.h"
 
 #include "base/string.h"
 
@@ -19,4 +20,12 @@ std::string Event::unicodeCharAsUtf8() const
   return base::codepoint_to_utf8(m_unicodeChar);
 }
 
+void queue_callback(std::function<void()>&& func)
+{
+  Event ev;
+  ev.setType(Event::Callback);
+  ev.setCallback(std::move(func));
+  queue_event(ev);
+}
+
 } // namespace os
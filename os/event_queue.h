@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2021  Igara Studio S.A.
+// Copyright (C) 2021-2025  Igara Studio S.A.
 // Copyright (C) 2012-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -9,6 +9,8 @@
 #define OS_EVENT_QUEUE_H_INCLUDED
 #pragma once
 
+#include <functional>
+
 namespace os {
 
 class Event;
@@ -53,6 +55,11 @@ inline void queue_event(const Event& ev)
   EventQueue::instance()->queueEvent(ev);
 }
 
+// Queues an Event::Callback event to execute the given function
+// when the event is processed (generally in the main thread). It can
+// be used as the dispatcher of a base::fs_watcher.
+void queue_callback(std::function<void()>&& func);
+
 } // namespace os
 
 #endif
@@ -11,7 +11,8 @@
 
 #include "os/skia/skia_surface.h"
 
-#include "base/file_handle.h"
+#include "base/file_view.h"
+#include "base/trace.h"
 #include "gfx/path.h"
 #include "gfx/region.h"
 #include "os/skia/skia_helpers.h"
@@ -571,6 +572,8 @@ void SkiaSurface::scrollTo(const gfx::Rect& rc, int dx, int dy)
 
 void SkiaSurface::drawSurface(const Surface* src, int dstx, int dsty)
 {
+  TRACE_SCOPE("os", "drawSurface");
+
   gfx::Clip clip(dstx, dsty, 0, 0, src->width(), src->height());
   // Don't call clip.clip() and left the clipping to the Skia library
   // (mainly because Skia knows how to handle clipping even when a
@@ -587,6 +590,8 @@ void SkiaSurface::drawSurface(const Surface* src,
                               const Sampling& sampling,
                               const os::Paint* paint)
 {
+  TRACE_SCOPE("os", "drawSurface");
+
   SkPaint skSrcPaint;
   skSrcPaint.setBlendMode(SkBlendMode::kSrc);
 
@@ -749,12 +754,14 @@ void SkiaSurface::swapBitmap(SkBitmap& other)
 // static
 Ref<Surface> SkiaSurface::loadSurface(const char* filename)
 {
-  FILE* f = base::open_file_raw(filename, "rb");
-  if (!f)
+  // The file is mapped in memory and decoded directly from there
+  // (the view must be alive until the codec is destroyed).
+  const base::file_view view(filename);
+  if (!view.is_open() || view.empty())
     return nullptr;
 
-  std::unique_ptr<SkCodec> codec(
-    SkCodec::MakeFromStream(std::unique_ptr<SkFILEStream>(new SkFILEStream(f))));
+  std::unique_ptr<SkCodec> codec(SkCodec::MakeFromStream(
+    std::make_unique<SkMemoryStream>(view.data(), view.size(), false)));
   if (!codec)
     return nullptr;
 
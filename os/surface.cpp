@@ -0,0 +1,45 @@
+// LAF OS Library
+// Copyright (c) 2025  Igara Studio S.A.
+//
+// This file is released under the terms of the MIT license.
+// Read LICENSE.txt for more information.
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "os/surface.h"
+
+#include "base/hash.h"
+
+namespace os {
+
+uint64_t Surface::hashPixels(const uint64_t seed)
+{
+  SurfaceFormatData format;
+  getFormat(&format);
+
+  const int w = width();
+  const int h = height();
+
+  // Size and pixel format in little-endian so the hash doesn't
+  // depend on the CPU endianness.
+  uint8_t header[12];
+  const uint32_t values[3] = { uint32_t(w), uint32_t(h), format.bitsPerPixel };
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 4; ++j)
+      header[4 * i + j] = uint8_t(values[i] >> (8 * j));
+
+  base::hasher64 hasher(seed);
+  hasher.update(header, sizeof(header));
+
+  const size_t rowBytes = size_t(w) * format.bitsPerPixel / 8;
+  if (rowBytes > 0) {
+    const SurfaceLock lock(this);
+    for (int y = 0; y < h; ++y)
+      hasher.update(getData(0, y), rowBytes);
+  }
+  return hasher.digest();
+}
+
+} // namespace os
@@ -76,6 +76,12 @@ public:
   virtual uint8_t* getData(int x, int y) const = 0;
   virtual void getFormat(SurfaceFormatData* formatData) const = 0;
 
+  // Returns a fast hash (base::hash64) of the size and the pixels of
+  // the surface (row by row, without row padding). It can be used as
+  // a key of a cache of surfaces. Surfaces with the same pixels in a
+  // different native format give different hashes.
+  uint64_t hashPixels(uint64_t seed = 0);
+
   virtual gfx::Color getPixel(int x, int y) const = 0;
   virtual void putPixel(gfx::Color color, int x, int y) = 0;
 
@@ -12,6 +12,7 @@
 #include "gfx/point.h"
 #include "os/color_space.h"
 #include "os/cursor.h"
+#include "os/damage_stats.h"
 #include "os/dnd.h"
 #include "os/native_cursor.h"
 #include "os/ref.h"
@@ -118,6 +119,11 @@ public:
   virtual void invalidateRegion(const gfx::Region& rgn) = 0;
   void invalidate();
 
+  // Returns statistics about the invalidated/painted areas (only on
+  // platforms that accumulate the invalidated regions to paint them
+  // once per frame, e.g. X11).
+  virtual DamageStats damageStats() const { return DamageStats(); }
+
   // GPU-related functions
   virtual bool gpuAcceleration() const = 0;
   virtual void setGpuAcceleration(bool state) {}
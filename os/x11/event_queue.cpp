@@ -1,5 +1,5 @@
 // LAF OS Library
-// Copyright (C) 2019-2022  Igara Studio S.A.
+// Copyright (C) 2019-2025  Igara Studio S.A.
 // Copyright (C) 2016-2018  David Capello
 //
 // This file is released under the terms of the MIT license.
@@ -12,6 +12,7 @@
 #include "os/x11/event_queue.h"
 
 #include "base/thread.h"
+#include "base/trace.h"
 #include "os/x11/window.h"
 
 #include <X11/Xlib.h>
@@ -91,10 +92,15 @@ void EventQueueX11::queueEvent(const Event& ev)
 
 void EventQueueX11::getEvent(Event& ev, double timeout)
 {
+  TRACE_SCOPE("os", "getEvent");
   base::tick_t startTime = base::current_tick();
 
   ev.setWindow(nullptr);
 
+  // Paint the regions invalidated in the last frame before waiting
+  // for new events.
+  WindowX11::flushDamageOfAllWindows();
+
   ::Display* display = X11::instance()->display();
   XSync(display, False);
 
@@ -162,6 +168,10 @@ void EventQueueX11::getEvent(Event& ev, double timeout)
     }
   }
 
+  // Paint exposed areas
+  if (events > 0)
+    WindowX11::flushDamageOfAllWindows();
+
   if (!m_events.try_pop(ev))
     ev.setType(Event::None);
 }
@@ -234,6 +234,13 @@ size_t WindowX11::countActiveWindows()
   return g_activeWindows.size();
 }
 
+// static
+void WindowX11::flushDamageOfAllWindows()
+{
+  for (auto& it : g_activeWindows)
+    it.second->flushDamage();
+}
+
 // static
 void WindowX11::addWindow(WindowX11* window)
 {
@@ -819,11 +826,21 @@ void WindowX11::setMousePosition(const gfx::Point& position)
   XWarpPointer(m_display, m_window, m_window, 0, 0, w, h, position.x * m_scale, position.y * m_scale);
 }
 
+// The region is painted in the next flushDamage() call (from
+// EventQueueX11::getEvent()), so all regions invalidated in the same
+// frame are uploaded to the X server together.
 void WindowX11::invalidateRegion(const gfx::Region& rgn)
 {
-  const gfx::Rect bounds = rgn.bounds();
-  onPaint(
-    gfx::Rect(bounds.x * m_scale, bounds.y * m_scale, bounds.w * m_scale, bounds.h * m_scale));
+  m_damage.add(rgn);
+}
+
+void WindowX11::flushDamage()
+{
+  if (!m_damage.flush(m_damageRects))
+    return;
+
+  for (const gfx::Rect& rc : m_damageRects)
+    onPaint(gfx::Rect(rc.x * m_scale, rc.y * m_scale, rc.w * m_scale, rc.h * m_scale));
 }
 
 bool WindowX11::setCursor(NativeCursor nativeCursor)
@@ -1132,11 +1149,15 @@ void WindowX11::processX11Event(XEvent& event)
     }
 
     case Expose: {
-      const gfx::Rect rc(event.xexpose.x,
-                         event.xexpose.y,
-                         event.xexpose.width,
-                         event.xexpose.height);
-      onPaint(rc);
+      // Convert to non-scaled coordinates (rounding outwards) to
+      // accumulate the exposed area with the invalidated regions
+      const int x2 = event.xexpose.x + event.xexpose.width;
+      const int y2 = event.xexpose.y + event.xexpose.height;
+      const gfx::Rect rc(event.xexpose.x / m_scale,
+                         event.xexpose.y / m_scale,
+                         (x2 + m_scale - 1) / m_scale - event.xexpose.x / m_scale,
+                         (y2 + m_scale - 1) / m_scale - event.xexpose.y / m_scale);
+      m_damage.add(rc);
       break;
     }
 
@@ -16,6 +16,7 @@
 #include "gfx/point.h"
 #include "gfx/size.h"
 #include "os/color_space.h"
+#include "os/common/damage_accumulator.h"
 #include "os/event.h"
 #include "os/native_cursor.h"
 #include "os/screen.h"
@@ -28,6 +29,7 @@
 
 #include <cstring>
 #include <string>
+#include <vector>
 
 namespace os {
 
@@ -72,6 +74,7 @@ public:
   void releaseMouse() override;
   void setMousePosition(const gfx::Point& position) override;
   void invalidateRegion(const gfx::Region& rgn) override;
+  DamageStats damageStats() const override { return m_damage.stats(); }
   bool setCursor(NativeCursor cursor) override;
   bool setCursor(const CursorRef& cursor) override;
 
@@ -90,6 +93,10 @@ public:
   void processX11Event(XEvent& event);
   static WindowX11* getPointerFromHandle(::Window handle);
 
+  // Paints the regions invalidated since the last call (one frame).
+  void flushDamage();
+  static void flushDamageOfAllWindows();
+
   // Only used for debugging purposes.
   static size_t countActiveWindows();
 
@@ -118,6 +125,8 @@ private:
   gfx::Point m_lastMousePos;
   gfx::Rect m_lastConfigure;
   gfx::Border m_frameExtents;
+  DamageAccumulator m_damage;
+  std::vector<gfx::Rect> m_damageRects;
   bool m_initializingActions = true;
   bool m_fullscreen = false;
   bool m_borderless = false;